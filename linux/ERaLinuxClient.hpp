@@ -5,9 +5,16 @@
     #define ERA_PROTO_TYPE            "Socket"
 #endif
 
+/* Upper bound for wait(), pin and property reports are
+   polled from run() so they fire within this delay */
+#if !defined(ERA_LINUX_WAIT_MS)
+    #define ERA_LINUX_WAIT_MS         100
+#endif
+
 #include <ERa/ERaProtocol.hpp>
 #include <MQTT/ERaMqttLinux.hpp>
 #include <Utility/ERaFlashLinux.hpp>
+#include <Utility/ERaReactorLinux.hpp>
 
 template <class Transport>
 class ERaLinux
@@ -19,6 +26,8 @@ class ERaLinux
 public:
     ERaLinux(Transport& _transp, ERaFlashLinux& _flash)
         : Base(_transp, _flash)
+        , reactor()
+        , socketFd(-1)
     {}
     ~ERaLinux()
     {}
@@ -48,8 +57,36 @@ public:
                     ERA_MQTT_USERNAME, ERA_MQTT_PASSWORD);
     }
 
+    /* Block until the broker sends data, wakeup() is called
+       or timeout expires (pass the delay from ERaTimer::run()) */
+    void wait(MillisTime_t timeout = ERA_LINUX_WAIT_MS) {
+        int fd = this->getTransp().getSocket();
+        if (fd != this->socketFd) {
+            this->reactor.remove(this->socketFd);
+            this->socketFd = fd;
+        }
+        /* A reconnect may reuse the closed descriptor number */
+        if ((fd >= 0) && !this->reactor.modify(fd, EPOLLIN)) {
+            this->reactor.add(fd, EPOLLIN);
+        }
+        MillisTime_t idle = this->getTransp().getIdleTimeout();
+        if (idle < timeout) {
+            timeout = idle;
+        }
+        if (timeout > ERA_LINUX_WAIT_MS) {
+            timeout = ERA_LINUX_WAIT_MS;
+        }
+        this->reactor.wait(timeout);
+    }
+
+    void wakeup() {
+        this->reactor.wakeup();
+    }
+
 protected:
 private:
+    ERaReactorLinux reactor;
+    int socketFd;
 };
 
 template <class Proto, class Flash>
@@ -6,6 +6,7 @@
 #include <ERa/ERaDefine.hpp>
 #include <ERa/ERaConfig.hpp>
 #include <ERa/ERaApi.hpp>
+#include <Utility/ERaJournalLinux.hpp>
 #include "MQTT/MQTT.hpp"
 
 #if defined(__has_include) &&       \
@@ -31,6 +32,26 @@
         ERA_LOG(TAG, ERA_PSTR("Subscribe (error %d): %s, QoS: %d"), errorCode, topicName, qos); \
     }
 
+/* Reconnect delay doubles from min to max after each failed
+   attempt, a random half of it is skipped so gateways cut off
+   together do not reconnect in lockstep */
+#if !defined(ERA_MQTT_RECONNECT_MIN_MS)
+    #define ERA_MQTT_RECONNECT_MIN_MS   1000
+#endif
+
+#if !defined(ERA_MQTT_RECONNECT_MAX_MS)
+    #define ERA_MQTT_RECONNECT_MAX_MS   60000
+#endif
+
+#if !defined(ERA_MQTT_SUBACK_TIMEOUT)
+    #define ERA_MQTT_SUBACK_TIMEOUT     5000
+#endif
+
+/* How often run() is needed while a connect is in progress */
+#if !defined(ERA_MQTT_CONNECT_POLL_MS)
+    #define ERA_MQTT_CONNECT_POLL_MS    10
+#endif
+
 using namespace std;
 
 template <class MQTT>
@@ -42,6 +63,11 @@ class ERaMqttLinux
         QOS2 = 0x02,
         SUBFAIL = 0x80
     };
+    enum ConnectT {
+        CONNECT_WAIT = 0x00,
+        CONNECT_BROKER = 0x01,
+        CONNECT_SUBACK = 0x02
+    };
 #if defined(MQTT_HAS_FUNCTIONAL_H)
     typedef std::function<void(const char*, const char*)> MessageCallback_t;
 #else
@@ -70,9 +96,18 @@ public:
         , signalQuality(0)
         , askConfig(false)
         , _connected(false)
+        , journal()
+        , drainMillis(0)
+        , connectState(ConnectT::CONNECT_WAIT)
+        , connectMillis(0)
+        , backoff(0)
+        , attempts(0)
+        , seed(0)
+        , subscribed(false)
         , mutex(NULL)
     {
         memset(this->willTopic, 0, sizeof(this->willTopic));
+        memset(this->connectID, 0, sizeof(this->connectID));
     }
     ~ERaMqttLinux()
     {}
@@ -102,6 +137,11 @@ public:
         this->mqtt.setTimeout(timeout);
     }
 
+    /* QoS 1 publishes kept unacknowledged at once, 0 waits for each PUBACK */
+    void setPublishWindow(size_t window) {
+        this->mqtt.setPublishWindow(window);
+    }
+
     void setClientID(const char* id) {
         this->clientID = id;
     }
@@ -158,11 +198,44 @@ public:
         this->mqtt.onMessage(cb);
     }
 
+    int getSocket() {
+        return this->mqtt.getSocket();
+    }
+
+    /* Longest run() can be left idle before a ping, the next
+       journal batch or the next reconnect step is due */
+    MillisTime_t getIdleTimeout() {
+        if (!this->_connected) {
+            if (this->connectState != ConnectT::CONNECT_WAIT) {
+                return ERA_MQTT_CONNECT_POLL_MS;
+            }
+            return ERaRemainingTime(this->connectMillis, this->backoff);
+        }
+        MillisTime_t timeout = (MillisTime_t)this->mqtt.keepAliveRemaining();
+#if !defined(ERA_NO_MQTT_JOURNAL)
+        if (!this->journal.isEmpty()) {
+            MillisTime_t remain = ERaRemainingTime(this->drainMillis, ERA_JOURNAL_DRAIN_INTERVAL);
+            if (remain < timeout) {
+                timeout = remain;
+            }
+        }
+#endif
+        return timeout;
+    }
+
 protected:
 private:
-    bool subscribeTopic(const char* baseTopic, const char* topic,
-                        QoST qos = (QoST)ERA_MQTT_SUBSCRIBE_QOS);
     bool publishLWT(bool sync = false);
+    void storeData(const char* topic, const char* payload, bool retained);
+    void drainJournal();
+    bool publishRecord(const ERaJournalRecord_t& record);
+    bool runConnect();
+    bool startConnect();
+    bool subscribeTopics();
+    void logSubscribes();
+    void formatSubscribe(size_t index, char(&topicName)[MAX_TOPIC_LENGTH]);
+    void scheduleConnect();
+    uint32_t randomJitter(uint32_t max);
 
     MQTT mqtt;
     const char* host;
@@ -177,6 +250,15 @@ private:
     int16_t signalQuality;
     bool askConfig;
     bool _connected;
+    ERaJournalLinux journal;
+    MillisTime_t drainMillis;
+    ConnectT connectState;
+    MillisTime_t connectMillis;
+    MillisTime_t backoff;
+    size_t attempts;
+    unsigned int seed;
+    bool subscribed;
+    char connectID[74];
     char willTopic[MAX_TOPIC_LENGTH];
     ERaMutex_t mutex;
 };
@@ -195,57 +277,237 @@ void ERaMqttLinux<MQTT>::config(const char* _host, uint16_t _port,
     this->mqtt.init(ERA_MQTT_RX_BUFFER_SIZE,
                     ERA_MQTT_TX_BUFFER_SIZE);
     this->mqtt.setKeepAlive(ERA_MQTT_KEEP_ALIVE);
+    this->mqtt.setCleanSession(ERA_MQTT_CLEAN_SESSION);
+    this->mqtt.setPublishWindow(ERA_MQTT_PUBLISH_WINDOW);
     this->mqtt.setWill(this->willTopic, OFFLINE_MESSAGE, LWT_RETAINED, LWT_QOS);
     this->mqtt.begin(this->host, this->port);
+#if defined(ERA_MQTT_TLS_SESSION_FILE)
+    this->mqtt.setTLSSessionFile(ERA_MQTT_TLS_SESSION_FILE);
+#endif
 }
 
+/* One attempt, driven to completion. Later attempts are
+   made by run() without blocking the caller, subscribe
+   there too and let ERaProto send /info when one succeeds */
 template <class MQTT>
 inline
 bool ERaMqttLinux<MQTT>::connect() {
-    size_t count {0};
-    char _clientID[74] {0};
     this->_connected = false;
-    if (this->clientID != nullptr && strlen(this->clientID)) {
-        FormatString(_clientID, this->ERaAuth);
-        if (!ERaStrCmp(this->clientID, this->ERaAuth)) {
-            FormatString(_clientID, "_%s", this->clientID);
-        }
-    }
     this->mqtt.disconnect();
-    while (this->mqtt.connect(_clientID, this->username, this->password) == false) {
-        ERA_LOG(TAG, ERA_PSTR("MQTT: connect failed (%d), retrying in 5 seconds"), this->mqtt.lastError());
-        ERaDelay(5000);
-        if (++count >= LIMIT_CONNECT_BROKER_MQTT) {
+    this->attempts = 0;
+    this->backoff = 0;
+    this->connectState = ConnectT::CONNECT_WAIT;
+    while (!this->runConnect()) {
+        if (this->connectState == ConnectT::CONNECT_WAIT) {
             return false;
         }
+        ERaDelay(ERA_MQTT_CONNECT_POLL_MS);
     }
+    return true;
+}
 
-#if defined(ERA_ZIGBEE)
-    subscribeTopic(this->ERaTopic, "/zigbee/+/down");
-    subscribeTopic(this->ERaTopic, "/zigbee/permit_to_join");
-    subscribeTopic(this->ERaTopic, "/zigbee/remove_device");
+/* Advances the connect one step, true once online */
+template <class MQTT>
+inline
+bool ERaMqttLinux<MQTT>::runConnect() {
+    switch (this->connectState) {
+        case ConnectT::CONNECT_WAIT:
+            if (ERaRemainingTime(this->connectMillis, this->backoff)) {
+                return false;
+            }
+            if (!this->startConnect()) {
+                ERA_LOG(TAG, ERA_PSTR("MQTT: connect failed (%d)"), this->mqtt.lastError());
+                this->scheduleConnect();
+                return false;
+            }
+            this->connectState = ConnectT::CONNECT_BROKER;
+            /* Fall through */
+        case ConnectT::CONNECT_BROKER:
+            if (!this->mqtt.connectPoll()) {
+                if (!this->mqtt.connecting()) {
+                    ERA_LOG(TAG, ERA_PSTR("MQTT: connect failed (%d)"), this->mqtt.lastError());
+                    this->scheduleConnect();
+                }
+                return false;
+            }
+#if defined(ERA_MQTT_SSL)
+            if (this->mqtt.fullHandshakes() || this->mqtt.resumedHandshakes()) {
+                ERA_LOG(TAG, ERA_PSTR("MQTT: TLS handshake %s in %dms"),
+                        (this->mqtt.handshakeResumed() ? "resumed" : "full"), (int)this->mqtt.handshakeTime());
+            }
 #endif
-
-    subscribeTopic(this->ERaTopic, "/arduino_pin/+");
-    subscribeTopic(this->ERaTopic, "/virtual_pin/+");
-    subscribeTopic(this->ERaTopic, "/pin/down");
-    subscribeTopic(this->ERaTopic, "/down");
+            /* The broker kept the session, subscriptions made
+               since this process started are still in place */
+            if (this->subscribed && this->mqtt.sessionPresent()) {
+                ERA_LOG(TAG, ERA_PSTR("MQTT: session resumed, subscriptions kept"));
+                break;
+            }
+            if (!this->subscribeTopics()) {
+                this->scheduleConnect();
+                return false;
+            }
+            this->connectMillis = ERaMillis();
+            this->connectState = ConnectT::CONNECT_SUBACK;
+            /* Fall through */
+        case ConnectT::CONNECT_SUBACK:
+            if (!this->mqtt.loop()) {
+                this->scheduleConnect();
+                return false;
+            }
+            if (this->mqtt.pendingSubscribes() &&
+                ERaRemainingTime(this->connectMillis, ERA_MQTT_SUBACK_TIMEOUT)) {
+                return false;
+            }
+            this->logSubscribes();
+            this->subscribed = (!this->mqtt.pendingSubscribes() &&
+                                !this->mqtt.failedSubscribes());
+            break;
+        default:
+            return false;
+    }
 
 #if defined(ERA_ASK_CONFIG_WHEN_RESTART)
     if (!this->publishLWT(true)) {
+        this->scheduleConnect();
         return false;
     }
 #else
     if (!this->publishLWT(this->getAskConfig())) {
+        this->scheduleConnect();
         return false;
     }
 #endif
 
+    this->attempts = 0;
+    this->connectState = ConnectT::CONNECT_WAIT;
     this->_connected = true;
     ERaOnConnected();
     return true;
 }
 
+template <class MQTT>
+inline
+bool ERaMqttLinux<MQTT>::startConnect() {
+    ClearArray(this->connectID);
+    if (this->clientID != nullptr && strlen(this->clientID)) {
+        FormatString(this->connectID, this->ERaAuth);
+        if (!ERaStrCmp(this->clientID, this->ERaAuth)) {
+            FormatString(this->connectID, "_%s", this->clientID);
+        }
+    }
+    this->mqtt.disconnect();
+    return this->mqtt.connectStart(this->connectID, this->username, this->password);
+}
+
+static const char* const ERA_MQTT_SUBSCRIBE_TOPICS[] = {
+#if defined(ERA_ZIGBEE)
+    "/zigbee/+/down",
+    "/zigbee/permit_to_join",
+    "/zigbee/remove_device",
+#endif
+    "/arduino_pin/+",
+    "/virtual_pin/+",
+    "/pin/down",
+    "/down"
+};
+
+/* All filters go out in as few SUBSCRIBE packets as fit,
+   SUBACKs are collected by loop() in CONNECT_SUBACK */
+template <class MQTT>
+inline
+bool ERaMqttLinux<MQTT>::subscribeTopics() {
+    const size_t count = ERA_COUNT_OF(ERA_MQTT_SUBSCRIBE_TOPICS);
+    char topicNames[count][MAX_TOPIC_LENGTH];
+    const char* filters[count] {nullptr};
+    int qosList[count] {0};
+
+    for (size_t i = 0; i < count; ++i) {
+        this->formatSubscribe(i, topicNames[i]);
+        filters[i] = topicNames[i];
+        qosList[i] = ERA_MQTT_SUBSCRIBE_QOS;
+    }
+
+    bool status {false};
+
+    ERaGuardLock(this->mutex);
+    if (this->connected()) {
+        status = this->mqtt.subscribeAsync(count, filters, qosList);
+    }
+    ERaGuardUnlock(this->mutex);
+
+    if (!status) {
+        ERA_LOG(TAG, ERA_PSTR("Subscribe (error %d)"), this->mqtt.lastError());
+    }
+    return status;
+}
+
+/* One line per filter from the SUBACK return codes */
+template <class MQTT>
+inline
+void ERaMqttLinux<MQTT>::logSubscribes() {
+    char topicName[MAX_TOPIC_LENGTH] {0};
+    for (size_t i = 0; i < ERA_COUNT_OF(ERA_MQTT_SUBSCRIBE_TOPICS); ++i) {
+        this->formatSubscribe(i, topicName);
+        int qos = this->mqtt.grantedQos(i);
+        if (qos < 0) {
+            ERA_LOG(TAG, ERA_PSTR("Subscribe (no ack): %s"), topicName);
+        }
+        else if (qos == QoST::SUBFAIL) {
+            ERA_LOG(TAG, ERA_PSTR("Subscribe (refused): %s"), topicName);
+        }
+        else {
+            ERA_LOG(TAG, ERA_PSTR("Subscribe (ok): %s, QoS: %d"), topicName, qos);
+        }
+    }
+}
+
+template <class MQTT>
+inline
+void ERaMqttLinux<MQTT>::formatSubscribe(size_t index, char(&topicName)[MAX_TOPIC_LENGTH]) {
+    ClearArray(topicName);
+    FormatString(topicName, this->ERaTopic);
+    FormatString(topicName, ERA_MQTT_SUBSCRIBE_TOPICS[index]);
+}
+
+template <class MQTT>
+inline
+void ERaMqttLinux<MQTT>::scheduleConnect() {
+    MillisTime_t cap = ERA_MQTT_RECONNECT_MAX_MS;
+    if (this->attempts < 16) {
+        cap = ((MillisTime_t)ERA_MQTT_RECONNECT_MIN_MS << this->attempts);
+        if (cap > ERA_MQTT_RECONNECT_MAX_MS) {
+            cap = ERA_MQTT_RECONNECT_MAX_MS;
+        }
+    }
+    this->attempts++;
+    this->backoff = ((cap / 2) + this->randomJitter((uint32_t)(cap / 2) + 1));
+    this->connectMillis = ERaMillis();
+    this->connectState = ConnectT::CONNECT_WAIT;
+    ERA_LOG(TAG, ERA_PSTR("MQTT: retrying in %d ms"), (int)this->backoff);
+}
+
+/* ERaRandomNumber() reseeds from time(), gateways cut off
+   in the same second would all draw the same delay */
+template <class MQTT>
+inline
+uint32_t ERaMqttLinux<MQTT>::randomJitter(uint32_t max) {
+    if (!this->seed) {
+        FILE* file = fopen("/dev/urandom", "rb");
+        if ((file == nullptr) ||
+            (fread(&this->seed, sizeof(this->seed), 1, file) != 1)) {
+            this->seed = (unsigned int)(time(nullptr) ^ getpid() ^ ERaMillis());
+        }
+        if (file != nullptr) {
+            fclose(file);
+        }
+        this->seed |= 1;
+    }
+    if (!max) {
+        return 0;
+    }
+    return ((uint32_t)rand_r(&this->seed) % max);
+}
+
 template <class MQTT>
 inline
 void ERaMqttLinux<MQTT>::disconnect() {
@@ -261,49 +523,131 @@ bool ERaMqttLinux<MQTT>::connected() {
 template <class MQTT>
 inline
 bool ERaMqttLinux<MQTT>::run() {
+    if (!this->_connected) {
+        return this->runConnect();
+    }
     if (!this->mqtt.loop()) {
+        this->_connected = false;
         ERaOnDisconnected();
-        return this->connect();
+        this->scheduleConnect();
+        return false;
     }
+    this->drainJournal();
     return true;
 }
 
 template <class MQTT>
 inline
-bool ERaMqttLinux<MQTT>::subscribeTopic(const char* baseTopic, const char* topic,
-                                        QoST qos) {
+bool ERaMqttLinux<MQTT>::publishData(const char* topic, const char* payload,
+                                    bool retained, QoST qos) {
+    if (!this->_connected) {
+        this->storeData(topic, payload, retained);
+        return false;
+    }
+
     bool status {false};
-    char topicName[MAX_TOPIC_LENGTH] {0};
-	FormatString(topicName, baseTopic);
-	FormatString(topicName, topic);
 
     ERaGuardLock(this->mutex);
     if (this->connected()) {
-        status = this->mqtt.subscribe(topicName, qos);
-        ERR_MQTT_SUB_LOG(status, this->mqtt.lastError())
+        status = this->mqtt.publish(topic, payload, retained, qos);
+        ERA_MQTT_PUB_LOG(status, this->mqtt.lastError())
+    }
+#if !defined(ERA_NO_MQTT_JOURNAL)
+    /* Live data is never held back by the replay */
+    if (status && retained) {
+        this->journal.supersede(topic);
     }
+#endif
     ERaGuardUnlock(this->mutex);
 
+    if (!status) {
+        this->storeData(topic, payload, retained);
+    }
     return status;
 }
 
+/* Keep data produced while the broker is unreachable,
+   it is replayed by run() once connected again */
 template <class MQTT>
 inline
-bool ERaMqttLinux<MQTT>::publishData(const char* topic, const char* payload,
-                                    bool retained, QoST qos) {
-    if (!this->_connected) {
-        return false;
+void ERaMqttLinux<MQTT>::storeData(const char* topic, const char* payload, bool retained) {
+#if !defined(ERA_NO_MQTT_JOURNAL)
+    ERaGuardLock(this->mutex);
+    if (!this->journal.append(topic, payload, retained)) {
+        ERA_LOG(TAG, ERA_PSTR("Journal (error) %s: %s"), topic, payload);
     }
+    ERaGuardUnlock(this->mutex);
+#else
+    ERA_FORCE_UNUSED(topic);
+    ERA_FORCE_UNUSED(payload);
+    ERA_FORCE_UNUSED(retained);
+#endif
+}
 
-    bool status {false};
+/* One rate limited batch of journal records per call */
+template <class MQTT>
+inline
+void ERaMqttLinux<MQTT>::drainJournal() {
+#if !defined(ERA_NO_MQTT_JOURNAL)
+    if (!this->_connected ||
+        this->journal.isEmpty()) {
+        return;
+    }
+    if (ERaRemainingTime(this->drainMillis, ERA_JOURNAL_DRAIN_INTERVAL)) {
+        return;
+    }
+    this->drainMillis = ERaMillis();
 
     ERaGuardLock(this->mutex);
-    if (this->connected()) {
-        status = this->mqtt.publish(topic, payload, retained, qos);
-        ERA_MQTT_PUB_LOG(status, this->mqtt.lastError())
+    for (size_t i = 0; (i < ERA_JOURNAL_DRAIN_BATCH) && this->connected(); ++i) {
+        const ERaJournalRecord_t* record = this->journal.front();
+        if (record == nullptr) {
+            break;
+        }
+        if (ERA_JOURNAL_MAX_AGE &&
+            ((uint32_t)time(nullptr) - record->timestamp > (uint32_t)ERA_JOURNAL_MAX_AGE)) {
+            this->journal.pop();
+            continue;
+        }
+        /* A newer value is already retained by the broker */
+        if (this->journal.isSuperseded()) {
+            this->journal.pop();
+            continue;
+        }
+        if (!this->publishRecord(*record)) {
+            ERA_LOG(TAG, ERA_PSTR("Journal (error %d) %s"), this->mqtt.lastError(), record->topic);
+            break;
+        }
+        this->journal.pop();
     }
     ERaGuardUnlock(this->mutex);
+#endif
+}
+
+/* A JSON object payload gets the time it was journaled as
+   "ts" (epoch seconds), so outage data keeps its own time */
+template <class MQTT>
+inline
+bool ERaMqttLinux<MQTT>::publishRecord(const ERaJournalRecord_t& record) {
+    const char* payload = record.payload;
+    if ((payload[0] != '{') ||
+        (strstr(payload, "\"ts\":") != nullptr)) {
+        return this->mqtt.publish(record.topic, payload, record.retained, ERA_MQTT_PUBLISH_QOS);
+    }
 
+    const char* rest = payload + 1;
+    while (isspace((unsigned char)*rest)) {
+        rest++;
+    }
+    size_t length = strlen(rest) + 24;
+    char* data = (char*)ERA_MALLOC(length);
+    if (data == nullptr) {
+        return false;
+    }
+    snprintf(data, length, "{\"ts\":%lu%s%s", (unsigned long)record.timestamp,
+            ((*rest == '}') ? "" : ","), rest);
+    bool status = this->mqtt.publish(record.topic, data, record.retained, ERA_MQTT_PUBLISH_QOS);
+    ERA_FREE(data);
     return status;
 }
 
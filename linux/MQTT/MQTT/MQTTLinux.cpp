@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include "MQTTLinux.hpp"
 #include <ERa/ERaDefine.hpp>
+#include <Utility/ERaUtility.hpp>
 
 inline char* lwmqtt_strdup(const char* str) {
   if (str == nullptr) {
@@ -91,6 +92,11 @@ MQTTLinuxClient::~MQTTLinuxClient() {
     free((void *)this->hostname);
   }
 
+  // free unacknowledged messages
+  for (size_t i = 0; i < this->numInflight; ++i) {
+    free(this->inflight[i].topic);
+  }
+
   // free buffers
   free(this->readBuf);
   free(this->writeBuf);
@@ -133,6 +139,12 @@ void MQTTLinuxClient::begin() {
 
   // set callback
   lwmqtt_set_callback(&this->client, (void *)&this->callback, MQTTLinuxClientHandler);
+
+  // set ack callback
+  lwmqtt_set_ack_callback(&this->client, (void *)this, MQTTLinuxClient::acknowledgeHandler);
+
+  // set suback callback
+  lwmqtt_set_suback_callback(&this->client, (void *)this, MQTTLinuxClient::subscribedHandler);
 }
 
 void MQTTLinuxClient::init(int readBufSize, int writeBufSize) {
@@ -197,6 +209,52 @@ void MQTTLinuxClient::setTLS(bool _isTLS) {
 #endif
 }
 
+void MQTTLinuxClient::setTLSSessionFile(const char file[]) {
+#if defined(ERA_MQTT_SSL)
+  lwmqtt_unix_tls_network_set_session_file(&this->networkTLS, file);
+#else
+  (void)file;
+#endif
+}
+
+void MQTTLinuxClient::clearTLSSession() {
+#if defined(ERA_MQTT_SSL)
+  lwmqtt_unix_tls_network_clear_session(&this->networkTLS);
+#endif
+}
+
+uint32_t MQTTLinuxClient::handshakeTime() {
+#if defined(ERA_MQTT_SSL)
+  return this->networkTLS.handshake_ms;
+#else
+  return 0;
+#endif
+}
+
+bool MQTTLinuxClient::handshakeResumed() {
+#if defined(ERA_MQTT_SSL)
+  return this->networkTLS.resumed;
+#else
+  return false;
+#endif
+}
+
+uint32_t MQTTLinuxClient::fullHandshakes() {
+#if defined(ERA_MQTT_SSL)
+  return this->networkTLS.full_handshakes;
+#else
+  return 0;
+#endif
+}
+
+uint32_t MQTTLinuxClient::resumedHandshakes() {
+#if defined(ERA_MQTT_SSL)
+  return this->networkTLS.resumed_handshakes;
+#else
+  return 0;
+#endif
+}
+
 void MQTTLinuxClient::setTLSWithPort(int _port) {
 #if defined(ERA_MQTT_SSL)
   if (_port == ERA_MQTT_PORT_SSL) {
@@ -283,6 +341,14 @@ void MQTTLinuxClient::dropOverflow(bool enabled) {
   lwmqtt_drop_overflow(&this->client, enabled, &this->_droppedMessages);
 }
 
+void MQTTLinuxClient::setPublishWindow(size_t window) {
+  // limit window to the in-flight table
+  if (window > MQTT_MAX_INFLIGHT) {
+    window = MQTT_MAX_INFLIGHT;
+  }
+  this->publishWindow = window;
+}
+
 bool MQTTLinuxClient::connect(const char clientID[], const char username[], const char password[], bool skip) {
   // close left open connection if still connected
   if (!skip && this->connected()) {
@@ -331,17 +397,7 @@ bool MQTTLinuxClient::connect(const char clientID[], const char username[], cons
 
   // prepare options
   lwmqtt_connect_options_t options = lwmqtt_default_connect_options;
-  options.keep_alive = this->keepAlive;
-  options.clean_session = this->cleanSession;
-  options.client_id = lwmqtt_string(clientID);
-
-  // set username and password if available
-  if (username != nullptr) {
-    options.username = lwmqtt_string(username);
-  }
-  if (password != nullptr) {
-    options.password = lwmqtt_string(password);
-  }
+  this->prepareOptions(options, clientID, username, password);
 
   // connect to broker
   this->_lastError = lwmqtt_connect(&this->client, &options, this->will, this->timeout);
@@ -363,9 +419,138 @@ bool MQTTLinuxClient::connect(const char clientID[], const char username[], cons
   // set flag
   this->_connected = true;
 
+  // resend messages the previous connection did not get acknowledged
+  return this->retransmitInflight(true);
+}
+
+bool MQTTLinuxClient::connectStart(const char clientID[], const char username[], const char password[]) {
+  // close left open connection if still connected
+  if (this->connected()) {
+    this->close();
+  }
+  this->connectPhase = MQTT_CONNECT_IDLE;
+
+  // forget subscriptions of the previous connection
+  this->numPendingSubscribes = 0;
+  this->numSubscribeFilters = 0;
+  this->_failedSubscribes = 0;
+
+  // start connecting to host
+  if (this->hostname != nullptr) {
+#if defined(ERA_MQTT_SSL)
+    if (this->isTLS) {
+      this->_lastError = lwmqtt_unix_tls_network_connect_start(&this->networkTLS, (char*)this->hostname, (uint16_t)this->port);
+    }
+    else {
+      this->_lastError = lwmqtt_unix_network_connect_start(&this->network, (char*)this->hostname, (uint16_t)this->port);
+    }
+#else
+    this->_lastError = lwmqtt_unix_network_connect_start(&this->network, (char*)this->hostname, (uint16_t)this->port);
+#endif
+  } else {
+    this->_lastError = LWMQTT_NETWORK_FAILED_CONNECT;
+  }
+  if (this->_lastError != LWMQTT_SUCCESS) {
+    return this->connectAbort();
+  }
+
+  // keep credentials for the connect packet
+  this->connectClientID = clientID;
+  this->connectUsername = username;
+  this->connectPassword = password;
+  this->connectMillis = ERaMillis();
+  this->connectPhase = MQTT_CONNECT_NETWORK;
+
   return true;
 }
 
+bool MQTTLinuxClient::connectPoll() {
+  if (this->connectPhase == MQTT_CONNECT_NETWORK) {
+    // advance socket connect and handshake
+    bool isConnected = false;
+#if defined(ERA_MQTT_SSL)
+    if (this->isTLS) {
+      this->_lastError = lwmqtt_unix_tls_network_connect_poll(&this->networkTLS, (char*)this->hostname, (uint16_t)this->port,
+                                                              &isConnected);
+    }
+    else {
+      this->_lastError = lwmqtt_unix_network_connect_poll(&this->network, &isConnected);
+    }
+#else
+    this->_lastError = lwmqtt_unix_network_connect_poll(&this->network, &isConnected);
+#endif
+    if ((this->_lastError == LWMQTT_SUCCESS) && !isConnected &&
+        ((uint32_t)(ERaMillis() - this->connectMillis) >= MQTT_CONNECT_TIMEOUT)) {
+      this->_lastError = LWMQTT_NETWORK_TIMEOUT;
+    }
+    if (this->_lastError != LWMQTT_SUCCESS) {
+      return this->connectAbort();
+    }
+    if (!isConnected) {
+      return false;
+    }
+
+    // send connect packet, the connack is read once it arrives
+    lwmqtt_connect_options_t options = lwmqtt_default_connect_options;
+    this->prepareOptions(options, this->connectClientID, this->connectUsername, this->connectPassword);
+    this->_lastError = lwmqtt_connect_start(&this->client, &options, this->will, this->timeout);
+    if (this->_lastError != LWMQTT_SUCCESS) {
+      return this->connectAbort();
+    }
+    this->connectMillis = ERaMillis();
+    this->connectPhase = MQTT_CONNECT_CONNACK;
+  }
+
+  if (this->connectPhase != MQTT_CONNECT_CONNACK) {
+    return false;
+  }
+
+  // check for the connack without blocking
+  bool isAvailable = false;
+#if defined(ERA_MQTT_SSL)
+  if (this->isTLS) {
+    this->_lastError = lwmqtt_unix_tls_network_select(&this->networkTLS, &isAvailable, 0);
+  }
+  else {
+    this->_lastError = lwmqtt_unix_network_select(&this->network, &isAvailable, 0);
+  }
+#else
+  this->_lastError = lwmqtt_unix_network_select(&this->network, &isAvailable, 0);
+#endif
+  if ((this->_lastError == LWMQTT_SUCCESS) && !isAvailable &&
+      ((uint32_t)(ERaMillis() - this->connectMillis) >= this->timeout)) {
+    this->_lastError = LWMQTT_NETWORK_TIMEOUT;
+  }
+  if (this->_lastError != LWMQTT_SUCCESS) {
+    return this->connectAbort();
+  }
+  if (!isAvailable) {
+    return false;
+  }
+
+  // read connack
+  lwmqtt_connect_options_t options = lwmqtt_default_connect_options;
+  this->_lastError = lwmqtt_connect_finish(&this->client, &options);
+
+  // copy return code
+  this->_returnCode = options.return_code;
+
+  // handle error
+  if (this->_lastError != LWMQTT_SUCCESS) {
+    return this->connectAbort();
+  }
+
+  // copy session present flag
+  this->_sessionPresent = options.session_present;
+
+  // set flag
+  this->_connected = true;
+  this->connectPhase = MQTT_CONNECT_IDLE;
+
+  // resend messages the previous connection did not get acknowledged
+  return this->retransmitInflight(true);
+}
+
 bool MQTTLinuxClient::publish(const char topic[], const char payload[], int length, bool retained, int qos) {
   // return immediately if not connected
   if (!this->connected()) {
@@ -395,6 +580,37 @@ bool MQTTLinuxClient::publish(const char topic[], const char payload[], int leng
     return false;
   }
 
+  // track qos 1 messages instead of waiting for their ack
+  if ((this->publishWindow > 0) && (qos == LWMQTT_QOS1)) {
+    if (!this->waitInflight()) {
+      return false;
+    }
+
+    // copy topic and payload for retransmission
+    size_t topicLen = strlen(topic) + 1;
+    char *data = (char *)ERA_MALLOC(topicLen + (size_t)length);
+    if (data == nullptr) {
+      return false;
+    }
+    memcpy(data, topic, topicLen);
+    memcpy(data + topicLen, payload, (size_t)length);
+
+    MQTTLinuxClientInflight *entry = &this->inflight[this->numInflight];
+    entry->packetID = 0;
+    entry->topic = data;
+    entry->payload = data + topicLen;
+    entry->length = (size_t)length;
+    entry->retained = retained;
+    if (!this->sendInflight(entry)) {
+      free(data);
+      entry->topic = nullptr;
+      return false;
+    }
+    this->numInflight++;
+
+    return true;
+  }
+
   // prepare message
   lwmqtt_message_t message = lwmqtt_default_message;
   message.payload = (uint8_t *)payload;
@@ -470,6 +686,93 @@ bool MQTTLinuxClient::subscribe(const char topic[], int qos) {
   return true;
 }
 
+bool MQTTLinuxClient::subscribeAsync(const char topic[], int qos) {
+  // wait for the suback if it could not be tracked
+  if (this->numPendingSubscribes >= MQTT_MAX_PENDING_SUBSCRIBES) {
+    if (!this->subscribe(topic, qos)) {
+      return false;
+    }
+    if (this->numSubscribeFilters < MQTT_MAX_SUBSCRIBE_FILTERS) {
+      this->subscribeQos[this->numSubscribeFilters] = qos;
+    }
+    this->numSubscribeFilters++;
+    return true;
+  }
+
+  // return immediately if not connected
+  if (!this->connected()) {
+    return false;
+  }
+
+  // send subscription
+  uint16_t packetID = 0;
+  lwmqtt_string_t filter = lwmqtt_string(topic);
+  lwmqtt_qos_t _qos = (lwmqtt_qos_t)qos;
+  this->_lastError = lwmqtt_subscribe_start(&this->client, 1, &filter, &_qos, &packetID, this->timeout);
+  if (this->_lastError != LWMQTT_SUCCESS) {
+    // close connection
+    this->close();
+
+    return false;
+  }
+
+  this->trackSubscribe(packetID, 1);
+
+  return true;
+}
+
+bool MQTTLinuxClient::subscribeAsync(size_t count, const char *topics[], const int qos[]) {
+  lwmqtt_string_t filters[LWMQTT_MAX_SUBACK_CODES];
+  lwmqtt_qos_t _qos[LWMQTT_MAX_SUBACK_CODES];
+
+  size_t index = 0;
+  while (index < count) {
+    // fall back to single subscriptions if the packet could not be tracked
+    if (this->numPendingSubscribes >= MQTT_MAX_PENDING_SUBSCRIBES) {
+      if (!this->subscribeAsync(topics[index], qos[index])) {
+        return false;
+      }
+      index++;
+      continue;
+    }
+
+    // return immediately if not connected
+    if (!this->connected()) {
+      return false;
+    }
+
+    // fixed header, remaining length and packet id
+    size_t length = 7;
+    int num = 0;
+    while ((index + num < count) && (num < LWMQTT_MAX_SUBACK_CODES)) {
+      // topic length, topic and requested qos
+      size_t size = strlen(topics[index + num]) + 3;
+      if (num && (length + size > this->writeBufSize)) {
+        break;
+      }
+      filters[num] = lwmqtt_string(topics[index + num]);
+      _qos[num] = (lwmqtt_qos_t)qos[index + num];
+      length += size;
+      num++;
+    }
+
+    // send subscription
+    uint16_t packetID = 0;
+    this->_lastError = lwmqtt_subscribe_start(&this->client, num, filters, _qos, &packetID, this->timeout);
+    if (this->_lastError != LWMQTT_SUCCESS) {
+      // close connection
+      this->close();
+
+      return false;
+    }
+
+    this->trackSubscribe(packetID, num);
+    index += num;
+  }
+
+  return true;
+}
+
 bool MQTTLinuxClient::unsubscribe(const char topic[]) {
   // return immediately if not connected
   if (!this->connected()) {
@@ -513,7 +816,7 @@ bool MQTTLinuxClient::loop() {
     return false;
   }
 
-  // TODO Block until data is available
+  // check for data without blocking, callers wait on getSocket()
   bool isAvailable = false;
 #if defined(ERA_MQTT_SSL)
   if (this->isTLS) {
@@ -573,7 +876,8 @@ bool MQTTLinuxClient::loop() {
     return false;
   }
 
-  return true;
+  // resend messages whose ack is overdue
+  return this->retransmitInflight(false);
 }
 
 bool MQTTLinuxClient::connected() {
@@ -591,7 +895,44 @@ bool MQTTLinuxClient::connected() {
 #endif
 }
 
+int MQTTLinuxClient::getSocket() {
+  // descriptor to wait on for incoming packets
+#if defined(ERA_MQTT_SSL)
+  if (this->isTLS) {
+    return this->networkTLS.socket.fd;
+  }
+#endif
+  return this->network.socket;
+}
+
+uint32_t MQTTLinuxClient::keepAliveRemaining() {
+  // return immediately if not connected
+  if (!this->connected() || (this->keepAlive == 0)) {
+    return UINT32_MAX;
+  }
+
+  // time left before loop() has to send a ping
+  int32_t remaining = 0;
+#if defined(ERA_MQTT_SSL)
+  if (this->isTLS) {
+    remaining = lwmqtt_unix_tls_timer_get(&this->timer1TLS);
+  }
+  else {
+    remaining = lwmqtt_unix_timer_get(&this->timer1);
+  }
+#else
+  remaining = lwmqtt_unix_timer_get(&this->timer1);
+#endif
+
+  return ((remaining > 0) ? (uint32_t)remaining : 0);
+}
+
 bool MQTTLinuxClient::disconnect() {
+  // abort a connect in progress
+  if (this->connecting()) {
+    return this->connectAbort();
+  }
+
   // return immediately if not connected anymore
   if (!this->connected()) {
     return false;
@@ -622,3 +963,202 @@ void MQTTLinuxClient::close() {
   // set flag
   this->_connected = false;
 }
+
+void MQTTLinuxClient::prepareOptions(lwmqtt_connect_options_t &options, const char clientID[], const char username[],
+                                     const char password[]) {
+  options.keep_alive = this->keepAlive;
+  options.clean_session = this->cleanSession;
+  options.client_id = lwmqtt_string(clientID);
+
+  // set username and password if available
+  if (username != nullptr) {
+    options.username = lwmqtt_string(username);
+  }
+  if (password != nullptr) {
+    options.password = lwmqtt_string(password);
+  }
+}
+
+bool MQTTLinuxClient::connectAbort() {
+  this->connectPhase = MQTT_CONNECT_IDLE;
+  this->close();
+
+  // release the socket of the failed attempt
+#if defined(ERA_MQTT_SSL)
+  if (this->isTLS) {
+    lwmqtt_unix_tls_network_disconnect(&this->networkTLS);
+  }
+  else {
+    lwmqtt_unix_network_disconnect(&this->network);
+  }
+#else
+  lwmqtt_unix_network_disconnect(&this->network);
+#endif
+
+  return false;
+}
+
+bool MQTTLinuxClient::waitInflight() {
+  uint32_t startMillis = ERaMillis();
+
+  // process incoming acks until a slot is free
+  while (this->numInflight >= this->publishWindow) {
+    uint32_t elapsed = ERaMillis() - startMillis;
+    if (elapsed >= this->timeout) {
+      this->_lastError = LWMQTT_MISSING_OR_WRONG_PACKET;
+      return false;
+    }
+
+    // wait for data
+    bool isAvailable = false;
+#if defined(ERA_MQTT_SSL)
+    if (this->isTLS) {
+      this->_lastError = lwmqtt_unix_tls_network_select(&this->networkTLS, &isAvailable, this->timeout - elapsed);
+    }
+    else {
+      this->_lastError = lwmqtt_unix_network_select(&this->network, &isAvailable, this->timeout - elapsed);
+    }
+#else
+    this->_lastError = lwmqtt_unix_network_select(&this->network, &isAvailable, this->timeout - elapsed);
+#endif
+    if (this->_lastError != LWMQTT_SUCCESS) {
+      // close connection
+      this->close();
+
+      return false;
+    }
+
+    if (!this->loop()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool MQTTLinuxClient::sendInflight(MQTTLinuxClientInflight *entry) {
+  // prepare message
+  lwmqtt_message_t message = lwmqtt_default_message;
+  message.payload = (uint8_t *)entry->payload;
+  message.payload_len = entry->length;
+  message.retained = entry->retained;
+  message.qos = LWMQTT_QOS1;
+
+  // a new packet id is stored in the entry, a known one is sent as duplicate
+  lwmqtt_publish_options_t options = lwmqtt_default_publish_options;
+  options.dup_id = &entry->packetID;
+  options.skip_ack = true;
+
+  // publish message
+  this->_lastError = lwmqtt_publish(&this->client, &options, lwmqtt_string(entry->topic), message, this->timeout);
+  if (this->_lastError != LWMQTT_SUCCESS) {
+    // close connection
+    this->close();
+
+    return false;
+  }
+
+  entry->sentMillis = ERaMillis();
+
+  return true;
+}
+
+bool MQTTLinuxClient::retransmitInflight(bool all) {
+  uint32_t now = ERaMillis();
+
+  for (size_t i = 0; i < this->numInflight; ++i) {
+    MQTTLinuxClientInflight *entry = &this->inflight[i];
+    if (!all && ((uint32_t)(now - entry->sentMillis) < MQTT_RETRY_TIMEOUT)) {
+      continue;
+    }
+    if (!this->sendInflight(entry)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void MQTTLinuxClient::acknowledge(uint16_t packetID) {
+  for (size_t i = 0; i < this->numInflight; ++i) {
+    if (this->inflight[i].packetID != packetID) {
+      continue;
+    }
+
+    // free the copy and keep the table packed
+    free(this->inflight[i].topic);
+    this->inflight[i] = this->inflight[--this->numInflight];
+    this->inflight[this->numInflight] = MQTTLinuxClientInflight();
+    this->_completedMessages++;
+
+    // call callback if set
+    if (this->publishCallback != nullptr) {
+      this->publishCallback(this, packetID);
+    }
+    return;
+  }
+}
+
+void MQTTLinuxClient::acknowledgeHandler(lwmqtt_client_t * /*client*/, void *ref, uint16_t packetID, lwmqtt_qos_t qos) {
+  // only qos 1 messages are tracked
+  if (qos != LWMQTT_QOS1) {
+    return;
+  }
+
+  ((MQTTLinuxClient *)ref)->acknowledge(packetID);
+}
+
+int MQTTLinuxClient::grantedQos(size_t index) {
+  if ((index >= this->numSubscribeFilters) || (index >= MQTT_MAX_SUBSCRIBE_FILTERS)) {
+    return -1;
+  }
+  return this->subscribeQos[index];
+}
+
+void MQTTLinuxClient::trackSubscribe(uint16_t packetID, int num) {
+  // filters of the packet are unacknowledged until its suback
+  for (int i = 0; i < num; ++i) {
+    if (this->numSubscribeFilters + i < MQTT_MAX_SUBSCRIBE_FILTERS) {
+      this->subscribeQos[this->numSubscribeFilters + i] = -1;
+    }
+  }
+
+  this->subscribeFirst[this->numPendingSubscribes] = this->numSubscribeFilters;
+  this->subscribeCount[this->numPendingSubscribes] = num;
+  this->subscribeIDs[this->numPendingSubscribes++] = packetID;
+  this->numSubscribeFilters += num;
+}
+
+void MQTTLinuxClient::subscribed(uint16_t packetID, int count, lwmqtt_qos_t *qos) {
+  for (size_t i = 0; i < this->numPendingSubscribes; ++i) {
+    if (this->subscribeIDs[i] != packetID) {
+      continue;
+    }
+
+    // return codes follow the order of the filters in the packet
+    size_t first = this->subscribeFirst[i];
+    if (count > this->subscribeCount[i]) {
+      count = this->subscribeCount[i];
+    }
+    for (int k = 0; k < count; ++k) {
+      if (qos[k] == LWMQTT_QOS_FAILURE) {
+        this->_failedSubscribes++;
+      }
+      if (first + k < MQTT_MAX_SUBSCRIBE_FILTERS) {
+        this->subscribeQos[first + k] = (int)qos[k];
+      }
+    }
+
+    // keep the table packed
+    --this->numPendingSubscribes;
+    this->subscribeIDs[i] = this->subscribeIDs[this->numPendingSubscribes];
+    this->subscribeFirst[i] = this->subscribeFirst[this->numPendingSubscribes];
+    this->subscribeCount[i] = this->subscribeCount[this->numPendingSubscribes];
+    return;
+  }
+}
+
+void MQTTLinuxClient::subscribedHandler(lwmqtt_client_t * /*client*/, void *ref, uint16_t packetID, int count,
+                                        lwmqtt_qos_t *qos) {
+  ((MQTTLinuxClient *)ref)->subscribed(packetID, count, qos);
+}
@@ -29,10 +29,33 @@
 
 using namespace std;
 
+#if !defined(MQTT_MAX_INFLIGHT)
+  #define MQTT_MAX_INFLIGHT 16
+#endif
+
+#if !defined(MQTT_RETRY_TIMEOUT)
+  #define MQTT_RETRY_TIMEOUT 10000
+#endif
+
+// socket connect and tls handshake of connectStart()
+#if !defined(MQTT_CONNECT_TIMEOUT)
+  #define MQTT_CONNECT_TIMEOUT 10000
+#endif
+
+#if !defined(MQTT_MAX_PENDING_SUBSCRIBES)
+  #define MQTT_MAX_PENDING_SUBSCRIBES 16
+#endif
+
+// filters since the last connect whose granted level is kept
+#if !defined(MQTT_MAX_SUBSCRIBE_FILTERS)
+  #define MQTT_MAX_SUBSCRIBE_FILTERS 16
+#endif
+
 class MQTTLinuxClient;
 
 typedef void (*MQTTLinuxClientCallbackSimple)(const char* topic, const char* payload);
 typedef void (*MQTTLinuxClientCallbackAdvanced)(MQTTLinuxClient *client, char topic[], char bytes[], int length);
+typedef void (*MQTTLinuxClientCallbackPublish)(MQTTLinuxClient *client, uint16_t packetID);
 #if MQTT_HAS_FUNCTIONAL
 typedef std::function<void(const char* topic, const char* payload)> MQTTLinuxClientCallbackSimpleFunction;
 typedef std::function<void(MQTTLinuxClient *client, char topic[], char bytes[], int length)>
@@ -49,6 +72,21 @@ typedef struct {
 #endif
 } MQTTLinuxClientCallback;
 
+typedef struct {
+  uint16_t packetID = 0;
+  char *topic = nullptr;
+  char *payload = nullptr;
+  size_t length = 0;
+  bool retained = false;
+  uint32_t sentMillis = 0;
+} MQTTLinuxClientInflight;
+
+typedef enum {
+  MQTT_CONNECT_IDLE = 0,
+  MQTT_CONNECT_NETWORK,
+  MQTT_CONNECT_CONNACK
+} MQTTLinuxClientConnectPhase;
+
 class MQTTLinuxClient {
  private:
   size_t readBufSize = 0;
@@ -67,7 +105,7 @@ class MQTTLinuxClient {
   lwmqtt_will_t *will = nullptr;
   MQTTLinuxClientCallback callback;
 
-  lwmqtt_unix_network_t network = {-1};
+  lwmqtt_unix_network_t network = {-1, {}};
   lwmqtt_unix_timer_t timer1 = {0};
   lwmqtt_unix_timer_t timer2 = {0};
 #if defined(ERA_MQTT_SSL)
@@ -84,6 +122,26 @@ class MQTTLinuxClient {
   lwmqtt_err_t _lastError = (lwmqtt_err_t)0;
   uint32_t _droppedMessages = 0;
 
+  size_t publishWindow = 0;
+  size_t numInflight = 0;
+  uint32_t _completedMessages = 0;
+  MQTTLinuxClientInflight inflight[MQTT_MAX_INFLIGHT];
+  MQTTLinuxClientCallbackPublish publishCallback = nullptr;
+
+  MQTTLinuxClientConnectPhase connectPhase = MQTT_CONNECT_IDLE;
+  uint32_t connectMillis = 0;
+  const char *connectClientID = nullptr;
+  const char *connectUsername = nullptr;
+  const char *connectPassword = nullptr;
+
+  size_t numPendingSubscribes = 0;
+  uint32_t _failedSubscribes = 0;
+  uint16_t subscribeIDs[MQTT_MAX_PENDING_SUBSCRIBES] = {0};
+  size_t subscribeFirst[MQTT_MAX_PENDING_SUBSCRIBES] = {0};
+  int subscribeCount[MQTT_MAX_PENDING_SUBSCRIBES] = {0};
+  size_t numSubscribeFilters = 0;
+  int subscribeQos[MQTT_MAX_SUBSCRIBE_FILTERS] = {0};
+
  public:
   void *ref = nullptr;
 
@@ -113,6 +171,14 @@ class MQTTLinuxClient {
   void setTLSWithPort(int _port);
   void setSkipACK(bool skip);
 
+  // TLS sessions are resumed on reconnect, file keeps the session across restarts
+  void setTLSSessionFile(const char file[]);
+  void clearTLSSession();
+  uint32_t handshakeTime();
+  bool handshakeResumed();
+  uint32_t fullHandshakes();
+  uint32_t resumedHandshakes();
+
   void setHost(const char _hostname[]) { this->setHost(_hostname, 1883); }
   void setHost(const char hostname[], int port);
 
@@ -132,6 +198,12 @@ class MQTTLinuxClient {
   }
 
   void dropOverflow(bool enabled);
+
+  // QoS 1 publishes return once written, up to window of them may await their PUBACK
+  void setPublishWindow(size_t window);
+  void onPublishComplete(MQTTLinuxClientCallbackPublish cb) { this->publishCallback = cb; }
+  size_t inflightMessages() { return this->numInflight; }
+  uint32_t completedMessages() { return this->_completedMessages; }
   uint32_t droppedMessages() { return this->_droppedMessages; }
 
   bool connect(const char clientId[], bool skip = false) { return this->connect(clientId, nullptr, nullptr, skip); }
@@ -140,6 +212,12 @@ class MQTTLinuxClient {
   }
   bool connect(const char clientID[], const char username[], const char password[], bool skip = false);
 
+  // non-blocking connect, call connectPoll() until it returns true or connecting() turns false,
+  // the strings must stay valid until then
+  bool connectStart(const char clientID[], const char username[], const char password[]);
+  bool connectPoll();
+  bool connecting() { return this->connectPhase != MQTT_CONNECT_IDLE; }
+
 #if MQTT_HAS_STRING
   bool publish(const std::string &topic) { return this->publish(topic.c_str(), ""); }
   bool publish(const std::string &topic, const std::string &payload) { return this->publish(topic.c_str(), payload.c_str()); }
@@ -173,6 +251,15 @@ class MQTTLinuxClient {
   bool subscribe(const char topic[]) { return this->subscribe(topic, 0); }
   bool subscribe(const char topic[], int qos);
 
+  // send the subscription without waiting, loop() processes its suback
+  bool subscribeAsync(const char topic[], int qos);
+  // same for several filters, packed into as few packets as the write buffer allows
+  bool subscribeAsync(size_t count, const char *topics[], const int qos[]);
+  size_t pendingSubscribes() { return this->numPendingSubscribes; }
+  uint32_t failedSubscribes() { return this->_failedSubscribes; }
+  // granted level of the nth filter sent since the last connect, LWMQTT_QOS_FAILURE if refused, -1 if unacknowledged
+  int grantedQos(size_t index);
+
 #if MQTT_HAS_STRING
   bool unsubscribe(const std::string &topic) { return this->unsubscribe(topic.c_str()); }
 #endif
@@ -180,6 +267,8 @@ class MQTTLinuxClient {
 
   bool loop();
   bool connected();
+  int getSocket();
+  uint32_t keepAliveRemaining();
   bool sessionPresent() { return this->_sessionPresent; }
 
   lwmqtt_err_t lastError() { return this->_lastError; }
@@ -189,6 +278,18 @@ class MQTTLinuxClient {
 
  private:
   void close();
+  void prepareOptions(lwmqtt_connect_options_t &options, const char clientID[], const char username[],
+                      const char password[]);
+  bool connectAbort();
+  void trackSubscribe(uint16_t packetID, int num);
+  void subscribed(uint16_t packetID, int count, lwmqtt_qos_t *qos);
+  static void subscribedHandler(lwmqtt_client_t *client, void *ref, uint16_t packetID, int count,
+                                lwmqtt_qos_t *qos);
+  bool waitInflight();
+  bool sendInflight(MQTTLinuxClientInflight *entry);
+  bool retransmitInflight(bool all);
+  void acknowledge(uint16_t packetID);
+  static void acknowledgeHandler(lwmqtt_client_t *client, void *ref, uint16_t packetID, lwmqtt_qos_t qos);
 };
 
 #endif /* INC_MQTT_LINUX_HPP_ */
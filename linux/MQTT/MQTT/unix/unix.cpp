@@ -6,6 +6,7 @@
 #include <sys/ioctl.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <poll.h>
 
 #include "unix.hpp"
 
@@ -44,60 +45,38 @@ lwmqtt_err_t lwmqtt_unix_network_connect(lwmqtt_unix_network_t *network, char *h
   // close any open socket
   lwmqtt_unix_network_disconnect(network);
 
-  // prepare resolver hints
-  struct addrinfo hints;
-  memset(&hints, 0, sizeof(hints));
-  hints.ai_family = PF_UNSPEC;
-  hints.ai_flags = AI_ADDRCONFIG;
-  hints.ai_socktype = SOCK_STREAM;
-
-  // resolve address
-  struct addrinfo *result = NULL;
-  int rc = getaddrinfo(host, NULL, &hints, &result);
-  if (rc < 0) {
+  // resolve through the cache and race the candidate addresses
+  network->socket = ERaConnectLinux::connect(host, (uint16_t)port);
+  if (network->socket < 0) {
     return LWMQTT_NETWORK_FAILED_CONNECT;
   }
 
-  // prepare selected result
-  struct addrinfo *current = result;
-  struct addrinfo *selected = NULL;
-
-  // traverse list and select first found ipv4 address
-  while (current) {
-    // check if ipv4 address
-    if (current->ai_family == AF_INET) {
-      selected = current;
-      break;
-    }
+  return LWMQTT_SUCCESS;
+}
 
-    // move one to next
-    current = current->ai_next;
-  }
+lwmqtt_err_t lwmqtt_unix_network_connect_start(lwmqtt_unix_network_t *network, char *host, int port) {
+  // close any open socket
+  lwmqtt_unix_network_disconnect(network);
 
-  // return error if none found
-  if (selected == NULL) {
+  // resolve through the cache, sockets are opened by poll
+  if (!ERaConnectLinux::begin(network->attempt, host, (uint16_t)port)) {
     return LWMQTT_NETWORK_FAILED_CONNECT;
   }
 
-  // populate address struct
-  struct sockaddr_in address;
-  address.sin_port = htons(port);
-  address.sin_family = AF_INET;
-  address.sin_addr = ((struct sockaddr_in *)(selected->ai_addr))->sin_addr;
-
-  // free result
-  freeaddrinfo(result);
+  return LWMQTT_SUCCESS;
+}
 
-  // create new socket
-  network->socket = socket(AF_INET, SOCK_STREAM, 0);
-  if (network->socket < 0) {
+lwmqtt_err_t lwmqtt_unix_network_connect_poll(lwmqtt_unix_network_t *network, bool *connected) {
+  // check the attempt without waiting
+  int fd = ERaConnectLinux::poll(network->attempt, 0);
+  *connected = (fd >= 0);
+  if (fd == ERA_CONNECT_FAILED) {
     return LWMQTT_NETWORK_FAILED_CONNECT;
   }
 
-  // connect socket
-  rc = connect(network->socket, (struct sockaddr *)&address, sizeof(address));
-  if (rc < 0) {
-    return LWMQTT_NETWORK_FAILED_CONNECT;
+  // keep the connected socket
+  if (fd >= 0) {
+    network->socket = fd;
   }
 
   return LWMQTT_SUCCESS;
@@ -132,6 +111,9 @@ lwmqtt_err_t lwmqtt_unix_network_wait(lwmqtt_unix_network_t *network, bool *conn
 }
 
 void lwmqtt_unix_network_disconnect(lwmqtt_unix_network_t *network) {
+  // abort a connect in progress
+  ERaConnectLinux::cancel(network->attempt);
+
   // close socket if present
   if (network->socket >= 0) {
     close(network->socket);
@@ -164,18 +146,18 @@ lwmqtt_err_t lwmqtt_unix_network_peek(lwmqtt_unix_network_t *network, size_t *av
 }
 
 lwmqtt_err_t lwmqtt_unix_network_select(lwmqtt_unix_network_t *network, bool *available, uint32_t timeout) {
-  // prepare set
-  fd_set set;
-  fd_set ex_set;
-  FD_ZERO(&set);
-  FD_ZERO(&ex_set);
-  FD_SET(network->socket, &set);
-  FD_SET(network->socket, &ex_set);
+  // prepare poll descriptor
+  struct pollfd pfd;
+  pfd.fd = network->socket;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
 
   // wait for data
-  struct timeval t = {.tv_sec = timeout / 1000, .tv_usec = (timeout % 1000) * 1000};
-  int result = select(network->socket + 1, &set, NULL, &ex_set, &t);
-  if (result < 0 || FD_ISSET(network->socket, &ex_set)) {
+  int result = poll(&pfd, 1, (int)timeout);
+  if (result < 0 && errno == EINTR) {
+    result = 0;
+  }
+  if (result < 0 || (pfd.revents & (POLLERR | POLLNVAL))) {
     return LWMQTT_NETWORK_FAILED_READ;
   }
 
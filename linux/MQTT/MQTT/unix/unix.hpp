@@ -2,6 +2,7 @@
 #define LWMQTT_UNIX_HPP
 
 #include <sys/time.h>
+#include <Utility/ERaConnectLinux.hpp>
 
 extern "C" {
 #include <MQTT/MQTT/lwmqtt/lwmqtt.h>
@@ -33,6 +34,7 @@ int32_t lwmqtt_unix_timer_get(void *ref);
  */
 typedef struct {
   int socket;
+  ERaConnectLinux::Attempt_t attempt;
 } lwmqtt_unix_network_t;
 
 /**
@@ -45,6 +47,25 @@ typedef struct {
  */
 lwmqtt_err_t lwmqtt_unix_network_connect(lwmqtt_unix_network_t *network, char *host, int port);
 
+/**
+ * Function to start a UNIX network connection without waiting for it.
+ *
+ * @param network - The network object.
+ * @param host - The host.
+ * @param port - The port.
+ * @return An error value.
+ */
+lwmqtt_err_t lwmqtt_unix_network_connect_start(lwmqtt_unix_network_t *network, char *host, int port);
+
+/**
+ * Function to check on a connection begun with lwmqtt_unix_network_connect_start.
+ *
+ * @param network - The network object.
+ * @param connected - Set once the socket is connected.
+ * @return An error value.
+ */
+lwmqtt_err_t lwmqtt_unix_network_connect_poll(lwmqtt_unix_network_t *network, bool *connected);
+
 /**
  * Wait until the socket is connected or a timeout has been reached.
  *
@@ -6,10 +6,85 @@
 #include <sys/ioctl.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <stdio.h>
 #include <string.h>
 
 #include "unix_tls.hpp"
+#include <Utility/ERaFlashLinux.hpp>
+
+typedef struct {
+  char host[LWMQTT_UNIX_TLS_MAX_HOST];
+  int32_t port;
+  uint32_t len;
+} lwmqtt_unix_tls_session_header_t;
+
+static bool lwmqtt_unix_tls_session_match(lwmqtt_unix_tls_network_t *network, const char *host, int port) {
+  return (network->session_valid && (network->session_port == port) && !strcmp(network->session_host, host));
+}
+
+static void lwmqtt_unix_tls_session_free(lwmqtt_unix_tls_network_t *network) {
+  mbedtls_ssl_session_free(&network->session);
+  mbedtls_ssl_session_init(&network->session);
+  network->session_valid = false;
+}
+
+static void lwmqtt_unix_tls_session_store(lwmqtt_unix_tls_network_t *network) {
+  // check if the session is persisted
+  if (!network->session_file || !network->session_valid) {
+    return;
+  }
+
+  size_t size = sizeof(lwmqtt_unix_tls_session_header_t) + LWMQTT_UNIX_TLS_SESSION_SIZE;
+  uint8_t *buf = (uint8_t *)calloc(1, size);
+  if (!buf) {
+    return;
+  }
+
+  // host and port go first so a session is only offered to its own broker
+  lwmqtt_unix_tls_session_header_t *header = (lwmqtt_unix_tls_session_header_t *)buf;
+  memcpy(header->host, network->session_host, sizeof(header->host));
+  header->port = network->session_port;
+
+  size_t len = 0;
+  int ret = mbedtls_ssl_session_save(&network->session, buf + sizeof(*header), LWMQTT_UNIX_TLS_SESSION_SIZE, &len);
+  if (ret == 0) {
+    header->len = (uint32_t)len;
+    ERaFlashLinux flash;
+    flash.writeFlash(network->session_file, buf, sizeof(*header) + len);
+  }
+
+  // the session holds the master secret
+  mbedtls_platform_zeroize(buf, size);
+  free(buf);
+}
+
+static void lwmqtt_unix_tls_session_restore(lwmqtt_unix_tls_network_t *network) {
+  size_t size = sizeof(lwmqtt_unix_tls_session_header_t) + LWMQTT_UNIX_TLS_SESSION_SIZE;
+  uint8_t *buf = (uint8_t *)calloc(1, size);
+  if (!buf) {
+    return;
+  }
+
+  ERaFlashLinux flash;
+  flash.readFlash(network->session_file, buf, size);
+
+  lwmqtt_unix_tls_session_header_t *header = (lwmqtt_unix_tls_session_header_t *)buf;
+  header->host[sizeof(header->host) - 1] = 0;
+  if (header->len && (header->len <= LWMQTT_UNIX_TLS_SESSION_SIZE)) {
+    lwmqtt_unix_tls_session_free(network);
+    if (mbedtls_ssl_session_load(&network->session, buf + sizeof(*header), header->len) == 0) {
+      memcpy(network->session_host, header->host, sizeof(network->session_host));
+      network->session_port = header->port;
+      network->session_valid = true;
+    } else {
+      lwmqtt_unix_tls_session_free(network);
+    }
+  }
+
+  mbedtls_platform_zeroize(buf, size);
+  free(buf);
+}
 
 void lwmqtt_unix_tls_timer_set(void *ref, uint32_t timeout) {
   // cast timer reference
@@ -52,14 +127,32 @@ void lwmqtt_unix_tls_network_init(lwmqtt_unix_tls_network_t *network, bool verif
   network->ca_len = ca_len;
 }
 
-lwmqtt_err_t lwmqtt_unix_tls_network_connect(lwmqtt_unix_tls_network_t *network, char *host, int port) {
+void lwmqtt_unix_tls_network_set_session_file(lwmqtt_unix_tls_network_t *network, const char *file) {
+  if (!network) {
+    return;
+  }
+
+  network->session_file = file;
+  if (file && !network->session_valid) {
+    lwmqtt_unix_tls_session_restore(network);
+  }
+}
+
+void lwmqtt_unix_tls_network_clear_session(lwmqtt_unix_tls_network_t *network) {
+  if (!network) {
+    return;
+  }
+
+  lwmqtt_unix_tls_session_free(network);
+  if (network->session_file) {
+    remove(network->session_file);
+  }
+}
+
+static lwmqtt_err_t lwmqtt_unix_tls_network_prepare(lwmqtt_unix_tls_network_t *network) {
   // close any open socket
   lwmqtt_unix_tls_network_disconnect(network);
 
-  static char port_string[10] {0};
-  memset(port_string, 0, sizeof(port_string));
-  snprintf(port_string, sizeof(port_string), "%d", port);
-
   // initialize support structures
   mbedtls_net_init(&network->socket);
   mbedtls_ssl_init(&network->ssl);
@@ -67,6 +160,7 @@ lwmqtt_err_t lwmqtt_unix_tls_network_connect(lwmqtt_unix_tls_network_t *network,
   mbedtls_x509_crt_init(&network->cacert);
   mbedtls_ctr_drbg_init(&network->ctr_drbg);
   mbedtls_entropy_init(&network->entropy);
+  network->connecting = true;
 
   // setup entropy source
   int ret = mbedtls_ctr_drbg_seed(&network->ctr_drbg, mbedtls_entropy_func, &network->entropy, NULL, 0);
@@ -82,15 +176,13 @@ lwmqtt_err_t lwmqtt_unix_tls_network_connect(lwmqtt_unix_tls_network_t *network,
     }
   }
 
-  // connect socket
-  ret = mbedtls_net_connect(&network->socket, host, port_string, MBEDTLS_NET_PROTO_TCP);
-  if (ret != 0) {
-    return LWMQTT_NETWORK_FAILED_CONNECT;
-  }
+  return LWMQTT_SUCCESS;
+}
 
+static lwmqtt_err_t lwmqtt_unix_tls_network_setup(lwmqtt_unix_tls_network_t *network, char *host, int port) {
   // load defaults
-  ret = mbedtls_ssl_config_defaults(&network->conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
-                                    MBEDTLS_SSL_PRESET_DEFAULT);
+  int ret = mbedtls_ssl_config_defaults(&network->conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                        MBEDTLS_SSL_PRESET_DEFAULT);
   if (ret != 0) {
     return LWMQTT_NETWORK_FAILED_CONNECT;
   }
@@ -106,6 +198,11 @@ lwmqtt_err_t lwmqtt_unix_tls_network_connect(lwmqtt_unix_tls_network_t *network,
   // set rng callback
   mbedtls_ssl_conf_rng(&network->conf, mbedtls_ctr_drbg_random, &network->ctr_drbg);
 
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+  // ask for a ticket, the broker need not keep a session cache
+  mbedtls_ssl_conf_session_tickets(&network->conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+
   // setup ssl context
   ret = mbedtls_ssl_setup(&network->ssl, &network->conf);
   if (ret != 0) {
@@ -130,12 +227,131 @@ lwmqtt_err_t lwmqtt_unix_tls_network_connect(lwmqtt_unix_tls_network_t *network,
     }
   }
 
+  // offer the last session of this broker, the server falls back to a full handshake if it declines
+  network->session_offered = false;
+  if (lwmqtt_unix_tls_session_match(network, host, port)) {
+    network->session_offered = (mbedtls_ssl_set_session(&network->ssl, &network->session) == 0);
+  }
+
+  network->handshake_start = ERaMillis();
+  network->resumed = false;
+
+  return LWMQTT_SUCCESS;
+}
+
+static void lwmqtt_unix_tls_network_finish(lwmqtt_unix_tls_network_t *network, char *host, int port) {
+  // keep the negotiated session, a resumed one keeps the start time of its full handshake
+  mbedtls_ssl_session session;
+  mbedtls_ssl_session_init(&session);
+  if (mbedtls_ssl_get_session(&network->ssl, &session) == 0) {
+#if defined(MBEDTLS_HAVE_TIME)
+    network->resumed = (network->session_offered &&
+                        (session.MBEDTLS_PRIVATE(start) == network->session.MBEDTLS_PRIVATE(start)));
+#endif
+    lwmqtt_unix_tls_session_free(network);
+    network->session = session;
+    snprintf(network->session_host, sizeof(network->session_host), "%s", host);
+    network->session_port = port;
+    network->session_valid = (strlen(host) < sizeof(network->session_host));
+    lwmqtt_unix_tls_session_store(network);
+  } else {
+    mbedtls_ssl_session_free(&session);
+  }
+
+  if (network->resumed) {
+    network->resumed_handshakes++;
+  } else {
+    network->full_handshakes++;
+  }
+
+  network->connecting = false;
+}
+
+lwmqtt_err_t lwmqtt_unix_tls_network_connect(lwmqtt_unix_tls_network_t *network, char *host, int port) {
+  // initialize contexts and the ca certificate
+  lwmqtt_err_t err = lwmqtt_unix_tls_network_prepare(network);
+  if (err != LWMQTT_SUCCESS) {
+    return err;
+  }
+
+  // connect socket, resolved through the cache and raced like the plain transport
+  network->socket.fd = ERaConnectLinux::connect(host, (uint16_t)port);
+  if (network->socket.fd < 0) {
+    return LWMQTT_NETWORK_FAILED_CONNECT;
+  }
+
+  // configure the ssl context
+  err = lwmqtt_unix_tls_network_setup(network, host, port);
+  if (err != LWMQTT_SUCCESS) {
+    return err;
+  }
+
   // perform handshake
-  ret = mbedtls_ssl_handshake(&network->ssl);
+  int ret = mbedtls_ssl_handshake(&network->ssl);
+  network->handshake_ms = (uint32_t)(ERaMillis() - network->handshake_start);
   if (ret != 0) {
     return LWMQTT_NETWORK_FAILED_CONNECT;
   }
 
+  lwmqtt_unix_tls_network_finish(network, host, port);
+
+  return LWMQTT_SUCCESS;
+}
+
+lwmqtt_err_t lwmqtt_unix_tls_network_connect_start(lwmqtt_unix_tls_network_t *network, char *host, int port) {
+  // initialize contexts and the ca certificate
+  lwmqtt_err_t err = lwmqtt_unix_tls_network_prepare(network);
+  if (err != LWMQTT_SUCCESS) {
+    return err;
+  }
+
+  // resolve through the cache, sockets are opened by poll
+  if (!ERaConnectLinux::begin(network->attempt, host, (uint16_t)port)) {
+    return LWMQTT_NETWORK_FAILED_CONNECT;
+  }
+
+  return LWMQTT_SUCCESS;
+}
+
+lwmqtt_err_t lwmqtt_unix_tls_network_connect_poll(lwmqtt_unix_tls_network_t *network, char *host, int port,
+                                                  bool *connected) {
+  *connected = false;
+
+  // check the socket attempt without waiting
+  if (network->socket.fd < 0) {
+    int fd = ERaConnectLinux::poll(network->attempt, 0);
+    if (fd == ERA_CONNECT_FAILED) {
+      return LWMQTT_NETWORK_FAILED_CONNECT;
+    } else if (fd == ERA_CONNECT_PENDING) {
+      return LWMQTT_SUCCESS;
+    }
+    network->socket.fd = fd;
+
+    // configure the ssl context
+    lwmqtt_err_t err = lwmqtt_unix_tls_network_setup(network, host, port);
+    if (err != LWMQTT_SUCCESS) {
+      return err;
+    }
+
+    // handshake in steps as records arrive
+    if (mbedtls_net_set_nonblock(&network->socket) != 0) {
+      return LWMQTT_NETWORK_FAILED_CONNECT;
+    }
+  }
+
+  // continue handshake
+  int ret = mbedtls_ssl_handshake(&network->ssl);
+  if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+    return LWMQTT_SUCCESS;
+  }
+  network->handshake_ms = (uint32_t)(ERaMillis() - network->handshake_start);
+  if (ret != 0 || mbedtls_net_set_block(&network->socket) != 0) {
+    return LWMQTT_NETWORK_FAILED_CONNECT;
+  }
+
+  lwmqtt_unix_tls_network_finish(network, host, port);
+  *connected = true;
+
   return LWMQTT_SUCCESS;
 }
 
@@ -172,15 +388,20 @@ void lwmqtt_unix_tls_network_disconnect(lwmqtt_unix_tls_network_t *network) {
   if (!network) {
     return;
   }
-  if (network->socket.fd < 0) {
+
+  // abort a connect in progress
+  ERaConnectLinux::cancel(network->attempt);
+  if (network->socket.fd < 0 && !network->connecting) {
     return;
   }
 
   // cleanup resources
-  int ret;
-  do {
-    ret = mbedtls_ssl_close_notify(&network->ssl);
-  } while (ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+  if (network->socket.fd >= 0) {
+    int ret;
+    do {
+      ret = mbedtls_ssl_close_notify(&network->ssl);
+    } while (ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+  }
 
   mbedtls_x509_crt_free(&network->cacert);
   mbedtls_entropy_free(&network->entropy);
@@ -190,6 +411,7 @@ void lwmqtt_unix_tls_network_disconnect(lwmqtt_unix_tls_network_t *network) {
   mbedtls_net_free(&network->socket);
 
   network->socket.fd = -1;
+  network->connecting = false;
 }
 
 lwmqtt_err_t lwmqtt_unix_tls_network_peek(lwmqtt_unix_tls_network_t *network, size_t *available, uint32_t timeout) {
@@ -227,18 +449,18 @@ lwmqtt_err_t lwmqtt_unix_tls_network_peek(lwmqtt_unix_tls_network_t *network, si
 }
 
 lwmqtt_err_t lwmqtt_unix_tls_network_select(lwmqtt_unix_tls_network_t *network, bool *available, uint32_t timeout) {
-  // prepare set
-  fd_set set;
-  fd_set ex_set;
-  FD_ZERO(&set);
-  FD_ZERO(&ex_set);
-  FD_SET(network->socket.fd, &set);
-  FD_SET(network->socket.fd, &ex_set);
+  // prepare poll descriptor
+  struct pollfd pfd;
+  pfd.fd = network->socket.fd;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
 
   // wait for data
-  struct timeval t = {.tv_sec = timeout / 1000, .tv_usec = (timeout % 1000) * 1000};
-  int result = select(network->socket.fd + 1, &set, NULL, &ex_set, &t);
-  if (result < 0 || FD_ISSET(network->socket.fd, &ex_set)) {
+  int result = poll(&pfd, 1, (int)timeout);
+  if (result < 0 && errno == EINTR) {
+    result = 0;
+  }
+  if (result < 0 || (pfd.revents & (POLLERR | POLLNVAL))) {
     return LWMQTT_NETWORK_FAILED_READ;
   }
 
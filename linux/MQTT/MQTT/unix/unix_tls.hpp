@@ -8,11 +8,19 @@
 #include <mbedtls/net_sockets.h>
 #include <mbedtls/platform.h>
 #include <mbedtls/ssl.h>
+#include <Utility/ERaConnectLinux.hpp>
 
 extern "C" {
 #include <MQTT/MQTT/lwmqtt/lwmqtt.h>
 }
 
+// largest serialized session kept on disk, the peer certificate is part of it
+#if !defined(LWMQTT_UNIX_TLS_SESSION_SIZE)
+  #define LWMQTT_UNIX_TLS_SESSION_SIZE 4096
+#endif
+
+#define LWMQTT_UNIX_TLS_MAX_HOST 64
+
 /**
  * The UNIX timer object.
  */
@@ -44,9 +52,22 @@ typedef struct {
   mbedtls_ssl_config conf;
   mbedtls_x509_crt cacert;
   mbedtls_net_context socket;
+  ERaConnectLinux::Attempt_t attempt;
+  bool connecting;
   uint8_t *ca_buf;
   size_t ca_len;
   bool verify;
+  mbedtls_ssl_session session;
+  bool session_valid;
+  char session_host[LWMQTT_UNIX_TLS_MAX_HOST];
+  int session_port;
+  const char *session_file;
+  bool session_offered;
+  uint32_t handshake_start;
+  uint32_t handshake_ms;
+  bool resumed;
+  uint32_t full_handshakes;
+  uint32_t resumed_handshakes;
 } lwmqtt_unix_tls_network_t;
 
 /**
@@ -59,6 +80,24 @@ typedef struct {
  */
 void lwmqtt_unix_tls_network_init(lwmqtt_unix_tls_network_t *network, bool verify, const uint8_t *ca_buf, size_t ca_len);
 
+/**
+ * Function to persist the session used for resumption in a file.
+ *
+ * A session saved by an earlier run is loaded right away, a new one is
+ * written after every handshake. Passing NULL keeps the session in memory only.
+ *
+ * @param network - The network object.
+ * @param file - The session file.
+ */
+void lwmqtt_unix_tls_network_set_session_file(lwmqtt_unix_tls_network_t *network, const char *file);
+
+/**
+ * Function to forget the cached session, the next connection does a full handshake.
+ *
+ * @param network - The network object.
+ */
+void lwmqtt_unix_tls_network_clear_session(lwmqtt_unix_tls_network_t *network);
+
 /**
  * Function to establish a UNIX network connection.
  *
@@ -69,6 +108,29 @@ void lwmqtt_unix_tls_network_init(lwmqtt_unix_tls_network_t *network, bool verif
  */
 lwmqtt_err_t lwmqtt_unix_tls_network_connect(lwmqtt_unix_tls_network_t *network, char *host, int port);
 
+/**
+ * Function to start a UNIX network connection without waiting for it.
+ *
+ * @param network - The network object.
+ * @param host - The host.
+ * @param port - The port.
+ * @return An error value.
+ */
+lwmqtt_err_t lwmqtt_unix_tls_network_connect_start(lwmqtt_unix_tls_network_t *network, char *host, int port);
+
+/**
+ * Function to advance a connection begun with lwmqtt_unix_tls_network_connect_start,
+ * the handshake runs in steps as its records arrive.
+ *
+ * @param network - The network object.
+ * @param host - The host.
+ * @param port - The port.
+ * @param connected - Set once the handshake is complete.
+ * @return An error value.
+ */
+lwmqtt_err_t lwmqtt_unix_tls_network_connect_poll(lwmqtt_unix_tls_network_t *network, char *host, int port,
+                                                  bool *connected);
+
 /**
  * Wait until the socket is connected or a timeout has been reached.
  *
@@ -3,6 +3,7 @@
 #define INC_ERA_MODBUS_LINUX_HPP_
 
 #include <Modbus/ERaModbus.hpp>
+#include <Utility/ERaSocketLinux.hpp>
 
 #define SerialMB SerialModBus<ERaSerialLinux>::serial()
 
@@ -13,6 +14,10 @@ void ERaModbus<Api>::configModbus() {
     }
 
     this->streamRTU = &SerialMB;
+#if defined(ERA_MODBUS_RS485)
+    SerialMB.setRS485(true, ERA_MODBUS_RS485_DELAY_BEFORE,
+                            ERA_MODBUS_RS485_DELAY_AFTER);
+#endif
     SerialMB.begin("/dev/ttyAMA0", MODBUS_BAUDRATE);
     this->_streamDefault = true;
 }
@@ -27,6 +32,13 @@ void ERaModbus<Api>::setBaudRate(uint32_t baudrate) {
     SerialMB.begin("/dev/ttyAMA0", baudrate);
 }
 
+#if defined(ERA_MODBUS_TCP_AUTO_CLIENT)
+template <class Api>
+Client* ERaModbus<Api>::createTCPClient() {
+    return new_modbus ERaSocketLinux();
+}
+#endif
+
 template <class Api>
 bool ERaModbus<Api>::waitResponse(ERaModbusResponse* response) {
     if (response == nullptr) {
@@ -53,19 +65,19 @@ bool ERaModbus<Api>::waitResponse(ERaModbusResponse* response) {
             if (ModbusState::is(ModbusStateT::STATE_MB_PARSE)) {
                 break;
             }
-            ERA_MODBUS_YIELD();
+            /* Sleep on the descriptor instead of polling every yield */
+            this->stream->waitAvailable(ERaRemainingTime(startMillis, this->timeout));
             continue;
         }
 
         do {
-            response->add(this->stream->read());
+            response->add((uint8_t)this->stream->read());
         } while (this->stream->available());
 
         if (response->isComplete()) {
             ERaLogHex("MB <<", response->getMessage(), response->getPosition());
             return response->isSuccess();
         }
-        ERA_MODBUS_YIELD();
     } while (ERaRemainingTime(startMillis, this->timeout));
     return false;
 }
@@ -80,6 +92,17 @@ void ERaModbus<Api>::sendCommand(uint8_t* data, size_t size) {
     }
 
     ERaLogHex("MB >>", data, size);
+    if ((this->stream == this->streamRTU) &&
+        (this->streamRTU == &SerialMB)) {
+        /* Leftovers of the last reply would corrupt the next one,
+           the silent interval is kept by waitFrameGap() */
+        SerialMB.discardInput();
+        if (SerialMB.isRS485()) {
+            /* The kernel releases the driver after the last bit */
+            this->stream->write(data, size);
+            return;
+        }
+    }
     this->switchToTransmit();
     this->stream->write(data, size);
     this->stream->flush();
@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <string.h>
+#include <unistd.h>
 
 class Stream
 {
@@ -33,6 +34,31 @@ public:
 
     virtual void flush() = 0;
 
+    /* Copy out what has been received, without waiting */
+    virtual size_t readAvailable(uint8_t* buffer, size_t size) {
+        size_t count {0};
+        while ((count < size) && (this->available() > 0)) {
+            int value = this->read();
+            if (value < 0) {
+                break;
+            }
+            buffer[count++] = (uint8_t)value;
+        }
+        return count;
+    }
+
+    /* Block until data is available or timeout (ms) expires.
+       Streams without a descriptor sleep a millisecond and recheck */
+    virtual bool waitAvailable(unsigned long timeout) {
+        if (this->available() > 0) {
+            return true;
+        }
+        if (timeout) {
+            usleep(1000);
+        }
+        return (this->available() > 0);
+    }
+
 protected:
 };
 
@@ -0,0 +1,373 @@
+#ifndef INC_ERA_CONNECT_LINUX_HPP_
+#define INC_ERA_CONNECT_LINUX_HPP_
+
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <netinet/in.h>
+#include <netdb.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <pthread.h>
+#include <ERa/ERaDefine.hpp>
+#include <Utility/ERaUtility.hpp>
+
+#if !defined(ERA_CONNECT_TIMEOUT)
+    #define ERA_CONNECT_TIMEOUT         5000
+#endif
+
+/* Head start of one candidate address before the next one is
+   raced against it (RFC 8305 connection attempt delay) */
+#if !defined(ERA_CONNECT_ATTEMPT_DELAY)
+    #define ERA_CONNECT_ATTEMPT_DELAY   250
+#endif
+
+#if !defined(ERA_DNS_CACHE_SIZE)
+    #define ERA_DNS_CACHE_SIZE          8
+#endif
+
+/* getaddrinfo() does not report record TTLs, cached
+   answers expire after this and on a failed connect */
+#if !defined(ERA_DNS_CACHE_TTL)
+    #define ERA_DNS_CACHE_TTL           300000
+#endif
+
+#define ERA_DNS_MAX_ADDRESSES           4
+#define ERA_DNS_MAX_HOST                64
+
+#define ERA_CONNECT_FAILED              (-1)
+#define ERA_CONNECT_PENDING             (-2)
+
+/* Resolves through a small cache and connects to the first
+   candidate that answers, IPv6 and IPv4 addresses are tried
+   alternately and overlap instead of waiting out each SYN.
+   The returned socket is blocking, like one from ::connect() */
+class ERaConnectLinux
+{
+    typedef struct __Address_t {
+        struct sockaddr_storage addr;
+        socklen_t len;
+    } Address_t;
+
+    typedef struct __DnsEntry_t {
+        char host[ERA_DNS_MAX_HOST];
+        Address_t addresses[ERA_DNS_MAX_ADDRESSES];
+        size_t count;
+        MillisTime_t resolvedMillis;
+    } DnsEntry_t;
+
+public:
+    /* One connect in progress, driven by poll() */
+    typedef struct __Attempt_t {
+        Address_t addresses[ERA_DNS_MAX_ADDRESSES];
+        size_t count;
+        size_t started;
+        size_t pending;
+        struct pollfd fds[ERA_DNS_MAX_ADDRESSES];
+        MillisTime_t startMillis;
+        MillisTime_t attemptMillis;
+        uint32_t timeout;
+        char host[ERA_DNS_MAX_HOST];
+    } Attempt_t;
+
+    /* Socket connected to host, -1 on failure */
+    static int connect(const char* host, uint16_t port, uint32_t timeout = ERA_CONNECT_TIMEOUT) {
+        Attempt_t attempt {};
+        if (!ERaConnectLinux::begin(attempt, host, port, timeout)) {
+            return ERA_CONNECT_FAILED;
+        }
+        return ERaConnectLinux::wait(attempt);
+    }
+
+    static int connect(const struct sockaddr* addr, socklen_t len, uint32_t timeout = ERA_CONNECT_TIMEOUT) {
+        Attempt_t attempt {};
+        if ((addr == nullptr) ||
+            (len > sizeof(attempt.addresses[0].addr))) {
+            return ERA_CONNECT_FAILED;
+        }
+        memcpy(&attempt.addresses[0].addr, addr, len);
+        attempt.addresses[0].len = len;
+        ERaConnectLinux::reset(attempt, 1, timeout);
+        return ERaConnectLinux::wait(attempt);
+    }
+
+    /* Resolves host, sockets are opened by poll() */
+    static bool begin(Attempt_t& attempt, const char* host, uint16_t port, uint32_t timeout = ERA_CONNECT_TIMEOUT) {
+        ERaConnectLinux::cancel(attempt);
+        size_t count = ERaConnectLinux::resolve(host, attempt.addresses);
+        if (!count) {
+            return false;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            ERaConnectLinux::setPort(attempt.addresses[i], port);
+        }
+        ERaConnectLinux::reset(attempt, count, timeout);
+        if (strlen(host) < sizeof(attempt.host)) {
+            snprintf(attempt.host, sizeof(attempt.host), "%s", host);
+        }
+        return true;
+    }
+
+    /* Waits up to wait ms (0 only checks), returns the socket,
+       ERA_CONNECT_PENDING or ERA_CONNECT_FAILED */
+    static int poll(Attempt_t& attempt, uint32_t wait) {
+        int winner {ERA_CONNECT_PENDING};
+        MillisTime_t callMillis = ERaMillis();
+
+        while (winner == ERA_CONNECT_PENDING) {
+            MillisTime_t remain = ERaRemainingTime(attempt.startMillis, attempt.timeout);
+            if (!remain) {
+                winner = ERA_CONNECT_FAILED;
+                break;
+            }
+            if ((attempt.started < attempt.count) &&
+                (!attempt.pending || !ERaRemainingTime(attempt.attemptMillis, ERA_CONNECT_ATTEMPT_DELAY))) {
+                int fd = ERaConnectLinux::start(attempt.addresses[attempt.started++]);
+                attempt.attemptMillis = ERaMillis();
+                if (fd >= 0) {
+                    attempt.fds[attempt.pending].fd = fd;
+                    attempt.fds[attempt.pending].events = POLLOUT;
+                    attempt.fds[attempt.pending++].revents = 0;
+                }
+                else {
+                    attempt.attemptMillis -= ERA_CONNECT_ATTEMPT_DELAY;
+                }
+                continue;
+            }
+            if (!attempt.pending) {
+                winner = ERA_CONNECT_FAILED;
+                break;
+            }
+
+            MillisTime_t budget = ERaRemainingTime(callMillis, wait);
+            if (budget < remain) {
+                remain = budget;
+            }
+            if (attempt.started < attempt.count) {
+                MillisTime_t delay = ERaRemainingTime(attempt.attemptMillis, ERA_CONNECT_ATTEMPT_DELAY);
+                if (delay < remain) {
+                    remain = delay;
+                }
+            }
+            int rc = ::poll(attempt.fds, attempt.pending, (int)remain);
+            if ((rc < 0) && (errno != EINTR)) {
+                winner = ERA_CONNECT_FAILED;
+                break;
+            }
+            for (size_t i = 0; (i < attempt.pending) && (rc > 0);) {
+                if (!attempt.fds[i].revents) {
+                    ++i;
+                    continue;
+                }
+                int error {0};
+                socklen_t len = sizeof(error);
+                if ((getsockopt(attempt.fds[i].fd, SOL_SOCKET, SO_ERROR, &error, &len) == 0) && !error) {
+                    winner = attempt.fds[i].fd;
+                    attempt.fds[i] = attempt.fds[--attempt.pending];
+                    break;
+                }
+                /* Refused or unreachable, the next candidate may start now */
+                ::close(attempt.fds[i].fd);
+                attempt.fds[i] = attempt.fds[--attempt.pending];
+                attempt.attemptMillis = ERaMillis() - ERA_CONNECT_ATTEMPT_DELAY;
+            }
+            if ((winner == ERA_CONNECT_PENDING) &&
+                !ERaRemainingTime(callMillis, wait)) {
+                return ERA_CONNECT_PENDING;
+            }
+        }
+
+        ERaConnectLinux::cancel(attempt);
+        if (winner >= 0) {
+            int flags = fcntl(winner, F_GETFL, 0);
+            fcntl(winner, F_SETFL, flags & ~O_NONBLOCK);
+        }
+        else if (attempt.host[0]) {
+            ERaConnectLinux::invalidate(attempt.host);
+        }
+        return winner;
+    }
+
+    /* Closes the sockets still connecting */
+    static void cancel(Attempt_t& attempt) {
+        for (size_t i = 0; i < attempt.pending; ++i) {
+            ::close(attempt.fds[i].fd);
+        }
+        attempt.pending = 0;
+        attempt.started = attempt.count;
+    }
+
+    static void invalidate(const char* host) {
+        pthread_mutex_lock(ERaConnectLinux::mutex());
+        DnsEntry_t* entry = ERaConnectLinux::find(host);
+        if (entry != nullptr) {
+            entry->count = 0;
+        }
+        pthread_mutex_unlock(ERaConnectLinux::mutex());
+    }
+
+protected:
+private:
+    static DnsEntry_t* cache() {
+        static DnsEntry_t entries[ERA_DNS_CACHE_SIZE] {};
+        return entries;
+    }
+
+    static pthread_mutex_t* mutex() {
+        static pthread_mutex_t _mutex = PTHREAD_MUTEX_INITIALIZER;
+        return &_mutex;
+    }
+
+    static DnsEntry_t* find(const char* host) {
+        DnsEntry_t* entries = ERaConnectLinux::cache();
+        for (size_t i = 0; i < ERA_DNS_CACHE_SIZE; ++i) {
+            if (entries[i].count && !strcmp(entries[i].host, host)) {
+                return &entries[i];
+            }
+        }
+        return nullptr;
+    }
+
+    /* Slot to reuse, an empty one or else the oldest */
+    static DnsEntry_t* reserve() {
+        DnsEntry_t* entries = ERaConnectLinux::cache();
+        DnsEntry_t* oldest = &entries[0];
+        MillisTime_t now = ERaMillis();
+        for (size_t i = 0; i < ERA_DNS_CACHE_SIZE; ++i) {
+            if (!entries[i].count) {
+                return &entries[i];
+            }
+            if ((MillisTime_t)(now - entries[i].resolvedMillis) >
+                (MillisTime_t)(now - oldest->resolvedMillis)) {
+                oldest = &entries[i];
+            }
+        }
+        return oldest;
+    }
+
+    static size_t resolve(const char* host, Address_t* addresses) {
+        size_t count {0};
+        if ((host == nullptr) ||
+            (strlen(host) >= ERA_DNS_MAX_HOST)) {
+            return ERaConnectLinux::lookup(host, addresses);
+        }
+
+        pthread_mutex_lock(ERaConnectLinux::mutex());
+        DnsEntry_t* entry = ERaConnectLinux::find(host);
+        if ((entry != nullptr) &&
+            ((MillisTime_t)(ERaMillis() - entry->resolvedMillis) < ERA_DNS_CACHE_TTL)) {
+            count = entry->count;
+            memcpy(addresses, entry->addresses, count * sizeof(Address_t));
+        }
+        pthread_mutex_unlock(ERaConnectLinux::mutex());
+        if (count) {
+            return count;
+        }
+
+        /* Resolve outside the lock, it may take seconds */
+        count = ERaConnectLinux::lookup(host, addresses);
+        if (!count) {
+            return 0;
+        }
+
+        pthread_mutex_lock(ERaConnectLinux::mutex());
+        entry = ERaConnectLinux::find(host);
+        if (entry == nullptr) {
+            entry = ERaConnectLinux::reserve();
+        }
+        snprintf(entry->host, sizeof(entry->host), "%s", host);
+        memcpy(entry->addresses, addresses, count * sizeof(Address_t));
+        entry->count = count;
+        entry->resolvedMillis = ERaMillis();
+        pthread_mutex_unlock(ERaConnectLinux::mutex());
+        return count;
+    }
+
+    /* Candidates alternate between families, IPv6 first */
+    static size_t lookup(const char* host, Address_t* addresses) {
+        if (host == nullptr) {
+            return 0;
+        }
+
+        struct addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = PF_UNSPEC;
+        hints.ai_flags = AI_ADDRCONFIG;
+        hints.ai_socktype = SOCK_STREAM;
+
+        struct addrinfo* result = NULL;
+        if (getaddrinfo(host, NULL, &hints, &result) != 0) {
+            return 0;
+        }
+
+        size_t count {0};
+        const struct addrinfo* next6 = result;
+        const struct addrinfo* next4 = result;
+        bool v6 {true};
+        while (count < ERA_DNS_MAX_ADDRESSES) {
+            const struct addrinfo*& next = (v6 ? next6 : next4);
+            int family = (v6 ? AF_INET6 : AF_INET);
+            while ((next != NULL) && (next->ai_family != family)) {
+                next = next->ai_next;
+            }
+            if (next != NULL) {
+                if (next->ai_addrlen <= sizeof(addresses[count].addr)) {
+                    memcpy(&addresses[count].addr, next->ai_addr, next->ai_addrlen);
+                    addresses[count++].len = next->ai_addrlen;
+                }
+                next = next->ai_next;
+            }
+            else if ((next6 == NULL) && (next4 == NULL)) {
+                break;
+            }
+            v6 = !v6;
+        }
+
+        freeaddrinfo(result);
+        return count;
+    }
+
+    static void setPort(Address_t& address, uint16_t port) {
+        if (address.addr.ss_family == AF_INET6) {
+            ((struct sockaddr_in6*)&address.addr)->sin6_port = htons(port);
+        }
+        else {
+            ((struct sockaddr_in*)&address.addr)->sin_port = htons(port);
+        }
+    }
+
+    static int start(const Address_t& address) {
+        int fd = ::socket(address.addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            return -1;
+        }
+        if ((::connect(fd, (const struct sockaddr*)&address.addr, address.len) < 0) &&
+            (errno != EINPROGRESS)) {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    static int wait(Attempt_t& attempt) {
+        int fd {ERA_CONNECT_PENDING};
+        do {
+            fd = ERaConnectLinux::poll(attempt, attempt.timeout);
+        } while (fd == ERA_CONNECT_PENDING);
+        return fd;
+    }
+
+    static void reset(Attempt_t& attempt, size_t count, uint32_t timeout) {
+        attempt.count = count;
+        attempt.started = 0;
+        attempt.pending = 0;
+        attempt.startMillis = ERaMillis();
+        attempt.attemptMillis = attempt.startMillis;
+        attempt.timeout = timeout;
+        attempt.host[0] = 0;
+    }
+};
+
+#endif /* INC_ERA_CONNECT_LINUX_HPP_ */
@@ -0,0 +1,483 @@
+#ifndef INC_ERA_JOURNAL_LINUX_HPP_
+#define INC_ERA_JOURNAL_LINUX_HPP_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <ERa/ERaConfig.hpp>
+#include <ERa/ERaDefine.hpp>
+#include <ERa/ERaDebug.hpp>
+
+#if !defined(FILENAME_MQTT_JOURNAL)
+    #define FILENAME_MQTT_JOURNAL       "database/journal"
+#endif
+
+#if !defined(ERA_JOURNAL_SEGMENT_SIZE)
+    #define ERA_JOURNAL_SEGMENT_SIZE    (64UL * 1024UL)
+#endif
+
+/* Oldest segments are dropped once the journal grows past this */
+#if !defined(ERA_JOURNAL_MAX_SIZE)
+    #define ERA_JOURNAL_MAX_SIZE        (4UL * 1024UL * 1024UL)
+#endif
+
+/* Replay pace after a reconnect, records per batch and
+   the delay between batches, so live data keeps flowing */
+#if !defined(ERA_JOURNAL_DRAIN_BATCH)
+    #define ERA_JOURNAL_DRAIN_BATCH     10
+#endif
+
+#if !defined(ERA_JOURNAL_DRAIN_INTERVAL)
+    #define ERA_JOURNAL_DRAIN_INTERVAL  100
+#endif
+
+/* Records older than this (seconds) are dropped on replay, 0 keeps all */
+#if !defined(ERA_JOURNAL_MAX_AGE)
+    #define ERA_JOURNAL_MAX_AGE         0
+#endif
+
+/* Retained topics published live while older records are queued,
+   such records are dropped instead of overwriting the live value */
+#if !defined(ERA_JOURNAL_LIVE_TOPICS)
+    #define ERA_JOURNAL_LIVE_TOPICS     32
+#endif
+
+#define ERA_JOURNAL_MAGIC               0x4A524145UL
+
+typedef struct __ERaJournalRecord_t {
+    uint32_t timestamp;
+    bool retained;
+    const char* topic;
+    const char* payload;
+} ERaJournalRecord_t;
+
+/* Append-only outbound journal, one file per segment named by its
+   sequence number. A record is a fixed header followed by the topic
+   and payload, the CRC covers all of it so a record torn by a power
+   loss ends the segment instead of being replayed */
+class ERaJournalLinux
+{
+    typedef struct __Header_t {
+        uint32_t magic;
+        uint32_t timestamp;
+        uint32_t topicLen;
+        uint32_t payloadLen;
+        uint32_t retained;
+        uint32_t crc;
+    } Header_t;
+
+    typedef struct __Live_t {
+        uint32_t seq;
+        long offset;
+        char topic[MAX_TOPIC_LENGTH];
+    } Live_t;
+
+    const char* TAG = "Journal";
+
+public:
+    ERaJournalLinux()
+        : file(nullptr)
+        , firstSeq(0)
+        , lastSeq(0)
+        , readOffset(0)
+        , totalSize(0)
+        , writeSize(0)
+        , record()
+        , recordSeq(0)
+        , recordOffset(0)
+        , buffer(nullptr)
+        , loaded(false)
+        , started(false)
+        , live()
+        , numLive(0)
+    {}
+    ~ERaJournalLinux()
+    {
+        this->closeWrite();
+        ERA_FREE(this->buffer);
+    }
+
+    void begin();
+    bool append(const char* topic, const char* payload, bool retained);
+    /* Oldest record, valid until pop() */
+    const ERaJournalRecord_t* front();
+    void pop();
+    /* A retained value of topic went out live, older records of it are stale */
+    void supersede(const char* topic);
+    bool isSuperseded() const;
+
+    bool isEmpty() {
+        this->begin();
+        return ((this->firstSeq == this->lastSeq) && (this->readOffset >= this->writeSize));
+    }
+
+    size_t size() const {
+        return this->totalSize;
+    }
+
+protected:
+private:
+    void segmentName(char* name, size_t len, uint32_t seq);
+    bool openWrite();
+    void closeWrite();
+    void nextSegment();
+    void dropSegment();
+    void resetSegment();
+    long segmentSize(uint32_t seq);
+    static uint32_t crc32(uint32_t crc, const void* data, size_t len);
+    static uint32_t headerCrc(const Header_t& header, const char* data);
+
+    FILE* file;
+    uint32_t firstSeq;
+    uint32_t lastSeq;
+    long readOffset;
+    size_t totalSize;
+    long writeSize;
+    ERaJournalRecord_t record;
+    uint32_t recordSeq;
+    long recordOffset;
+    char* buffer;
+    bool loaded;
+    bool started;
+    Live_t live[ERA_JOURNAL_LIVE_TOPICS];
+    size_t numLive;
+};
+
+/* Pick up segments left by a previous run */
+inline
+void ERaJournalLinux::begin() {
+    if (this->started) {
+        return;
+    }
+    this->started = true;
+
+    char dir[256] {0};
+    snprintf(dir, sizeof(dir), "%s", FILENAME_MQTT_JOURNAL);
+    for (char* p = dir + 1; *p; ++p) {
+        if (*p == '/') {
+            *p = 0;
+            ::mkdir(dir, 0755);
+            *p = '/';
+        }
+    }
+    ::mkdir(dir, 0755);
+
+    bool found {false};
+    DIR* _dir = opendir(FILENAME_MQTT_JOURNAL);
+    if (_dir != nullptr) {
+        struct dirent* entry = nullptr;
+        while ((entry = readdir(_dir)) != nullptr) {
+            char* end = nullptr;
+            unsigned long seq = strtoul(entry->d_name, &end, 10);
+            if ((end == entry->d_name) || strcmp(end, ".log")) {
+                continue;
+            }
+            if (!found || ((uint32_t)seq < this->firstSeq)) {
+                this->firstSeq = (uint32_t)seq;
+            }
+            if (!found || ((uint32_t)seq > this->lastSeq)) {
+                this->lastSeq = (uint32_t)seq;
+            }
+            found = true;
+        }
+        closedir(_dir);
+    }
+
+    for (uint32_t seq = this->firstSeq; found && (seq <= this->lastSeq); ++seq) {
+        long size = this->segmentSize(seq);
+        if (size > 0) {
+            this->totalSize += (size_t)size;
+        }
+    }
+    this->writeSize = this->segmentSize(this->lastSeq);
+    if (this->writeSize < 0) {
+        this->writeSize = 0;
+    }
+    if (found) {
+        ERA_LOG(TAG, ERA_PSTR("Resume %d segment(s), %d bytes"), (int)(this->lastSeq - this->firstSeq + 1),
+                                                                  (int)this->totalSize);
+    }
+}
+
+inline
+bool ERaJournalLinux::append(const char* topic, const char* payload, bool retained) {
+    if ((topic == nullptr) || (payload == nullptr)) {
+        return false;
+    }
+    this->begin();
+
+    Header_t header {};
+    header.magic = ERA_JOURNAL_MAGIC;
+    header.timestamp = (uint32_t)time(nullptr);
+    header.topicLen = (uint32_t)strlen(topic);
+    header.payloadLen = (uint32_t)strlen(payload);
+    header.retained = retained;
+    header.crc = ERaJournalLinux::crc32(0, &header, offsetof(Header_t, crc));
+    header.crc = ERaJournalLinux::crc32(header.crc, topic, header.topicLen);
+    header.crc = ERaJournalLinux::crc32(header.crc, payload, header.payloadLen);
+
+    size_t length = sizeof(header) + header.topicLen + header.payloadLen;
+    if (length > ERA_JOURNAL_SEGMENT_SIZE) {
+        return false;
+    }
+    if ((this->writeSize > 0) &&
+        ((size_t)this->writeSize + length > ERA_JOURNAL_SEGMENT_SIZE)) {
+        this->nextSegment();
+    }
+    while ((this->totalSize + length > ERA_JOURNAL_MAX_SIZE) &&
+           (this->firstSeq != this->lastSeq)) {
+        this->dropSegment();
+    }
+    if (!this->openWrite()) {
+        return false;
+    }
+
+    bool status = ((fwrite(&header, sizeof(header), 1, this->file) == 1) &&
+                   (fwrite(topic, 1, header.topicLen, this->file) == header.topicLen) &&
+                   (fwrite(payload, 1, header.payloadLen, this->file) == header.payloadLen));
+    fflush(this->file);
+    this->writeSize = ftell(this->file);
+    this->totalSize += length;
+    return status;
+}
+
+inline
+const ERaJournalRecord_t* ERaJournalLinux::front() {
+    if (this->loaded) {
+        return &this->record;
+    }
+
+    while (!this->isEmpty()) {
+        if (this->readOffset >= this->segmentSize(this->firstSeq)) {
+            if (this->firstSeq == this->lastSeq) {
+                return nullptr;
+            }
+            this->dropSegment();
+            continue;
+        }
+
+        char name[256] {0};
+        this->segmentName(name, sizeof(name), this->firstSeq);
+        FILE* _file = fopen(name, "rb");
+        if (_file == nullptr) {
+            if (this->firstSeq == this->lastSeq) {
+                this->resetSegment();
+                return nullptr;
+            }
+            this->dropSegment();
+            continue;
+        }
+
+        Header_t header {};
+        bool valid {false};
+        fseek(_file, this->readOffset, SEEK_SET);
+        if ((fread(&header, sizeof(header), 1, _file) == 1) &&
+            (header.magic == ERA_JOURNAL_MAGIC) &&
+            (header.topicLen + header.payloadLen <= ERA_JOURNAL_SEGMENT_SIZE)) {
+            ERA_FREE(this->buffer);
+            this->buffer = (char*)ERA_MALLOC(header.topicLen + header.payloadLen + 2);
+            if (this->buffer != nullptr) {
+                char* data = this->buffer;
+                valid = ((fread(data, 1, header.topicLen, _file) == header.topicLen) &&
+                        (fread(data + header.topicLen + 1, 1, header.payloadLen, _file) == header.payloadLen));
+                data[header.topicLen] = '\0';
+                data[header.topicLen + 1 + header.payloadLen] = '\0';
+                valid = (valid && (ERaJournalLinux::headerCrc(header, data) == header.crc));
+            }
+        }
+        fclose(_file);
+
+        if (!valid) {
+            /* Torn or corrupt, the rest of the segment is unreadable */
+            ERA_LOG(TAG, ERA_PSTR("Bad record in segment %u"), (unsigned int)this->firstSeq);
+            if (this->firstSeq == this->lastSeq) {
+                this->resetSegment();
+                return nullptr;
+            }
+            this->dropSegment();
+            continue;
+        }
+
+        this->recordSeq = this->firstSeq;
+        this->recordOffset = this->readOffset;
+        this->record.timestamp = header.timestamp;
+        this->record.retained = !!header.retained;
+        this->record.topic = this->buffer;
+        this->record.payload = this->buffer + header.topicLen + 1;
+        this->readOffset += (long)(sizeof(header) + header.topicLen + header.payloadLen);
+        this->loaded = true;
+        return &this->record;
+    }
+    return nullptr;
+}
+
+inline
+void ERaJournalLinux::pop() {
+    if (!this->loaded) {
+        return;
+    }
+    this->loaded = false;
+    if (this->readOffset < this->segmentSize(this->firstSeq)) {
+        return;
+    }
+    if (this->firstSeq != this->lastSeq) {
+        this->dropSegment();
+        return;
+    }
+    /* Fully drained, start over with an empty segment */
+    this->resetSegment();
+}
+
+/* Marks the write position, records before it are older.
+   When the table is full the oldest mark is replaced */
+inline
+void ERaJournalLinux::supersede(const char* topic) {
+    if ((topic == nullptr) ||
+        (strlen(topic) >= MAX_TOPIC_LENGTH) ||
+        this->isEmpty()) {
+        return;
+    }
+    size_t index {0};
+    for (index = 0; index < this->numLive; ++index) {
+        if (!strcmp(this->live[index].topic, topic)) {
+            break;
+        }
+    }
+    if (index == this->numLive) {
+        if (this->numLive < ERA_JOURNAL_LIVE_TOPICS) {
+            this->numLive++;
+        }
+        else {
+            index = 0;
+            for (size_t i = 1; i < this->numLive; ++i) {
+                if ((this->live[i].seq < this->live[index].seq) ||
+                    ((this->live[i].seq == this->live[index].seq) &&
+                     (this->live[i].offset < this->live[index].offset))) {
+                    index = i;
+                }
+            }
+        }
+        snprintf(this->live[index].topic, sizeof(this->live[index].topic), "%s", topic);
+    }
+    this->live[index].seq = this->lastSeq;
+    this->live[index].offset = this->writeSize;
+}
+
+inline
+bool ERaJournalLinux::isSuperseded() const {
+    if (!this->loaded || !this->record.retained) {
+        return false;
+    }
+    for (size_t i = 0; i < this->numLive; ++i) {
+        const Live_t& entry = this->live[i];
+        if (strcmp(entry.topic, this->record.topic)) {
+            continue;
+        }
+        return ((this->recordSeq < entry.seq) ||
+                ((this->recordSeq == entry.seq) && (this->recordOffset < entry.offset)));
+    }
+    return false;
+}
+
+inline
+void ERaJournalLinux::segmentName(char* name, size_t len, uint32_t seq) {
+    snprintf(name, len, "%s/%08u.log", FILENAME_MQTT_JOURNAL, (unsigned int)seq);
+}
+
+inline
+bool ERaJournalLinux::openWrite() {
+    if (this->file != nullptr) {
+        return true;
+    }
+    char name[256] {0};
+    this->segmentName(name, sizeof(name), this->lastSeq);
+    this->file = fopen(name, "ab");
+    return (this->file != nullptr);
+}
+
+inline
+void ERaJournalLinux::closeWrite() {
+    if (this->file == nullptr) {
+        return;
+    }
+    fclose(this->file);
+    this->file = nullptr;
+}
+
+inline
+void ERaJournalLinux::nextSegment() {
+    this->closeWrite();
+    this->lastSeq++;
+    this->writeSize = 0;
+}
+
+inline
+void ERaJournalLinux::dropSegment() {
+    char name[256] {0};
+    long size = this->segmentSize(this->firstSeq);
+    if (this->firstSeq == this->lastSeq) {
+        return;
+    }
+    if (size > 0) {
+        this->totalSize -= (((size_t)size < this->totalSize) ? (size_t)size : this->totalSize);
+    }
+    this->segmentName(name, sizeof(name), this->firstSeq);
+    remove(name);
+    this->loaded = false;
+    this->firstSeq++;
+    this->readOffset = 0;
+}
+
+/* Remove the only segment, the one being written */
+inline
+void ERaJournalLinux::resetSegment() {
+    char name[256] {0};
+    this->closeWrite();
+    this->segmentName(name, sizeof(name), this->lastSeq);
+    remove(name);
+    this->loaded = false;
+    this->readOffset = 0;
+    this->writeSize = 0;
+    this->totalSize = 0;
+    /* Positions restart, the marks would match new records */
+    this->numLive = 0;
+}
+
+inline
+long ERaJournalLinux::segmentSize(uint32_t seq) {
+    char name[256] {0};
+    struct stat st {};
+    this->segmentName(name, sizeof(name), seq);
+    if (stat(name, &st) != 0) {
+        return -1;
+    }
+    return (long)st.st_size;
+}
+
+inline
+uint32_t ERaJournalLinux::crc32(uint32_t crc, const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        for (int i = 0; i < 8; ++i) {
+            crc = ((crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1))));
+        }
+    }
+    return ~crc;
+}
+
+inline
+uint32_t ERaJournalLinux::headerCrc(const Header_t& header, const char* data) {
+    uint32_t crc = ERaJournalLinux::crc32(0, &header, offsetof(Header_t, crc));
+    crc = ERaJournalLinux::crc32(crc, data, header.topicLen);
+    return ERaJournalLinux::crc32(crc, data + header.topicLen + 1, header.payloadLen);
+}
+
+#endif /* INC_ERA_JOURNAL_LINUX_HPP_ */
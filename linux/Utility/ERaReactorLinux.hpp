@@ -0,0 +1,131 @@
+#ifndef INC_ERA_REACTOR_LINUX_HPP_
+#define INC_ERA_REACTOR_LINUX_HPP_
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <stdint.h>
+#include <limits.h>
+#include <unistd.h>
+#include <errno.h>
+#include <ERa/ERaDefine.hpp>
+#include <Utility/ERaUtility.hpp>
+
+#if !defined(ERA_REACTOR_MAX_EVENTS)
+    #define ERA_REACTOR_MAX_EVENTS      8
+#endif
+
+/* epoll set plus an eventfd so another thread can cut a wait short.
+   wait() sleeps in the kernel until a registered fd is ready,
+   wakeup() is called or the timeout (the next deadline) expires. */
+class ERaReactorLinux
+{
+public:
+    ERaReactorLinux()
+        : epollFd(-1)
+        , wakeFd(-1)
+        , events()
+        , numEvents(0)
+    {
+        this->epollFd = epoll_create1(EPOLL_CLOEXEC);
+        this->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        this->add(this->wakeFd);
+    }
+    ~ERaReactorLinux()
+    {
+        if (this->wakeFd >= 0) {
+            ::close(this->wakeFd);
+        }
+        if (this->epollFd >= 0) {
+            ::close(this->epollFd);
+        }
+    }
+
+    bool isValid() const {
+        return (this->epollFd >= 0);
+    }
+
+    bool add(int fd, uint32_t flags = EPOLLIN) {
+        return this->control(EPOLL_CTL_ADD, fd, flags);
+    }
+
+    bool modify(int fd, uint32_t flags) {
+        return this->control(EPOLL_CTL_MOD, fd, flags);
+    }
+
+    void remove(int fd) {
+        if ((fd < 0) || !this->isValid()) {
+            return;
+        }
+        epoll_ctl(this->epollFd, EPOLL_CTL_DEL, fd, NULL);
+    }
+
+    /* Returns the number of ready fds, 0 on timeout or wakeup, -1 on error */
+    int wait(MillisTime_t timeout) {
+        this->numEvents = 0;
+        if (!this->isValid()) {
+            ERaDelay(timeout);
+            return -1;
+        }
+        int ms = ((timeout > (MillisTime_t)INT_MAX) ? INT_MAX : (int)timeout);
+        int rc = epoll_wait(this->epollFd, this->events, ERA_REACTOR_MAX_EVENTS, ms);
+        if (rc < 0) {
+            return ((errno == EINTR) ? 0 : -1);
+        }
+        int ready {0};
+        for (int i = 0; i < rc; ++i) {
+            if (this->events[i].data.fd == this->wakeFd) {
+                this->clearWakeup();
+                continue;
+            }
+            this->events[ready++] = this->events[i];
+        }
+        this->numEvents = ready;
+        return ready;
+    }
+
+    /* Result of the last wait() */
+    bool isReady(int fd, uint32_t flags = EPOLLIN) const {
+        for (int i = 0; i < this->numEvents; ++i) {
+            if (this->events[i].data.fd != fd) {
+                continue;
+            }
+            return ((this->events[i].events & (flags | EPOLLERR | EPOLLHUP)) != 0);
+        }
+        return false;
+    }
+
+    void wakeup() {
+        if (this->wakeFd < 0) {
+            return;
+        }
+        uint64_t value {1};
+        ssize_t rc = ::write(this->wakeFd, &value, sizeof(value));
+        ERA_FORCE_UNUSED(rc);
+    }
+
+protected:
+private:
+    bool control(int op, int fd, uint32_t flags) {
+        if ((fd < 0) || !this->isValid()) {
+            return false;
+        }
+        struct epoll_event event;
+        event.events = flags;
+        event.data.u64 = 0;
+        event.data.fd = fd;
+        return (epoll_ctl(this->epollFd, op, fd, &event) == 0);
+    }
+
+    void clearWakeup() {
+        uint64_t value {0};
+        ssize_t rc = ::read(this->wakeFd, &value, sizeof(value));
+        ERA_FORCE_UNUSED(rc);
+    }
+
+    int epollFd;
+    int wakeFd;
+    struct epoll_event events[ERA_REACTOR_MAX_EVENTS];
+    int numEvents;
+};
+
+#endif /* INC_ERA_REACTOR_LINUX_HPP_ */
@@ -7,14 +7,38 @@
     #include "Compat/SerialLinux.hpp"
 #endif
 
+#include <poll.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+#include <linux/serial.h>
 #include "Compat/Stream.hpp"
 
+#if !defined(ERA_SERIAL_RX_BUFFER_SIZE)
+    #define ERA_SERIAL_RX_BUFFER_SIZE   256
+#endif
+
+/* Longest write() waits for room in the kernel buffer */
+#if !defined(ERA_SERIAL_WRITE_TIMEOUT)
+    #define ERA_SERIAL_WRITE_TIMEOUT    1000
+#endif
+
+/* Non-blocking tty read in chunks into a local buffer, so
+   available() and read() cost one syscall per chunk, not per byte */
 class ERaSerialLinux
     : public Stream
 {
 public:
     ERaSerialLinux()
         : fd(-1)
+        , rs485(false)
+        , rs485Active(false)
+        , rs485Before(0)
+        , rs485After(0)
+        , rxBuffer()
+        , rxHead(0)
+        , rxTail(0)
     {}
     ~ERaSerialLinux()
     {}
@@ -22,6 +46,13 @@ public:
     void begin(const char *device, const int baud) {
         this->end();
         this->fd = serialOpen(device, baud);
+        if (!this->connected()) {
+            return;
+        }
+        this->configure();
+        if (this->rs485) {
+            this->applyRS485();
+        }
     }
 
     void end() {
@@ -30,24 +61,59 @@ public:
         }
         this->flush();
         serialClose(this->fd);
+        this->fd = -1;
+        this->rs485Active = false;
+        this->rxHead = 0;
+        this->rxTail = 0;
     }
 
     int available() override {
         if (!this->connected()) {
             return 0;
         }
-        return serialDataAvail(this->fd);
+        if (this->rxHead == this->rxTail) {
+            this->fill();
+        }
+        return (int)(this->rxTail - this->rxHead);
     }
 
     int read() override {
-        if (!this->connected()) {
+        if (this->available() <= 0) {
             return -1;
         }
-        return serialGetchar(this->fd);
+        return this->rxBuffer[this->rxHead++];
     }
 
     int peek() override {
-        return -1;
+        if (this->available() <= 0) {
+            return -1;
+        }
+        return this->rxBuffer[this->rxHead];
+    }
+
+    /* Buffered bytes first, then straight from the tty
+       into the caller's buffer */
+    size_t readAvailable(uint8_t* buffer, size_t size) override {
+        if (!this->connected()) {
+            return 0;
+        }
+        size_t count = (this->rxTail - this->rxHead);
+        if (count > size) {
+            count = size;
+        }
+        memcpy(buffer, this->rxBuffer + this->rxHead, count);
+        this->rxHead += count;
+        if (count == size) {
+            return count;
+        }
+        ssize_t rc {0};
+        do {
+            rc = ::read(this->fd, buffer + count, size - count);
+        } while ((rc < 0) && (errno == EINTR));
+        if (rc > 0) {
+            count += (size_t)rc;
+        }
+        return count;
     }
 
     size_t write(uint8_t value) override {
@@ -58,17 +124,82 @@ public:
         if (!this->connected()) {
             return 0;
         }
-        for (size_t i = 0; i < size; ++i) {
-            serialPutchar(this->fd, buffer[i]);
+        size_t written {0};
+        while (written < size) {
+            ssize_t rc = ::write(this->fd, buffer + written, size - written);
+            if (rc > 0) {
+                written += (size_t)rc;
+                continue;
+            }
+            if ((rc < 0) && (errno == EINTR)) {
+                continue;
+            }
+            if ((rc < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                break;
+            }
+            if (!this->waitWritable(ERA_SERIAL_WRITE_TIMEOUT)) {
+                break;
+            }
         }
-        return size;
+        return written;
     }
 
+    /* Wait until the last byte has left the transmitter */
     void flush() override {
         if (!this->connected()) {
             return;
         }
-        serialFlush(this->fd);
+        tcdrain(this->fd);
+    }
+
+    /* Drop stale bytes, both buffered and still in the kernel */
+    void discardInput() {
+        this->rxHead = 0;
+        this->rxTail = 0;
+        if (!this->connected()) {
+            return;
+        }
+        tcflush(this->fd, TCIFLUSH);
+    }
+
+    bool waitAvailable(unsigned long timeout) override {
+        if (!this->connected()) {
+            ::poll(NULL, 0, (int)timeout);
+            return false;
+        }
+        if (this->available() > 0) {
+            return true;
+        }
+        struct pollfd pfd;
+        pfd.fd = this->fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        int rc = ::poll(&pfd, 1, (int)timeout);
+        if ((rc < 0) && (errno != EINTR)) {
+            return false;
+        }
+        return (rc > 0);
+    }
+
+    /* Let the kernel drive the transceiver enable from RTS
+       (TIOCSRS485), delays in ms around each transmission.
+       Kept across begin(), false if the driver refuses it */
+    bool setRS485(bool enable, uint32_t delayBefore = 0, uint32_t delayAfter = 0) {
+        this->rs485 = enable;
+        this->rs485Before = delayBefore;
+        this->rs485After = delayAfter;
+        if (!this->connected()) {
+            return false;
+        }
+        return this->applyRS485();
+    }
+
+    bool isRS485() const {
+        return this->rs485Active;
+    }
+
+    int getFd() const {
+        return this->fd;
     }
 
 private:
@@ -76,7 +207,72 @@ private:
         return (this->fd >= 0);
     }
 
+    /* Return from read() at once with whatever is there,
+       waits go through poll() */
+    void configure() {
+        struct termios options;
+        if (tcgetattr(this->fd, &options) == 0) {
+            options.c_cc[VMIN] = 0;
+            options.c_cc[VTIME] = 0;
+            tcsetattr(this->fd, TCSANOW, &options);
+        }
+        int flags = fcntl(this->fd, F_GETFL);
+        if (flags >= 0) {
+            fcntl(this->fd, F_SETFL, flags | O_NONBLOCK);
+        }
+    }
+
+    bool applyRS485() {
+#if defined(TIOCSRS485)
+        struct serial_rs485 config;
+        memset(&config, 0, sizeof(config));
+        if (this->rs485) {
+            config.flags = (SER_RS485_ENABLED | SER_RS485_RTS_ON_SEND);
+            config.delay_rts_before_send = this->rs485Before;
+            config.delay_rts_after_send = this->rs485After;
+        }
+        bool status = (ioctl(this->fd, TIOCSRS485, &config) == 0);
+        this->rs485Active = (status && this->rs485);
+        return status;
+#else
+        this->rs485Active = false;
+        return false;
+#endif
+    }
+
+    void fill() {
+        this->rxHead = 0;
+        this->rxTail = 0;
+        ssize_t rc {0};
+        do {
+            rc = ::read(this->fd, this->rxBuffer, sizeof(this->rxBuffer));
+        } while ((rc < 0) && (errno == EINTR));
+        if (rc <= 0) {
+            return;
+        }
+        this->rxTail = (size_t)rc;
+    }
+
+    bool waitWritable(unsigned long timeout) {
+        struct pollfd pfd;
+        pfd.fd = this->fd;
+        pfd.events = POLLOUT;
+        pfd.revents = 0;
+        int rc = ::poll(&pfd, 1, (int)timeout);
+        if (rc < 0) {
+            return (errno == EINTR);
+        }
+        return (rc > 0);
+    }
+
     int fd;
+    bool rs485;
+    bool rs485Active;
+    uint32_t rs485Before;
+    uint32_t rs485After;
+    uint8_t rxBuffer[ERA_SERIAL_RX_BUFFER_SIZE];
+    size_t rxHead;
+    size_t rxTail;
 };
 
 #endif /* INC_ERA_SERIAL_LINUX_HPP_ */
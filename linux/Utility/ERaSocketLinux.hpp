@@ -4,6 +4,7 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <poll.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <netdb.h>
@@ -14,6 +15,7 @@
 #include <errno.h>
 #include <arpa/inet.h>
 #include "Compat/Client.hpp"
+#include "ERaConnectLinux.hpp"
 
 class ERaSocketLinux
     : public Client
@@ -34,30 +36,17 @@ public:
 
         // populate address struct
         uint32_t ip_addr = ip;
-        struct sockaddr_in address;
+        struct sockaddr_in address {};
         address.sin_port = htons(port);
         address.sin_family = AF_INET;
         memcpy((void*)&address.sin_addr.s_addr, (const void*)(&ip_addr), 4);
 
-        // create new socket
-        this->fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        // connect with a deadline instead of the kernel SYN timeout
+        this->fd = ERaConnectLinux::connect((struct sockaddr*)&address, sizeof(address), this->timeout);
         if (this->fd < 0) {
             return 0;
         }
 
-        // connect socket
-        int rc = ::connect(this->fd, (struct sockaddr*)&address, sizeof(address));
-        if (rc < 0) {
-            this->stop();
-            return 0;
-        }
-
-        rc = this->selectWrite(this->timeout);
-        if (rc <= 0) {
-            this->stop();
-            return 0;
-        }
-
         this->_connected = true;
         return 1;
     }
@@ -65,69 +54,12 @@ public:
     int connect(const char* host, uint16_t port) override {
         this->disconnect();
 
-        // prepare resolver hints
-        struct addrinfo hints;
-        memset(&hints, 0, sizeof(hints));
-        hints.ai_family = PF_UNSPEC;
-        hints.ai_flags = AI_ADDRCONFIG;
-        hints.ai_socktype = SOCK_STREAM;
-
-        // resolve address
-        struct addrinfo* result = NULL;
-        int rc = getaddrinfo(host, NULL, &hints, &result);
-        if (rc < 0) {
-            return 0;
-        }
-
-        // prepare selected result
-        struct addrinfo* current = result;
-        struct addrinfo* selected = NULL;
-
-        // traverse list and select first found ipv4 address
-        while (current) {
-            // check if ipv4 address
-            if (current->ai_family == AF_INET) {
-                selected = current;
-                break;
-            }
-
-            // move one to next
-            current = current->ai_next;
-        }
-
-        // return error if none found
-        if (selected == NULL) {
-            return 0;
-        }
-
-        // populate address struct
-        struct sockaddr_in address;
-        address.sin_port = htons(port);
-        address.sin_family = AF_INET;
-        address.sin_addr = ((struct sockaddr_in*)(selected->ai_addr))->sin_addr;
-
-        // free result
-        freeaddrinfo(result);
-
-        // create new socket
-        this->fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        // resolve through the cache and race the candidate addresses
+        this->fd = ERaConnectLinux::connect(host, port, this->timeout);
         if (this->fd < 0) {
             return 0;
         }
 
-        // connect socket
-        rc = ::connect(this->fd, (struct sockaddr*)&address, sizeof(address));
-        if (rc < 0) {
-            this->stop();
-            return 0;
-        }
-
-        rc = this->selectWrite(this->timeout);
-        if (rc <= 0) {
-            this->stop();
-            return 0;
-        }
-
         this->_connected = true;
         return 1;
     }
@@ -145,47 +77,27 @@ public:
     }
 
     int selectWrite(unsigned long _timeout) {
-        // prepare set
-        fd_set set;
-        fd_set ex_set;
-        FD_ZERO(&set);
-        FD_ZERO(&ex_set);
-        FD_SET(this->fd, &set);
-        FD_SET(this->fd, &ex_set);
-
-        // wait ready for writing
-        struct timeval t = {
-            .tv_sec = _timeout / 1000,
-            .tv_usec = (_timeout % 1000) * 1000
-        };
-        int result = ::select(this->fd + 1, NULL, &set, &ex_set, &t);
-        if ((result < 0) || FD_ISSET(this->fd, &ex_set)) {
-            return -1;
-        }
-
-        return result;
+        return this->pollSocket(POLLOUT, _timeout);
     }
 
     int selectRead(unsigned long _timeout) {
-        // prepare set
-        fd_set set;
-        fd_set ex_set;
-        FD_ZERO(&set);
-        FD_ZERO(&ex_set);
-        FD_SET(this->fd, &set);
-        FD_SET(this->fd, &ex_set);
-
-        // wait for data
-        struct timeval t = {
-            .tv_sec = _timeout / 1000,
-            .tv_usec = (_timeout % 1000) * 1000
-        };
-        int result = ::select(this->fd + 1, &set, NULL, &ex_set, &t);
-        if ((result < 0) || FD_ISSET(this->fd, &ex_set)) {
-            return -1;
+        return this->pollSocket(POLLIN, _timeout);
+    }
+
+    bool waitAvailable(unsigned long _timeout) override {
+        if (this->available() > 0) {
+            return true;
+        }
+        if (!this->_connected ||
+            (this->fd < 0)) {
+            ::poll(NULL, 0, (int)_timeout);
+            return false;
         }
+        return (this->selectRead(_timeout) > 0);
+    }
 
-        return result;
+    int getFd() const {
+        return this->fd;
     }
 
     size_t write(uint8_t value) override {
@@ -238,9 +150,6 @@ public:
 
         int count {0};
         if (ioctl(this->fd, FIONREAD, &count) == 0) {
-            if (!count) {
-                usleep(10000);
-            }
             return count;
         }
         this->stop();
@@ -385,6 +294,29 @@ public:
     }
 
 private:
+    /* poll() instead of select(), no FD_SETSIZE limit on the descriptor */
+    int pollSocket(short events, unsigned long _timeout) {
+        if (this->fd < 0) {
+            return -1;
+        }
+        struct pollfd pfd;
+        pfd.fd = this->fd;
+        pfd.events = events;
+        pfd.revents = 0;
+        int result = ::poll(&pfd, 1, (int)_timeout);
+        if ((result < 0) && (errno == EINTR)) {
+            return 0;
+        }
+        if ((result < 0) || (pfd.revents & (POLLERR | POLLNVAL))) {
+            return -1;
+        }
+        if (!(pfd.revents & events) && (pfd.revents & POLLHUP)) {
+            return -1;
+        }
+
+        return result;
+    }
+
     int fd;
     unsigned long timeout;
     bool _connected;
@@ -0,0 +1,392 @@
+#ifndef INC_ERA_STORE_LINUX_HPP_
+#define INC_ERA_STORE_LINUX_HPP_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <ERa/ERaDefine.hpp>
+#include <ERa/ERaDebug.hpp>
+#include <Utility/ERaUtility.hpp>
+
+#define ERA_STORE_MAGIC                 0x53524145UL
+
+/* Records appended past the live ones before the log is rewritten */
+#if !defined(ERA_STORE_COMPACT_SLACK)
+    #define ERA_STORE_COMPACT_SLACK     64
+#endif
+
+#if !defined(ERA_STORE_MAX_RECORD)
+    #define ERA_STORE_MAX_RECORD        (16UL * 1024UL)
+#endif
+
+typedef struct __ERaStoreRecord_t {
+    bool erase;
+    const char* key;
+    const char* value;
+} ERaStoreRecord_t;
+
+/* Append-only key/value log. A put or erase costs one record and
+   one fdatasync, the latest record of a key wins on replay.
+   Each record carries a CRC, a torn tail left by a power loss is
+   cut off at boot. A bad record inside the log is skipped, or ends
+   the replay if its lengths are unusable, and the log is compacted
+   afterwards. Compaction writes the live records to a temporary
+   file and renames it over the log, so either the old or the new
+   log is found after a crash */
+class ERaStoreLinux
+{
+    typedef struct __Header_t {
+        uint32_t magic;
+        uint32_t erase;
+        uint32_t keyLen;
+        uint32_t valueLen;
+        uint32_t crc;
+    } Header_t;
+
+    const char* TAG = "Store";
+
+public:
+    ERaStoreLinux(const char* _filename)
+        : filename(_filename)
+        , fd(-1)
+        , file(nullptr)
+        , readOffset(0)
+        , numRecords(0)
+        , record()
+        , buffer(nullptr)
+        , damaged(false)
+    {}
+    ~ERaStoreLinux()
+    {
+        this->endRead();
+        this->closeLog(this->fd);
+    }
+
+    bool exists() const;
+    /* Replay, each record is valid until the next read */
+    bool beginRead();
+    const ERaStoreRecord_t* read();
+    void endRead();
+
+    bool put(const char* key, const char* value);
+    bool erase(const char* key);
+
+    /* Rewrite with only the live records */
+    bool beginCompact();
+    bool compact(const char* key, const char* value);
+    bool endCompact();
+
+    bool needCompact(size_t live) const {
+        return (this->damaged ||
+                (this->numRecords > ((live * 2) + ERA_STORE_COMPACT_SLACK)));
+    }
+
+    size_t records() const {
+        return this->numRecords;
+    }
+
+protected:
+private:
+    bool append(int _fd, bool _erase, const char* key, const char* value, bool sync);
+    void cutTail();
+    bool openLog();
+    void closeLog(int& _fd);
+    void tempName(char* name, size_t len) const;
+    void syncDir() const;
+    void mkdir() const;
+
+    const char* filename;
+    int fd;
+    FILE* file;
+    long readOffset;
+    size_t numRecords;
+    ERaStoreRecord_t record;
+    char* buffer;
+    bool damaged;
+};
+
+inline
+bool ERaStoreLinux::exists() const {
+    struct stat st {};
+    return (stat(this->filename, &st) == 0);
+}
+
+/* A leftover temporary file is a compaction that never
+   reached its rename, the log itself is still whole */
+inline
+bool ERaStoreLinux::beginRead() {
+    char name[256] {0};
+    this->endRead();
+    this->closeLog(this->fd);
+    this->tempName(name, sizeof(name));
+    remove(name);
+    this->numRecords = 0;
+    this->readOffset = 0;
+    this->damaged = false;
+    this->file = fopen(this->filename, "rb");
+    return (this->file != nullptr);
+}
+
+inline
+const ERaStoreRecord_t* ERaStoreLinux::read() {
+    if (this->file == nullptr) {
+        return nullptr;
+    }
+
+    for (;;) {
+        Header_t header {};
+        if (fread(&header, sizeof(header), 1, this->file) != 1) {
+            this->cutTail();
+            return nullptr;
+        }
+        if ((header.magic != ERA_STORE_MAGIC) ||
+            (header.keyLen + header.valueLen > ERA_STORE_MAX_RECORD)) {
+            /* Nothing tells where the next record starts */
+            ERA_LOG(TAG, ERA_PSTR("Bad record in %s at %ld, rest ignored"), this->filename, this->readOffset);
+            this->damaged = true;
+            this->endRead();
+            return nullptr;
+        }
+
+        long next = (this->readOffset + (long)(sizeof(header) + header.keyLen + header.valueLen));
+        ERA_FREE(this->buffer);
+        this->buffer = (char*)ERA_MALLOC(header.keyLen + header.valueLen + 2);
+        if (this->buffer == nullptr) {
+            this->endRead();
+            return nullptr;
+        }
+        char* data = this->buffer;
+        if ((fread(data, 1, header.keyLen, this->file) != header.keyLen) ||
+            (fread(data + header.keyLen + 1, 1, header.valueLen, this->file) != header.valueLen)) {
+            this->cutTail();
+            return nullptr;
+        }
+        data[header.keyLen] = '\0';
+        data[header.keyLen + 1 + header.valueLen] = '\0';
+        uint32_t crc = ERaCrc32(0, &header, offsetof(Header_t, crc));
+        crc = ERaCrc32(crc, data, header.keyLen);
+        crc = ERaCrc32(crc, data + header.keyLen + 1, header.valueLen);
+        if (crc != header.crc) {
+            if (fgetc(this->file) == EOF) {
+                this->cutTail();
+                return nullptr;
+            }
+            /* Whole but corrupt, step over it by its lengths */
+            ERA_LOG(TAG, ERA_PSTR("Bad record in %s at %ld, skipped"), this->filename, this->readOffset);
+            fseek(this->file, next, SEEK_SET);
+            this->readOffset = next;
+            this->damaged = true;
+            continue;
+        }
+
+        this->record.erase = !!header.erase;
+        this->record.key = this->buffer;
+        this->record.value = this->buffer + header.keyLen + 1;
+        this->readOffset = next;
+        this->numRecords++;
+        return &this->record;
+    }
+}
+
+/* The record at readOffset runs to the end of the file,
+   a torn write. Appends go after the last good record */
+inline
+void ERaStoreLinux::cutTail() {
+    fseek(this->file, 0L, SEEK_END);
+    if (ftell(this->file) > this->readOffset) {
+        ERA_LOG(TAG, ERA_PSTR("Cut %s at %ld"), this->filename, this->readOffset);
+        if (truncate(this->filename, this->readOffset) != 0) {
+            ERA_LOG(TAG, ERA_PSTR("Cut %s failed (%d)"), this->filename, errno);
+        }
+    }
+    this->endRead();
+}
+
+inline
+void ERaStoreLinux::endRead() {
+    if (this->file != nullptr) {
+        fclose(this->file);
+        this->file = nullptr;
+    }
+    ERA_FREE(this->buffer);
+    this->buffer = nullptr;
+}
+
+inline
+bool ERaStoreLinux::put(const char* key, const char* value) {
+    if ((key == nullptr) || (value == nullptr)) {
+        return false;
+    }
+    if (!this->openLog()) {
+        return false;
+    }
+    if (!this->append(this->fd, false, key, value, true)) {
+        return false;
+    }
+    this->numRecords++;
+    return true;
+}
+
+inline
+bool ERaStoreLinux::erase(const char* key) {
+    if (key == nullptr) {
+        return false;
+    }
+    if (!this->openLog()) {
+        return false;
+    }
+    if (!this->append(this->fd, true, key, "", true)) {
+        return false;
+    }
+    this->numRecords++;
+    return true;
+}
+
+inline
+bool ERaStoreLinux::beginCompact() {
+    char name[256] {0};
+    this->endRead();
+    this->closeLog(this->fd);
+    this->mkdir();
+    this->tempName(name, sizeof(name));
+    this->fd = open(name, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    this->numRecords = 0;
+    return (this->fd >= 0);
+}
+
+inline
+bool ERaStoreLinux::compact(const char* key, const char* value) {
+    if ((key == nullptr) || (value == nullptr) || (this->fd < 0)) {
+        return false;
+    }
+    /* Synced once by endCompact() */
+    if (!this->append(this->fd, false, key, value, false)) {
+        return false;
+    }
+    this->numRecords++;
+    return true;
+}
+
+inline
+bool ERaStoreLinux::endCompact() {
+    char name[256] {0};
+    if (this->fd < 0) {
+        return false;
+    }
+    this->tempName(name, sizeof(name));
+    bool status = (fsync(this->fd) == 0);
+    this->closeLog(this->fd);
+    if (status) {
+        status = (rename(name, this->filename) == 0);
+    }
+    if (!status) {
+        ERA_LOG(TAG, ERA_PSTR("Compact %s failed (%d)"), this->filename, errno);
+        remove(name);
+        return false;
+    }
+    this->syncDir();
+    this->damaged = false;
+    return true;
+}
+
+inline
+bool ERaStoreLinux::append(int _fd, bool _erase, const char* key, const char* value, bool sync) {
+    Header_t header {};
+    header.magic = ERA_STORE_MAGIC;
+    header.erase = _erase;
+    header.keyLen = (uint32_t)strlen(key);
+    header.valueLen = (uint32_t)strlen(value);
+    if ((header.keyLen + header.valueLen) > ERA_STORE_MAX_RECORD) {
+        return false;
+    }
+    header.crc = ERaCrc32(0, &header, offsetof(Header_t, crc));
+    header.crc = ERaCrc32(header.crc, key, header.keyLen);
+    header.crc = ERaCrc32(header.crc, value, header.valueLen);
+
+    /* One write per record, a torn one fails its CRC */
+    size_t length = (sizeof(header) + header.keyLen + header.valueLen);
+    char* data = (char*)ERA_MALLOC(length);
+    if (data == nullptr) {
+        return false;
+    }
+    memcpy(data, &header, sizeof(header));
+    memcpy(data + sizeof(header), key, header.keyLen);
+    memcpy(data + sizeof(header) + header.keyLen, value, header.valueLen);
+
+    size_t written {0};
+    while (written < length) {
+        ssize_t rc = ::write(_fd, data + written, length - written);
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        written += (size_t)rc;
+    }
+    ERA_FREE(data);
+    if (written != length) {
+        ERA_LOG(TAG, ERA_PSTR("Write %s failed (%d)"), this->filename, errno);
+        return false;
+    }
+    return (!sync || (fdatasync(_fd) == 0));
+}
+
+inline
+bool ERaStoreLinux::openLog() {
+    if (this->fd >= 0) {
+        return true;
+    }
+    this->mkdir();
+    this->fd = open(this->filename, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    return (this->fd >= 0);
+}
+
+inline
+void ERaStoreLinux::closeLog(int& _fd) {
+    if (_fd < 0) {
+        return;
+    }
+    close(_fd);
+    _fd = -1;
+}
+
+inline
+void ERaStoreLinux::tempName(char* name, size_t len) const {
+    snprintf(name, len, "%s.tmp", this->filename);
+}
+
+/* Make the rename itself durable */
+inline
+void ERaStoreLinux::syncDir() const {
+    char dir[256] {0};
+    snprintf(dir, sizeof(dir), "%s", this->filename);
+    int dirFd = open(dirname(dir), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0) {
+        return;
+    }
+    fsync(dirFd);
+    close(dirFd);
+}
+
+inline
+void ERaStoreLinux::mkdir() const {
+    char dir[256] {0};
+    snprintf(dir, sizeof(dir), "%s", this->filename);
+    for (char* p = dir + 1; *p; ++p) {
+        if (*p == '/') {
+            *p = 0;
+            ::mkdir(dir, 0755);
+            *p = '/';
+        }
+    }
+}
+
+#endif /* INC_ERA_STORE_LINUX_HPP_ */
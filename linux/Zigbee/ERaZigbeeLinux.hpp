@@ -22,46 +22,43 @@ void ERaZigbee<Api>::handleZigbeeData() {
         return;
     }
 
-    if (!this->stream->available()) {
-        return;
+    ERaZnpView frame;
+    while (this->nextFrame(frame)) {
+        this->processFrame(frame.data(), frame.size());
+        this->releaseFrame(frame);
     }
-    int remain {0};
-    uint8_t index {0};
-    uint8_t payload[256] {0};
-    MillisTime_t startMillis = ERaMillis();
-    do {
-        if (!this->stream->available()) {
-            ERA_ZIGBEE_YIELD();
-            continue;
-        }
-        int position {0};
-        int length = this->stream->available();
-        uint8_t receive[(length < 256) ? 256 : length] {0};
-        ERaGuardLock(this->mutexData);
-        do {
-            receive[position] = this->stream->read();
-            if (index && !position) {
-                length = remain;
-            }
-            else if (!index && (position == this->PositionDataLength)) {
-                if (receive[this->PositionSOF] == this->SOF) {
-                    length = receive[this->PositionDataLength] + this->MinMessageLength;
-                }
-                else {
-                    length = 0;
-                }
-            }
-        } while ((++position < length) && ERaRemainingTime(startMillis, DEFAULT_TIMEOUT));
-        ERaGuardUnlock(this->mutexData);
-        this->processZigbee(receive, length, 256, payload, index, (!index ? 0 : payload[this->PositionDataLength]));
-        if (index) {
-            if (!length) {
-                index = 0;
-            }
-            remain = length - index;
-            ERA_ZIGBEE_YIELD();
+    /* Block on the serial port for one yield slice */
+    this->stream->waitAvailable(ERA_ZIGBEE_YIELD_MS);
+}
+
+/* Decode from what is buffered, read in bulk when
+   no frame is complete. Only decoding is locked,
+   frames are processed by the caller */
+template <class Api>
+bool ERaZigbee<Api>::nextFrame(ERaZnpView& frame) {
+    if (this->stream == NULL) {
+        return false;
+    }
+
+    ERaGuardLock(this->mutexData);
+    bool found = this->decoder.next(frame);
+    if (!found) {
+        size_t room {0};
+        uint8_t* ptr = this->decoder.reserve(room);
+        if (room) {
+            this->decoder.commit(this->stream->readAvailable(ptr, room));
+            found = this->decoder.next(frame);
         }
-    } while (index && ERaRemainingTime(startMillis, DEFAULT_TIMEOUT));
+    }
+    ERaGuardUnlock(this->mutexData);
+    return found;
+}
+
+template <class Api>
+void ERaZigbee<Api>::releaseFrame(const ERaZnpView& frame) {
+    ERaGuardLock(this->mutexData);
+    this->decoder.release(frame);
+    ERaGuardUnlock(this->mutexData);
 }
 
 template <class Zigbee>
@@ -75,6 +72,7 @@ ResultT ERaToZigbee<Zigbee>::waitResponse(Response_t rspWait, void* value) {
     }
     uint8_t cmdStatus = ZnpCommandStatusT::INVALID_PARAM;
 
+    ERaZnpView frame;
     MillisTime_t startMillis = ERaMillis();
 
     do {
@@ -93,50 +91,16 @@ ResultT ERaToZigbee<Zigbee>::waitResponse(Response_t rspWait, void* value) {
                 }
             }
         }
-        if (!this->thisZigbee().stream->available()) {
-            ERA_ZIGBEE_YIELD();
-            continue;
-        }
-        int remain {0};
-        uint8_t index {0};
-        uint8_t payload[256] {0};
-        do {
-            if (!this->thisZigbee().stream->available()) {
-                ERA_ZIGBEE_YIELD();
-                continue;
-            }
-            int position = 0;
-            int length = this->thisZigbee().stream->available();
-            uint8_t receive[(length < 256) ? 256 : length] {0};
-            ERaGuardLock(this->thisZigbee().mutexData);
-            do {
-                receive[position] = this->thisZigbee().stream->read();
-                if (index && !position) {
-                    length = remain;
-                }
-                else if (!index && (position == this->thisZigbee().PositionDataLength)) {
-                    if (receive[this->thisZigbee().PositionSOF] == this->thisZigbee().SOF) {
-                        length = receive[this->thisZigbee().PositionDataLength] + this->thisZigbee().MinMessageLength;
-                    }
-                    else {
-                        length = 0;
-                    }
-                }
-            } while ((++position < length) && ERaRemainingTime(startMillis, rspWait.timeout));
-            ERaGuardUnlock(this->thisZigbee().mutexData);
-            if (this->thisZigbee().processZigbee(receive, length, 256, payload, index,
-                (!index ? 0 : payload[this->thisZigbee().PositionDataLength]), &cmdStatus, &rspWait, value)) {
+        while (this->thisZigbee().nextFrame(frame)) {
+            bool found = this->thisZigbee().processFrame(frame.data(), frame.size(), &cmdStatus, &rspWait, value);
+            this->thisZigbee().releaseFrame(frame);
+            if (found) {
                 return ((cmdStatus != ZnpCommandStatusT::INVALID_PARAM) ? static_cast<ResultT>(cmdStatus) : ResultT::RESULT_SUCCESSFUL);
             }
-            if (index) {
-                if (!length) {
-                    index = 0;
-                }
-                remain = length - index;
-                ERA_ZIGBEE_YIELD();
-            }
-        } while (index && ERaRemainingTime(startMillis, rspWait.timeout));
-        ERA_ZIGBEE_YIELD();
+        }
+        /* Wake on serial data, the slice bounds how late a response
+           queued by the other task is seen */
+        this->thisZigbee().stream->waitAvailable(ERA_ZIGBEE_YIELD_MS);
     } while (ERaRemainingTime(startMillis, rspWait.timeout));
     return ((cmdStatus != ZnpCommandStatusT::INVALID_PARAM) ? static_cast<ResultT>(cmdStatus) : ResultT::RESULT_TIMEOUT);
 }
@@ -42,7 +42,7 @@ void setup() {
 
 void loop() {
     ERa.run();
-    timer.run();
+    ERa.wait(timer.run());
 }
 
 int main(int argc, char *argv[]) {
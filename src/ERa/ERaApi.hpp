@@ -11,6 +11,7 @@
 #include <ERa/ERaHelper.hpp>
 #include <ERa/ERaTransp.hpp>
 #include <Utility/ERaQueue.hpp>
+#include <Utility/ERaJsonReader.hpp>
 #include <Modbus/ERaModbusSimple.hpp>
 #include <Zigbee/ERaZigbeeSimple.hpp>
 
@@ -194,9 +195,9 @@ protected:
 	void handleReadPin(cJSON* root);
 	void handleWritePin(cJSON* root);
 	void handleVirtualPin(cJSON* root);
-	void handlePinRequest(const ERaDataBuff& arrayTopic, const char* payload);
-	void processArduinoPinRequest(const ERaDataBuff& arrayTopic, const char* payload);
-	void processVirtualPinRequest(const ERaDataBuff& arrayTopic, const char* payload);
+	void handlePinRequest(const char* payload);
+	void processArduinoPinRequest(uint8_t pin, const char* payload);
+	void processVirtualPinRequest(uint8_t pin, const char* payload);
 	void initPinConfig();
 	void parsePinConfig(const char* str);
 	void storePinConfig(const char* str);
@@ -462,14 +463,7 @@ void ERaApi<Proto, Flash>::handleVirtualPin(cJSON* root) {
 
 template <class Proto, class Flash>
 inline
-void ERaApi<Proto, Flash>::processVirtualPinRequest(const ERaDataBuff& arrayTopic, const char* payload) {
-	if (arrayTopic.size() != 3) {
-		return;
-	}
-	const char* str = arrayTopic.at(2).getString();
-	if (str == nullptr) {
-		return;
-	}
+void ERaApi<Proto, Flash>::processVirtualPinRequest(uint8_t pin, const char* payload) {
 	cJSON* root = cJSON_Parse(payload);
 	if (!cJSON_IsObject(root)) {
 		cJSON_Delete(root);
@@ -478,7 +472,6 @@ void ERaApi<Proto, Flash>::processVirtualPinRequest(const ERaDataBuff& arrayTopi
 	}
 	ERaDataJson data(root);
 	ERaParam param(data);
-	uint8_t pin = ERA_DECODE_PIN_NAME(str);
 	cJSON* item = cJSON_GetObjectItem(root, "value");
 	if (cJSON_IsNumber(item) ||
 		cJSON_IsBool(item)) {
@@ -506,25 +499,19 @@ void ERaApi<Proto, Flash>::initPinConfig() {
 template <class Proto, class Flash>
 inline
 void ERaApi<Proto, Flash>::parsePinConfig(const char* str) {
-	cJSON* root = cJSON_Parse(str);
-	if (!cJSON_IsObject(root)) {
-		cJSON_Delete(root);
-		root = nullptr;
+	ERaJsonReader root(str);
+	if (!root.isObject()) {
 		return;
 	}
 
-	cJSON* item = cJSON_GetObjectItem(root, "hash_id");
-	if (cJSON_IsString(item)) {
-		this->ERaPinRp.updateHashID(item->valuestring);
+	char hash[37] {0};
+	if (root.get("hash_id").getString(hash)) {
+		this->ERaPinRp.updateHashID(hash);
 	}
-	item = cJSON_GetObjectItem(root, "command");
-	if (cJSON_IsString(item)) {
+	ERaJsonReader item = root.get("command");
+	if (item.isString()) {
 		this->thisProto().processDownCommand(str, root, item);
 	}
-
-	cJSON_Delete(root);
-	root = nullptr;
-	item = nullptr;
 }
 
 template <class Proto, class Flash>
@@ -563,23 +550,16 @@ void ERaApi<Proto, Flash>::removePinConfig() {
 	template <class Proto, class Flash>
 	inline
 	void ERaApi<Proto, Flash>::updateBluetoothConfig(ERaTransp* transport, char* buf) {
-		cJSON* root = cJSON_Parse(buf);
-		if (!cJSON_IsObject(root)) {
-			cJSON_Delete(root);
-			root = nullptr;
+		ERaJsonReader root(buf);
+		if (!root.isObject()) {
 			return;
 		}
-		cJSON* data = cJSON_GetObjectItem(root, "data");
-		cJSON* item = cJSON_GetObjectItem(data, "hash_id");
-		if (cJSON_IsString(item)) {
-			// Update later
-		}
-		item = cJSON_GetObjectItem(data, "bluetooth");
-		if (cJSON_IsString(item)) {
-			transport->begin(item->valuestring);
+		// Hash ID update later
+		ERaJsonReader item = root.get("data.bluetooth");
+		if (item.isString()) {
+			/* buf is owned by the caller and only used once */
+			transport->begin(item.getStringInSitu());
 		}
-		cJSON_Delete(root);
-		root = nullptr;
 	}
 
 	template <class Proto, class Flash>
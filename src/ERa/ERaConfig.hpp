@@ -77,6 +77,12 @@
     #define ERA_MQTT_KEEP_ALIVE         60
 #endif
 
+#if defined(DEFAULT_MQTT_CLEAN_SESSION)
+    #define ERA_MQTT_CLEAN_SESSION      DEFAULT_MQTT_CLEAN_SESSION
+#else
+    #define ERA_MQTT_CLEAN_SESSION      true
+#endif
+
 #if defined(DEFAULT_MQTT_SUBSCRIBE_QOS)
     #define ERA_MQTT_SUBSCRIBE_QOS      DEFAULT_MQTT_SUBSCRIBE_QOS
 #else
@@ -89,6 +95,12 @@
     #define ERA_MQTT_PUBLISH_QOS        0
 #endif
 
+#if defined(DEFAULT_MQTT_PUBLISH_WINDOW)
+    #define ERA_MQTT_PUBLISH_WINDOW     DEFAULT_MQTT_PUBLISH_WINDOW
+#else
+    #define ERA_MQTT_PUBLISH_WINDOW     0
+#endif
+
 #if defined(DEFAULT_MQTT_PUBLISH_RETAINED)
     #define ERA_MQTT_PUBLISH_RETAINED   DEFAULT_MQTT_PUBLISH_RETAINED
 #else
@@ -101,6 +113,18 @@
     #define ERA_SOCKET_TIMEOUT          1
 #endif
 
+#if defined(DEFAULT_BATCH_WRITE_TIMEOUT)
+    #define ERA_BATCH_WRITE_TIMEOUT     DEFAULT_BATCH_WRITE_TIMEOUT
+#else
+    #define ERA_BATCH_WRITE_TIMEOUT     0
+#endif
+
+#if defined(DEFAULT_BATCH_WRITE_LIMIT)
+    #define ERA_BATCH_WRITE_LIMIT       DEFAULT_BATCH_WRITE_LIMIT
+#else
+    #define ERA_BATCH_WRITE_LIMIT       20
+#endif
+
 #if !defined(ERA_DISABLE_SYNC_CONFIG)
     #define ERA_ASK_CONFIG_WHEN_RESTART
 #endif
@@ -409,6 +409,10 @@
         #define ERA_MAX_VIRTUAL_PIN     50
     #endif
 
+    #if !defined(ERA_PIN_INDEX_SIZE)
+        #define ERA_PIN_INDEX_SIZE      72
+    #endif
+
     #define ERA_USE_ERA_ATOLL
     #define ERA_IGNORE_INPUT_PULLDOWN
 
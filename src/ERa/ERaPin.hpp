@@ -23,6 +23,12 @@
 #endif
 #define ERA_VIRTUAL             (int)(-1)
 
+/* Pin numbers below this are looked up directly,
+   higher ones fall back to a scan of the pin table */
+#if !defined(ERA_PIN_INDEX_SIZE)
+    #define ERA_PIN_INDEX_SIZE  256
+#endif
+
 template <class Report>
 class ERaPin
 {
@@ -40,6 +46,11 @@ class ERaPin
     enum PinFlagT {
         PIN_ON_DELETE = 0x80
     };
+#if (ERA_MAX_GPIO_PIN < 256) && (ERA_MAX_VIRTUAL_PIN < 256)
+    typedef uint8_t PinSlot_t;
+#else
+    typedef uint16_t PinSlot_t;
+#endif
     typedef struct __Pin_t {
         unsigned long prevMillis;
         unsigned long delay;
@@ -165,7 +176,12 @@ public:
 
     ERaPin(Report& _report)
         : report(_report)
+        , pin()
+        , vPin()
+        , pinIndex()
+        , vPinIndex()
         , numPin(0)
+        , numVPin(0)
     {
         memset(this->hashID, 0, sizeof(this->hashID));
     }
@@ -257,6 +273,8 @@ private:
     Pin_t* findPinExist(uint8_t p);
     VPin_t* findVPinExist(uint8_t p);
     Pin_t* findPinOfChannel(uint8_t channel);
+    Pin_t* addPin(uint8_t p);
+    VPin_t* addVPin(uint8_t p);
 
 	bool isValidPin(const Pin_t* pPin) {
         if (pPin == nullptr) {
@@ -267,6 +285,15 @@ private:
                 (pPin->pinMode == VIRTUAL));
 	}
 
+    bool isIndexed(uint8_t p) const {
+#if (ERA_PIN_INDEX_SIZE < 256)
+        return (p < ERA_PIN_INDEX_SIZE);
+#else
+        ERA_FORCE_UNUSED(p);
+        return true;
+#endif
+    }
+
     void setFlag(uint8_t& flags, uint8_t mask, bool value) {
         if (value) {
             flags |= mask;
@@ -281,8 +308,11 @@ private:
     }
 
     Report& report;
-	ERaList<Pin_t*> pin;
-    ERaList<VPin_t*> vPin;
+    /* Dense tables, the index holds slot + 1 (0 is empty) of a pin number */
+	Pin_t* pin[MAX_PINS];
+    VPin_t vPin[MAX_VPINS];
+    PinSlot_t pinIndex[ERA_PIN_INDEX_SIZE];
+    PinSlot_t vPinIndex[ERA_PIN_INDEX_SIZE];
 	unsigned int numPin;
 	unsigned int numVPin;
     char hashID[37];
@@ -291,9 +321,8 @@ private:
 template <class Report>
 void ERaPin<Report>::run() {
 	unsigned long currentMillis = ERaMillis();
-    const typename ERaList<Pin_t*>::iterator* e = this->pin.end();
-    for (typename ERaList<Pin_t*>::iterator* it = this->pin.begin(); it != e; it = it->getNext()) {
-        Pin_t* pPin = it->get();
+    for (unsigned int i = 0; i < this->numPin; ++i) {
+        Pin_t* pPin = this->pin[i];
         if (!this->isValidPin(pPin)) {
 			continue;
 		}
@@ -321,27 +350,34 @@ void ERaPin<Report>::run() {
         }
     }
 
-    typename ERaList<Pin_t*>::iterator* next = nullptr;
-    for (typename ERaList<Pin_t*>::iterator* it = this->pin.begin(); it != e; it = next) {
-        next = it->getNext();
-        Pin_t* pPin = it->get();
-        if (!this->isValidPin(pPin)) {
-			continue;
-		}
-        if (!pPin->called) {
-            continue;
+    unsigned int count {0};
+    for (unsigned int i = 0; i < this->numPin; ++i) {
+        Pin_t* pPin = this->pin[i];
+        if (this->isValidPin(pPin) && pPin->called) {
+            if (this->getFlag(pPin->called, PinFlagT::PIN_ON_DELETE)) {
+                if (this->isIndexed(pPin->pin)) {
+                    this->pinIndex[pPin->pin] = 0;
+                }
+                pPin->report.deleteReport();
+                delete pPin;
+                pPin = nullptr;
+                continue;
+            }
+            pPin->called = 0;
         }
-        if (this->getFlag(pPin->called, PinFlagT::PIN_ON_DELETE)) {
-            pPin->report.deleteReport();
-            delete pPin;
-            pPin = nullptr;
-            it->get() = nullptr;
-            this->pin.remove(it);
-            this->numPin--;
-            continue;
+        /* Keep the table packed */
+        if (count != i) {
+            this->pin[count] = pPin;
+            if (this->isIndexed(pPin->pin)) {
+                this->pinIndex[pPin->pin] = (PinSlot_t)(count + 1);
+            }
         }
-        pPin->called = 0;
+        count++;
+    }
+    for (unsigned int i = count; i < this->numPin; ++i) {
+        this->pin[i] = nullptr;
     }
+    this->numPin = count;
 
     this->report.run();
 }
@@ -375,15 +411,10 @@ typename ERaPin<Report>::Pin_t* ERaPin<Report>::setupPinReport(uint8_t p, uint8_
 
     Pin_t* pPin = this->findPinExist(p);
     if (pPin == nullptr) {
-        if (!this->isPinFree()) {
-            return nullptr;
-        }
-        pPin = new Pin_t();
+        pPin = this->addPin(p);
         if (pPin == nullptr) {
             return nullptr;
         }
-        this->pin.put(pPin);
-        this->numPin++;
     }
     
     pPin->prevMillis = ERaMillis();
@@ -421,15 +452,10 @@ typename ERaPin<Report>::Pin_t* ERaPin<Report>::setupPinReport(uint8_t p, uint8_
 
     Pin_t* pPin = this->findPinExist(p);
     if (pPin == nullptr) {
-        if (!this->isPinFree()) {
-            return nullptr;
-        }
-        pPin = new Pin_t();
+        pPin = this->addPin(p);
         if (pPin == nullptr) {
             return nullptr;
         }
-        this->pin.put(pPin);
-        this->numPin++;
     }
     
     pPin->prevMillis = ERaMillis();
@@ -454,15 +480,10 @@ template <class Report>
 typename ERaPin<Report>::VPin_t* ERaPin<Report>::setupPinVirtual(uint8_t p, unsigned int configId) {
     VPin_t* pVPin = this->findVPinExist(p);
     if (pVPin == nullptr) {
-        if (!this->isVPinFree()) {
-            return nullptr;
-        }
-        pVPin = new VPin_t();
+        pVPin = this->addVPin(p);
         if (pVPin == nullptr) {
             return nullptr;
         }
-        this->vPin.put(pVPin);
-	    this->numVPin++;
     }
     
     pVPin->pin = p;
@@ -487,15 +508,10 @@ typename ERaPin<Report>::Pin_t* ERaPin<Report>::setupPWMPinReport(uint8_t p, uin
 
     Pin_t* pPin = this->findPinExist(p);
     if (pPin == nullptr) {
-        if (!this->isPinFree()) {
-            return nullptr;
-        }
-        pPin = new Pin_t();
+        pPin = this->addPin(p);
         if (pPin == nullptr) {
             return nullptr;
         }
-        this->pin.put(pPin);
-        this->numPin++;
     }
 
     pPin->prevMillis = ERaMillis();
@@ -534,15 +550,10 @@ typename ERaPin<Report>::Pin_t* ERaPin<Report>::setupPWMPinReport(uint8_t p, uin
 
     Pin_t* pPin = this->findPinExist(p);
     if (pPin == nullptr) {
-        if (!this->isPinFree()) {
-            return nullptr;
-        }
-        pPin = new Pin_t();
+        pPin = this->addPin(p);
         if (pPin == nullptr) {
             return nullptr;
         }
-        this->pin.put(pPin);
-        this->numPin++;
     }
     
     pPin->prevMillis = ERaMillis();
@@ -628,33 +639,23 @@ void ERaPin<Report>::deleteWithPin(uint8_t p) {
 
 template <class Report>
 void ERaPin<Report>::deleteAll() {
-    const typename ERaList<Pin_t*>::iterator* e = this->pin.end();
-    for (typename ERaList<Pin_t*>::iterator* it = this->pin.begin(); it != e; it = it->getNext()) {
-        Pin_t* pPin = it->get();
+    for (unsigned int i = 0; i < this->numPin; ++i) {
+        Pin_t* pPin = this->pin[i];
         if (pPin == nullptr) {
 			continue;
 		}
         pPin->report.deleteReport();
         delete pPin;
         pPin = nullptr;
-        it->get() = nullptr;
+        this->pin[i] = nullptr;
     }
-    this->pin.clear();
+    memset(this->pinIndex, 0, sizeof(this->pinIndex));
     this->numPin = 0;
 
     this->report.run();
 
-    const typename ERaList<VPin_t*>::iterator* eVPin = this->vPin.end();
-    for (typename ERaList<VPin_t*>::iterator* it = this->vPin.begin(); it != eVPin; it = it->getNext()) {
-        VPin_t* pVPin = it->get();
-        if (pVPin == nullptr) {
-            continue;
-        }
-        delete pVPin;
-        pVPin = nullptr;
-        it->get() = nullptr;
-    }
-    this->vPin.clear();
+    memset(this->vPin, 0, sizeof(this->vPin));
+    memset(this->vPinIndex, 0, sizeof(this->vPinIndex));
     this->numVPin = 0;
 }
 
@@ -703,14 +704,9 @@ typename Report::ScaleData_t* ERaPin<Report>::getScale(Pin_t* pPin) {
 
 template <class Report>
 typename Report::ScaleData_t* ERaPin<Report>::findScale(uint8_t p) {
-    const typename ERaList<Pin_t*>::iterator* e = this->pin.end();
-    for (typename ERaList<Pin_t*>::iterator* it = this->pin.begin(); it != e; it = it->getNext()) {
-        Pin_t* pPin = it->get();
-        if (this->isValidPin(pPin)) {
-            if (pPin->pin == p) {
-                return pPin->report.getScale();
-            }
-        }
+    Pin_t* pPin = this->findPinExist(p);
+    if (this->isValidPin(pPin)) {
+        return pPin->report.getScale();
     }
     
     return nullptr;
@@ -718,14 +714,9 @@ typename Report::ScaleData_t* ERaPin<Report>::findScale(uint8_t p) {
 
 template <class Report>
 typename Report::iterator* ERaPin<Report>::getReport(uint8_t p) {
-    const typename ERaList<Pin_t*>::iterator* e = this->pin.end();
-    for (typename ERaList<Pin_t*>::iterator* it = this->pin.begin(); it != e; it = it->getNext()) {
-        Pin_t* pPin = it->get();
-        if (this->isValidPin(pPin)) {
-            if (pPin->pin == p) {
-                return &pPin->report;
-            }
-        }
+    Pin_t* pPin = this->findPinExist(p);
+    if (this->isValidPin(pPin)) {
+        return &pPin->report;
     }
     
     return nullptr;
@@ -733,9 +724,8 @@ typename Report::iterator* ERaPin<Report>::getReport(uint8_t p) {
 
 template <class Report>
 void ERaPin<Report>::enableAll() {
-    const typename ERaList<Pin_t*>::iterator* e = this->pin.end();
-    for (typename ERaList<Pin_t*>::iterator* it = this->pin.begin(); it != e; it = it->getNext()) {
-        Pin_t* pPin = it->get();
+    for (unsigned int i = 0; i < this->numPin; ++i) {
+        Pin_t* pPin = this->pin[i];
         if (this->isValidPin(pPin)) {
 			pPin->enable = true;
             pPin->report.enable();
@@ -745,9 +735,8 @@ void ERaPin<Report>::enableAll() {
 
 template <class Report>
 void ERaPin<Report>::disableAll() {
-    const typename ERaList<Pin_t*>::iterator* e = this->pin.end();
-    for (typename ERaList<Pin_t*>::iterator* it = this->pin.begin(); it != e; it = it->getNext()) {
-        Pin_t* pPin = it->get();
+    for (unsigned int i = 0; i < this->numPin; ++i) {
+        Pin_t* pPin = this->pin[i];
         if (this->isValidPin(pPin)) {
 			pPin->enable = false;
             pPin->report.disable();
@@ -775,13 +764,14 @@ bool ERaPin<Report>::isVPinFree() {
 
 template <class Report>
 typename ERaPin<Report>::Pin_t* ERaPin<Report>::findPinExist(uint8_t p) {
-    const typename ERaList<Pin_t*>::iterator* e = this->pin.end();
-    for (typename ERaList<Pin_t*>::iterator* it = this->pin.begin(); it != e; it = it->getNext()) {
-        Pin_t* pPin = it->get();
-        if (this->isValidPin(pPin)) {
-            if (pPin->pin == p) {
-                return pPin;
-            }
+    if (this->isIndexed(p)) {
+        PinSlot_t slot = this->pinIndex[p];
+        return (slot ? this->pin[slot - 1] : nullptr);
+    }
+    for (unsigned int i = 0; i < this->numPin; ++i) {
+        if ((this->pin[i] != nullptr) &&
+            (this->pin[i]->pin == p)) {
+            return this->pin[i];
         }
     }
     
@@ -790,29 +780,52 @@ typename ERaPin<Report>::Pin_t* ERaPin<Report>::findPinExist(uint8_t p) {
 
 template <class Report>
 typename ERaPin<Report>::VPin_t* ERaPin<Report>::findVPinExist(uint8_t p) {
-    const typename ERaList<VPin_t*>::iterator* e = this->vPin.end();
-    for (typename ERaList<VPin_t*>::iterator* it = this->vPin.begin(); it != e; it = it->getNext()) {
-        VPin_t* pVPin = it->get();
-        if (pVPin != nullptr) {
-            if (pVPin->pin == p) {
-                return pVPin;
-            }
+    if (this->isIndexed(p)) {
+        PinSlot_t slot = this->vPinIndex[p];
+        return (slot ? &this->vPin[slot - 1] : nullptr);
+    }
+    for (unsigned int i = 0; i < this->numVPin; ++i) {
+        if (this->vPin[i].pin == p) {
+            return &this->vPin[i];
         }
     }
     
     return nullptr;
 }
 
+template <class Report>
+typename ERaPin<Report>::Pin_t* ERaPin<Report>::addPin(uint8_t p) {
+    if (!this->isPinFree()) {
+        return nullptr;
+    }
+    Pin_t* pPin = new Pin_t();
+    if (pPin == nullptr) {
+        return nullptr;
+    }
+    this->pin[this->numPin++] = pPin;
+    if (this->isIndexed(p)) {
+        this->pinIndex[p] = (PinSlot_t)this->numPin;
+    }
+    return pPin;
+}
+
+template <class Report>
+typename ERaPin<Report>::VPin_t* ERaPin<Report>::addVPin(uint8_t p) {
+    if (!this->isVPinFree()) {
+        return nullptr;
+    }
+    VPin_t* pVPin = &this->vPin[this->numVPin++];
+    if (this->isIndexed(p)) {
+        this->vPinIndex[p] = (PinSlot_t)this->numVPin;
+    }
+    return pVPin;
+}
+
 template <class Report>
 int ERaPin<Report>::findPinMode(uint8_t p) {
-    const typename ERaList<Pin_t*>::iterator* e = this->pin.end();
-    for (typename ERaList<Pin_t*>::iterator* it = this->pin.begin(); it != e; it = it->getNext()) {
-        Pin_t* pPin = it->get();
-        if (this->isValidPin(pPin)) {
-            if (pPin->pin == p) {
-                return pPin->pinMode;
-            }
-        }
+    Pin_t* pPin = this->findPinExist(p);
+    if (this->isValidPin(pPin)) {
+        return pPin->pinMode;
     }
     
     return -1;
@@ -820,15 +833,10 @@ int ERaPin<Report>::findPinMode(uint8_t p) {
 
 template <class Report>
 int ERaPin<Report>::findChannelPWM(uint8_t p) {
-    const typename ERaList<Pin_t*>::iterator* e = this->pin.end();
-    for (typename ERaList<Pin_t*>::iterator* it = this->pin.begin(); it != e; it = it->getNext()) {
-        Pin_t* pPin = it->get();
-        if (this->isValidPin(pPin)) {
-            if ((pPin->pin == p) &&
-                (pPin->pinMode == PWM)) {
-                return pPin->channel;
-            }
-        }
+    Pin_t* pPin = this->findPinExist(p);
+    if (this->isValidPin(pPin) &&
+        (pPin->pinMode == PWM)) {
+        return pPin->channel;
     }
     
     return -1;
@@ -836,15 +844,10 @@ int ERaPin<Report>::findChannelPWM(uint8_t p) {
 
 template <class Report>
 int ERaPin<Report>::findConfigId(uint8_t p) {
-    const typename ERaList<Pin_t*>::iterator* e = this->pin.end();
-    for (typename ERaList<Pin_t*>::iterator* it = this->pin.begin(); it != e; it = it->getNext()) {
-        Pin_t* pPin = it->get();
-        if (this->isValidPin(pPin)) {
-            if ((pPin->pin == p) &&
-                pPin->configId) {
-                return pPin->configId;
-            }
-        }
+    Pin_t* pPin = this->findPinExist(p);
+    if (this->isValidPin(pPin) &&
+        pPin->configId) {
+        return pPin->configId;
     }
     
     return -1;
@@ -852,15 +855,10 @@ int ERaPin<Report>::findConfigId(uint8_t p) {
 
 template <class Report>
 int ERaPin<Report>::findVPinConfigId(uint8_t p) {
-    const typename ERaList<VPin_t*>::iterator* e = this->vPin.end();
-    for (typename ERaList<VPin_t*>::iterator* it = this->vPin.begin(); it != e; it = it->getNext()) {
-        VPin_t* pVPin = it->get();
-        if (pVPin != nullptr) {
-            if ((pVPin->pin == p) &&
-                pVPin->configId) {
-                return pVPin->configId;
-            }
-        }
+    VPin_t* pVPin = this->findVPinExist(p);
+    if ((pVPin != nullptr) &&
+        pVPin->configId) {
+        return pVPin->configId;
     }
     
     return -1;
@@ -879,9 +877,8 @@ int ERaPin<Report>::findChannelFree() {
 
 template <class Report>
 typename ERaPin<Report>::Pin_t* ERaPin<Report>::findPinOfChannel(uint8_t channel) {
-    const typename ERaList<Pin_t*>::iterator* e = this->pin.end();
-    for (typename ERaList<Pin_t*>::iterator* it = this->pin.begin(); it != e; it = it->getNext()) {
-        Pin_t* pPin = it->get();
+    for (unsigned int i = 0; i < this->numPin; ++i) {
+        Pin_t* pPin = this->pin[i];
         if (this->isValidPin(pPin)) {
             if ((pPin->channel == channel) &&
                 (pPin->pinMode == PWM)) {
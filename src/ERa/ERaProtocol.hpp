@@ -16,6 +16,8 @@
 #include <ERa/ERaApi.hpp>
 #include <ERa/ERaTask.hpp>
 #include <ERa/ERaTransp.hpp>
+#include <ERa/ERaTopic.hpp>
+#include <Utility/ERaJsonReader.hpp>
 #include <PnP/ERaState.hpp>
 #include <OTA/ERaOTA.hpp>
 
@@ -42,6 +44,15 @@ class ERaProto
 		CHIP_CONTROL_ALIAS = 5,
 		CHIP_IO_PIN = 6
 	};
+	enum ERaTopicT {
+		TOPIC_PIN_DOWN = 0,
+		TOPIC_ARDUINO_PIN = 1,
+		TOPIC_VIRTUAL_PIN = 2,
+		TOPIC_DOWN = 3,
+		TOPIC_ZIGBEE_DEVICE = 4,
+		TOPIC_ZIGBEE_DOWN = 5,
+		TOPIC_USER = 6
+	};
 	typedef void* ApiData_t;
 #if defined(PROTO_HAS_FUNCTIONAL_H)
     typedef std::function<void(const char*, const char*)> MessageCallback_t;
@@ -68,8 +79,24 @@ public:
 		, transp(_transp)
 		, dTransp(nullptr)
 		, _connected(false)
+		, infoSent(false)
+		, batchData()
+		, batchTimeout(ERA_BATCH_WRITE_TIMEOUT)
+		, batchLimit(ERA_BATCH_WRITE_LIMIT)
+		, batchMillis(0)
+		, batchMutex(nullptr)
+		, topicRouter()
     {
         memset(this->ERA_TOPIC, 0, sizeof(this->ERA_TOPIC));
+		this->topicRouter.add("/pin/down", ERaTopicT::TOPIC_PIN_DOWN);
+		this->topicRouter.add("/arduino_pin/+", ERaTopicT::TOPIC_ARDUINO_PIN);
+		this->topicRouter.add("/virtual_pin/+", ERaTopicT::TOPIC_VIRTUAL_PIN);
+		this->topicRouter.add("/down", ERaTopicT::TOPIC_DOWN);
+#if defined(ERA_ZIGBEE)
+		this->topicRouter.add("/zigbee/permit_to_join", ERaTopicT::TOPIC_ZIGBEE_DEVICE);
+		this->topicRouter.add("/zigbee/remove_device", ERaTopicT::TOPIC_ZIGBEE_DEVICE);
+		this->topicRouter.add("/zigbee/+/down", ERaTopicT::TOPIC_ZIGBEE_DOWN);
+#endif
     }
     ~ERaProto()
     {}
@@ -92,11 +119,18 @@ public:
 			ERaState::set(StateT::STATE_DISCONNECTED);
 		}
 		else {
+			/* The broker was unreachable when connect() gave up */
+			if (!this->infoSent) {
+				this->printBanner();
+				this->sendInfo();
+				this->infoSent = true;
+			}
 			this->_connected = true;
 		}
 		if (this->dTransp != nullptr) {
 			this->dTransp->run();
 		}
+		this->runBatchWrite();
 		this->runERaTask();
 	}
 
@@ -130,6 +164,26 @@ public:
 		this->transp.syncConfig();
 	}
 
+	/* Merge config id writes (last write wins) and publish them
+	   as one /config_value message every timeout ms or once
+	   limit ids are pending. Timeout 0 disables batching. */
+	void setBatchWrite(MillisTime_t timeout, size_t limit = ERA_BATCH_WRITE_LIMIT) {
+		this->flushBatchWrite();
+		this->batchTimeout = timeout;
+		this->batchLimit = (limit ? limit : 1);
+	}
+
+	void flushBatchWrite();
+
+	/* Route messages on <ERA_TOPIC><filter> to cb, '+' levels are
+	   passed in args. The transport must be subscribed to the topic. */
+	bool addTopicRoute(const char* filter, ERaTopicRouter::TopicCallback_t cb) {
+		if (cb == nullptr) {
+			return false;
+		}
+		return this->topicRouter.add(filter, ERaTopicT::TOPIC_USER, cb);
+	}
+
 	ERA_DEPRECATED
 	void askConfigWhenRestart(bool enable = true) {
 		this->transp.setAskConfig(enable);
@@ -147,6 +201,7 @@ protected:
 		}
 		this->printBanner();
 		this->sendInfo();
+		this->infoSent = true;
 		this->_connected = true;
 		return true;
     }
@@ -159,19 +214,17 @@ private:
 	void initERaTask();
 	void runERaTask();
 	void printBanner();
-	void processPinRequest(const ERaDataBuff& arrayTopic, const char* payload);
-	void processDownRequest(const ERaDataBuff& arrayTopic, const char* payload);
-	void processDownAction(const char* payload, cJSON* root, cJSON* item);
-	void processActionChip(const char* payload, cJSON* root, uint8_t type);
-	void processDownCommand(const char* payload, cJSON* root, cJSON* item);
-	void processFinalize(const char* payload, cJSON* root);
+	void processDownRequest(const char* payload);
+	void processDownAction(const char* payload, const ERaJsonReader& root, const ERaJsonReader& item);
+	void processActionChip(const char* payload, const ERaJsonReader& root, uint8_t type);
+	void processDownCommand(const char* payload, const ERaJsonReader& root, const ERaJsonReader& item);
+	void processFinalize(const char* payload, const ERaJsonReader& root);
 	void processConfiguration(const char* payload, const char* hash, cJSON* root);
 	void processDeviceConfig(cJSON* root, uint8_t type);
 	void processIOPin(cJSON* root);
 #if defined(ERA_ZIGBEE)
-	void processZigbeeRequest(const ERaDataBuff& arrayTopic, const char* payload);
 	void processDeviceZigbee(const char* payload);
-	void processActionDeviceZigbee(const cJSON* const root, uint8_t type);
+	void processActionDeviceZigbee(const ERaJsonReader& root, uint8_t type);
 	void processActionZigbee(const char* ieeeAddr, const char* payload, uint8_t type);
 #endif
 	bool sendInfo();
@@ -179,6 +232,9 @@ private:
 	bool sendPinData(ERaRsp_t& rsp);
 	bool sendConfigIdData(ERaRsp_t& rsp);
 	bool sendConfigIdMultiData(ERaRsp_t& rsp);
+	bool sendValueData(const char* topic, const char* name, ERaRsp_t& rsp);
+	bool addBatchWrite(ERaRsp_t& rsp);
+	void runBatchWrite();
 	bool sendModbusData(ERaRsp_t& rsp);
 	bool sendZigbeeData(ERaRsp_t& rsp);
 	void sendCommandVirtualMulti(const char* auth, ERaRsp_t& rsp, ERaDataJson* data);
@@ -192,8 +248,6 @@ private:
 	static void _processRequest(const char* topic, const char* payload);
 #endif
 
-	size_t splitString(char* strInput, const char* delims);
-
 	bool connected() const {
 		return this->_connected;
 	}
@@ -216,6 +270,13 @@ private:
 	Transp& transp;
 	ERaTransp* dTransp;
 	bool _connected;
+	bool infoSent;
+	ERaDataJson batchData;
+	MillisTime_t batchTimeout;
+	size_t batchLimit;
+	MillisTime_t batchMillis;
+	ERaMutex_t batchMutex;
+	ERaTopicRouter topicRouter;
 };
 
 template <class Transp, class Flash>
@@ -241,78 +302,75 @@ void ERaProto<Transp, Flash>::processRequest(const char* topic, const char* payl
 
 	ERA_LOG(this->transp.getTag(), ERA_PSTR("Message %s: %s"), topic, payload);
 
-	if (ERaFindStr(topic, this->ERA_TOPIC) != topic) {
+	size_t length = strlen(this->ERA_TOPIC);
+	if (!length || strncmp(topic, this->ERA_TOPIC, length)) {
 		return;
 	}
 
-	char copy[MAX_TOPIC_LENGTH] {0};
-	CopyToString(ERaFindStr(topic, BASE_TOPIC) + strlen(BASE_TOPIC) + 1, copy);
-	ERaDataBuff arrayTopic(copy, strlen(copy) + 1, MAX_TOPIC_LENGTH);
-	this->splitString(copy, "/");
-
-	if (arrayTopic.size() < 2) {
+	ERaTopicArgs args;
+	const ERaTopicRouter::Route_t* route = this->topicRouter.match(topic + length, args);
+	if (route == nullptr) {
 		return;
 	}
 
-	if (arrayTopic.at(1) == "pin") {
-		this->processPinRequest(arrayTopic, payload);
-	}
-	else if (arrayTopic.at(1) == "arduino_pin") {
-		Base::processArduinoPinRequest(arrayTopic, payload);
-	}
-	else if (arrayTopic.at(1) == "virtual_pin") {
-		Base::processVirtualPinRequest(arrayTopic, payload);
-	}
-	else if (arrayTopic.at(1) == "down") {
-		this->processDownRequest(arrayTopic, payload);
-	}
+	switch (route->id) {
+		case ERaTopicT::TOPIC_PIN_DOWN:
+			Base::handlePinRequest(payload);
+			break;
+		case ERaTopicT::TOPIC_ARDUINO_PIN:
+			Base::processArduinoPinRequest(ERA_DECODE_PIN_NAME(args.at(0)), payload);
+			break;
+		case ERaTopicT::TOPIC_VIRTUAL_PIN:
+			Base::processVirtualPinRequest(ERA_DECODE_PIN_NAME(args.at(0)), payload);
+			break;
+		case ERaTopicT::TOPIC_DOWN:
+			this->processDownRequest(payload);
+			break;
 #if defined(ERA_ZIGBEE)
-	else if (arrayTopic.at(1) == "zigbee") {
-		this->processZigbeeRequest(arrayTopic, payload);
-	}
+		case ERaTopicT::TOPIC_ZIGBEE_DEVICE:
+			this->processDeviceZigbee(payload);
+			break;
+		case ERaTopicT::TOPIC_ZIGBEE_DOWN: {
+			char ieeeAddr[MAX_TOPIC_LENGTH] {0};
+			args.copy(0, ieeeAddr);
+			this->processActionZigbee(ieeeAddr, payload, ZigbeeActionT::ZIGBEE_ACTION_SET);
+		}
+			break;
 #endif
-}
-
-template <class Transp, class Flash>
-void ERaProto<Transp, Flash>::processPinRequest(const ERaDataBuff& arrayTopic, const char* payload) {
-	if (arrayTopic.at(2) == "down") {
-		Base::handlePinRequest(arrayTopic, payload);
+		default:
+			if (route->callback != nullptr) {
+				route->callback(args, payload);
+			}
+			break;
 	}
 }
 
 template <class Transp, class Flash>
-void ERaProto<Transp, Flash>::processDownRequest(const ERaDataBuff& arrayTopic, const char* payload) {
-	cJSON* root = cJSON_Parse(payload);
-	if (!cJSON_IsObject(root)) {
-		cJSON_Delete(root);
-		root = nullptr;
+void ERaProto<Transp, Flash>::processDownRequest(const char* payload) {
+	ERaJsonReader root(payload);
+	if (!root.isObject()) {
 		return;
 	}
-	
-	cJSON* item = cJSON_GetObjectItem(root, "action");
-	if (cJSON_IsString(item)) {
+
+	ERaJsonReader item = root.get("action");
+	if (item.isString()) {
 		this->processDownAction(payload, root, item);
 	}
-	item = cJSON_GetObjectItem(root, "command");
-	if (cJSON_IsString(item)) {
+	item = root.get("command");
+	if (item.isString()) {
 		this->processDownCommand(payload, root, item);
 	}
-
-	cJSON_Delete(root);
-	root = nullptr;
-	item = nullptr;
-	ERA_FORCE_UNUSED(arrayTopic);
 }
 
 template <class Transp, class Flash>
-void ERaProto<Transp, Flash>::processDownAction(const char* payload, cJSON* root, cJSON* item) {
-	if (ERaStrCmp(item->valuestring, "update_firmware")) {
+void ERaProto<Transp, Flash>::processDownAction(const char* payload, const ERaJsonReader& root, const ERaJsonReader& item) {
+	if (item.equals("update_firmware")) {
 #if defined(ERA_OTA)
 		OTA::begin();
 #endif
 		ERaState::set(StateT::STATE_OTA_UPGRADE);
 	}
-	else if (ERaStrCmp(item->valuestring, "reset_eeprom")) {
+	else if (item.equals("reset_eeprom")) {
 #if defined(ERA_MODBUS)
 		Base::ERaModbus::removeConfigFromFlash();
 #endif
@@ -323,109 +381,101 @@ void ERaProto<Transp, Flash>::processDownAction(const char* payload, cJSON* root
 		ERaDelay(1000);
 		ERaState::set(StateT::STATE_RESET_CONFIG_REBOOT);
 	}
-	else if (ERaStrCmp(item->valuestring, "force_reset")) {
+	else if (item.equals("force_reset")) {
 		ERaRestart(false);
 	}
 #if defined(ERA_MODBUS)
-	else if (ERaStrCmp(item->valuestring, "update_configuration")) {
+	else if (item.equals("update_configuration")) {
 		processActionChip(payload, root, ERaChipCfgT::CHIP_UPDATE_CONFIG);
 	}
-	else if (ERaStrCmp(item->valuestring, "send_control")) {
+	else if (item.equals("send_control")) {
 		processActionChip(payload, root, ERaChipCfgT::CHIP_UPDATE_CONTROL);
 	}
-	else if (ERaStrCmp(item->valuestring, "send_command")) {
+	else if (item.equals("send_command")) {
 		processActionChip(payload, root, ERaChipCfgT::CHIP_CONTROL_ALIAS);
 	}
 #endif
 #if defined(ERA_BT)
-	else if (ERaStrCmp(item->valuestring, "update_bluetooth")) {
+	else if (item.equals("update_bluetooth")) {
 		processActionChip(payload, root, ERaChipCfgT::CHIP_UPDATE_BLUETOOTH);
 	}
 #endif
 }
 
 template <class Transp, class Flash>
-void ERaProto<Transp, Flash>::processActionChip(const char* payload, cJSON* root, uint8_t type) {
-	cJSON* dataItem = cJSON_GetObjectItem(root, "data");
-	if (!cJSON_IsObject(dataItem)) {
+void ERaProto<Transp, Flash>::processActionChip(const char* payload, const ERaJsonReader& root, uint8_t type) {
+	ERaJsonReader dataItem = root.get("data");
+	if (!dataItem.isObject()) {
 		return;
 	}
-	cJSON* item = nullptr;
-	const char* hash = nullptr;
+	ERaJsonReader item;
+	char hash[37] {0};
+	char* config = nullptr;
 	switch (type) {
 #if defined(ERA_MODBUS)
 		case ERaChipCfgT::CHIP_UPDATE_CONFIG:
-			item = cJSON_GetObjectItem(dataItem, "hash_id");
-			if (cJSON_IsString(item)) {
-				hash = item->valuestring;
-			}
-			item = cJSON_GetObjectItem(dataItem, "configuration");
-			if (cJSON_IsString(item)) {
-				Base::ERaModbus::parseModbusConfig(item->valuestring, hash, payload, false);
-			}
-			break;
-		case ERaChipCfgT::CHIP_UPDATE_CONTROL:
-			item = cJSON_GetObjectItem(dataItem, "hash_id");
-			if (cJSON_IsString(item)) {
-				hash = item->valuestring;
-			}
-			item = cJSON_GetObjectItem(dataItem, "control");
-			if (cJSON_IsString(item)) {
-				Base::ERaModbus::parseModbusConfig(item->valuestring, hash, payload, true);
+		case ERaChipCfgT::CHIP_UPDATE_CONTROL: {
+			bool isControl = (type == ERaChipCfgT::CHIP_UPDATE_CONTROL);
+			dataItem.get("hash_id").getString(hash);
+			item = dataItem.get(isControl ? "control" : "configuration");
+			config = item.dupString();
+			if (config != nullptr) {
+				Base::ERaModbus::parseModbusConfig(config, (hash[0] ? hash : nullptr), payload, isControl);
 			}
+		}
 			break;
 		case ERaChipCfgT::CHIP_CONTROL_ALIAS:
-			item = cJSON_GetObjectItem(dataItem, "commands");
-			if (cJSON_IsArray(item)) {
-				cJSON* keyItem = nullptr;
-				for(int i = 0; i < cJSON_GetArraySize(item); ++i) {
-					keyItem = cJSON_GetArrayItem(item, i);
-					if(cJSON_IsString(keyItem)) {
-						// Handle command
-						Base::ERaModbus::addModbusAction(keyItem->valuestring);
-					}
+			item = dataItem.get("commands");
+			for (ERaJsonReader keyItem = item.begin(); keyItem.isValid(); keyItem = keyItem.next()) {
+				char key[37] {0};
+				if (keyItem.getString(key)) {
+					// Handle command
+					Base::ERaModbus::addModbusAction(key);
 				}
 			}
 			break;
 #endif
 #if defined(ERA_BT)
 		case ERaChipCfgT::CHIP_UPDATE_BLUETOOTH:
-			item = cJSON_GetObjectItem(dataItem, "hash_id");
-			if (cJSON_IsString(item)) {
-				hash = item->valuestring;
-			}
-			item = cJSON_GetObjectItem(dataItem, "bluetooth");
-			if (cJSON_IsString(item)) {
-				Base::parseBluetoothConfig(item->valuestring, hash, payload);
+			dataItem.get("hash_id").getString(hash);
+			item = dataItem.get("bluetooth");
+			config = item.dupString();
+			if (config != nullptr) {
+				Base::parseBluetoothConfig(config, (hash[0] ? hash : nullptr), payload);
 			}
 			break;
 #endif
 		default:
 			break;
 	}
+	free(config);
+	config = nullptr;
 	ERA_FORCE_UNUSED(item);
 	ERA_FORCE_UNUSED(hash);
-	ERA_FORCE_UNUSED(dataItem);
 }
 
 template <class Transp, class Flash>
-void ERaProto<Transp, Flash>::processDownCommand(const char* payload, cJSON* root, cJSON* item) {
-	if (ERaStrCmp(item->valuestring, "finalize_configuration")) {
+void ERaProto<Transp, Flash>::processDownCommand(const char* payload, const ERaJsonReader& root, const ERaJsonReader& item) {
+	if (item.equals("finalize_configuration")) {
 		this->processFinalize(payload, root);
 	}
 }
 
 template <class Transp, class Flash>
-void ERaProto<Transp, Flash>::processFinalize(const char* payload, cJSON* root) {
-	const char* hash = nullptr;
-	cJSON* item = cJSON_GetObjectItem(root, "hash_id");
-	if (cJSON_IsString(item)) {
-		hash = item->valuestring;
+void ERaProto<Transp, Flash>::processFinalize(const char* payload, const ERaJsonReader& root) {
+	char hash[37] {0};
+	root.get("hash_id").getString(hash);
+	ERaJsonReader item = root.get("configuration");
+	if (!item.isObject()) {
+		return;
 	}
-	item = cJSON_GetObjectItem(root, "configuration");
-	if (cJSON_IsObject(item)) {
-		this->processConfiguration(payload, hash, item);
+	/* Only the configuration object is turned into a tree */
+	cJSON* config = cJSON_ParseWithLength(item.getRaw(), item.getRawLength());
+	if (cJSON_IsObject(config)) {
+		this->processConfiguration(payload, (hash[0] ? hash : nullptr), config);
 	}
+	cJSON_Delete(config);
+	config = nullptr;
 }
 
 template <class Transp, class Flash>
@@ -480,99 +530,70 @@ void ERaProto<Transp, Flash>::processIOPin(cJSON* root) {
 }
 
 #if defined(ERA_ZIGBEE)
-	template <class Transp, class Flash>
-	void ERaProto<Transp, Flash>::processZigbeeRequest(const ERaDataBuff& arrayTopic, const char* payload) {
-		if (arrayTopic.size() == 3) {
-			if ((arrayTopic.at(2) == "permit_to_join") ||
-				(arrayTopic.at(2) == "remove_device")) {
-				this->processDeviceZigbee(payload);
-				return;
-			}
-		}
-		if (arrayTopic.size() < 4) {
-			return;
-		}
-		if (arrayTopic.at(3) == "down") {
-			this->processActionZigbee(arrayTopic.at(2).getString(), payload, ZigbeeActionT::ZIGBEE_ACTION_SET);
-		}
-	}
-
 	template <class Transp, class Flash>
 	void ERaProto<Transp, Flash>::processDeviceZigbee(const char* payload) {
-		cJSON* root = cJSON_Parse(payload);
-		if (!cJSON_IsObject(root)) {
-			cJSON_Delete(root);
-			root = nullptr;
+		ERaJsonReader root(payload);
+		if (!root.isObject()) {
 			return;
 		}
 
-		cJSON* item = cJSON_GetObjectItem(root, "action");
-		if (item == cJSON_Invalid) {
-			item = cJSON_GetObjectItem(root, "command");
+		ERaJsonReader item = root.get("action");
+		if (!item.isValid()) {
+			item = root.get("command");
 		}
-		if (cJSON_IsString(item)) {
-			if (ERaStrCmp(item->valuestring, "search_device")) {
-				this->processActionDeviceZigbee(root, ZigbeeActionT::ZIGBEE_ACTION_PERMIT_JOIN);
-			}
-			else if (ERaStrCmp(item->valuestring, "remove_zigbee")) {
-				this->processActionDeviceZigbee(root, ZigbeeActionT::ZIGBEE_ACTION_REMOVE_DEVICE);
-			}
+		if (item.equals("search_device")) {
+			this->processActionDeviceZigbee(root, ZigbeeActionT::ZIGBEE_ACTION_PERMIT_JOIN);
+		}
+		else if (item.equals("remove_zigbee")) {
+			this->processActionDeviceZigbee(root, ZigbeeActionT::ZIGBEE_ACTION_REMOVE_DEVICE);
 		}
-
-		cJSON_Delete(root);
-		root = nullptr;
-		item = nullptr;
 	}
 
 	template <class Transp, class Flash>
-	void ERaProto<Transp, Flash>::processActionDeviceZigbee(const cJSON* const root, uint8_t type) {
-		cJSON* data = cJSON_GetObjectItem(root, "data");
-		if (!cJSON_IsObject(root)) {
+	void ERaProto<Transp, Flash>::processActionDeviceZigbee(const ERaJsonReader& root, uint8_t type) {
+		ERaJsonReader data = root.get("data");
+		if (!data.isObject()) {
 			return;
 		}
 
-		cJSON* item = nullptr;
+		ERaJsonReader item;
 		cJSON* payload = nullptr;
+		char ieeeAddr[MAX_TOPIC_LENGTH] {0};
 		switch (type) {
 			case ZigbeeActionT::ZIGBEE_ACTION_PERMIT_JOIN:
-				item = cJSON_GetObjectItem(data, "zigbee");
-				if (cJSON_IsBool(item)) {
+				item = data.get("zigbee");
+				if (item.isBool()) {
 					payload = cJSON_CreateObject();
 					if (payload == nullptr) {
 						break;
 					}
 
-					cJSON_AddBoolToObject(payload, "value", item->valueint);
-					cJSON* ieeeItem = cJSON_GetObjectItem(data, "ieee_addr");
-					if (cJSON_IsString(ieeeItem)) {
-						cJSON_AddStringToObject(payload, "ieee_addr", ieeeItem->valuestring);
+					cJSON_AddBoolToObject(payload, "value", item.getBool());
+					char nwkAddr[MAX_TOPIC_LENGTH] {0};
+					if (data.get("ieee_addr").getString(ieeeAddr)) {
+						cJSON_AddStringToObject(payload, "ieee_addr", ieeeAddr);
 					}
-					cJSON* nwkItem = cJSON_GetObjectItem(data, "nwk_addr");
-					if (cJSON_IsString(nwkItem)) {
-						cJSON_AddStringToObject(payload, "nwk_addr", nwkItem->valuestring);
+					if (data.get("nwk_addr").getString(nwkAddr)) {
+						cJSON_AddStringToObject(payload, "nwk_addr", nwkAddr);
 					}
 
 					if (!Base::Zigbee::addZigbeeAction(ZigbeeActionT::ZIGBEE_ACTION_PERMIT_JOIN, "", payload)) {
 						cJSON_Delete(payload);
 					}
-					ieeeItem = nullptr;
-					nwkItem = nullptr;
 				}
 				break;
 			case ZigbeeActionT::ZIGBEE_ACTION_REMOVE_DEVICE:
-				item = cJSON_GetObjectItem(data, "ieee_addr");
-				if (item == cJSON_Invalid) {
-					item = cJSON_GetObjectItem(data, "ieee_address");
+				item = data.get("ieee_addr");
+				if (!item.isValid()) {
+					item = data.get("ieee_address");
 				}
-				if (cJSON_IsString(item)) {
-					this->processActionZigbee(item->valuestring, "{}", ZigbeeActionT::ZIGBEE_ACTION_REMOVE_DEVICE);
+				if (item.getString(ieeeAddr)) {
+					this->processActionZigbee(ieeeAddr, "{}", ZigbeeActionT::ZIGBEE_ACTION_REMOVE_DEVICE);
 				}
 				break;
 			default:
 				break;
 		}
-		item = nullptr;
-		data = nullptr;
 		payload = nullptr;
 	}
 
@@ -694,15 +715,9 @@ bool ERaProto<Transp, Flash>::sendPinData(ERaRsp_t& rsp) {
 	}
 
 	char name[50] {0};
-	bool status {false};
-	char* payload = nullptr;
 	char topicName[MAX_TOPIC_LENGTH] {0};
 	FormatString(topicName, this->ERA_TOPIC);
 	FormatString(topicName, "/pin/data");
-	cJSON* root = cJSON_CreateObject();
-	if (root == nullptr) {
-		return false;
-	}
 	switch (rsp.type) {
 	case ERaTypeWriteT::ERA_WRITE_VIRTUAL_PIN:
 		FormatString(name, "virtual_pin_%d", rsp.id.getInt());
@@ -717,47 +732,55 @@ bool ERaProto<Transp, Flash>::sendPinData(ERaRsp_t& rsp) {
 		FormatString(name, "pwm_pin_%d", rsp.id.getInt());
 		break;
 	default:
-		cJSON_Delete(root);
-		root = nullptr;
 		return false;
 	}
-	if (rsp.param.isString()) {
-		cJSON_AddStringToObject(root, name, rsp.param.getString());
-	}
-	else if (rsp.param.isNumber()) {
-		cJSON_AddNumberWithDecimalToObject(root, name, rsp.param.getDouble(), 5);
-	}
-	payload = cJSON_PrintUnformatted(root);
-	if (payload != nullptr) {
-		status = this->transp.publishData(topicName, payload, rsp.retained);
-	}
-	cJSON_Delete(root);
-	free(payload);
-	root = nullptr;
-	payload = nullptr;
-	return status;
+	return this->sendValueData(topicName, name, rsp);
 }
 
 template <class Transp, class Flash>
 bool ERaProto<Transp, Flash>::sendConfigIdData(ERaRsp_t& rsp) {
-	bool status {false};
-	char* payload = nullptr;
+	if (this->batchTimeout) {
+		return this->addBatchWrite(rsp);
+	}
 	char topicName[MAX_TOPIC_LENGTH] {0};
 	FormatString(topicName, this->ERA_TOPIC);
 	FormatString(topicName, "/config/%d/value", rsp.id.getInt());
+	return this->sendValueData(topicName, "v", rsp);
+}
+
+template <class Transp, class Flash>
+bool ERaProto<Transp, Flash>::sendValueData(const char* topic, const char* name, ERaRsp_t& rsp) {
+	bool status {false};
+	char buffer[CJSON_BUFFER_SIZE] {0};
+	if (rsp.param.isString()) {
+		status = cJSON_PrintStringObjectPreallocated(name, rsp.param.getString(), buffer, sizeof(buffer));
+	}
+	else if (rsp.param.isNumber()) {
+		status = cJSON_PrintNumberObjectPreallocated(name, rsp.param.getDouble(), 5, buffer, sizeof(buffer));
+	}
+	else {
+		FormatString(buffer, "{}");
+		status = true;
+	}
+	if (status) {
+		return this->transp.publishData(topic, buffer, rsp.retained);
+	}
+
+	/* Value does not fit in the stack buffer, fall back to cJSON */
+	char* payload = nullptr;
 	cJSON* root = cJSON_CreateObject();
 	if (root == nullptr) {
 		return false;
 	}
 	if (rsp.param.isString()) {
-		cJSON_AddStringToObject(root, "v", rsp.param.getString());
+		cJSON_AddStringToObject(root, name, rsp.param.getString());
 	}
 	else if (rsp.param.isNumber()) {
-		cJSON_AddNumberWithDecimalToObject(root, "v", rsp.param.getDouble(), 5);
+		cJSON_AddNumberWithDecimalToObject(root, name, rsp.param.getDouble(), 5);
 	}
 	payload = cJSON_PrintUnformatted(root);
 	if (payload != nullptr) {
-		status = this->transp.publishData(topicName, payload, rsp.retained);
+		status = this->transp.publishData(topic, payload, rsp.retained);
 	}
 	cJSON_Delete(root);
 	free(payload);
@@ -781,6 +804,70 @@ bool ERaProto<Transp, Flash>::sendConfigIdMultiData(ERaRsp_t& rsp) {
 	return status;
 }
 
+template <class Transp, class Flash>
+bool ERaProto<Transp, Flash>::addBatchWrite(ERaRsp_t& rsp) {
+	if (!rsp.param.isString() &&
+		!rsp.param.isNumber()) {
+		return false;
+	}
+
+	bool full {false};
+	char name[2 + 8 * sizeof(int)] {0};
+	FormatString(name, "%d", rsp.id.getInt());
+
+	ERaGuardLock(this->batchMutex);
+	if (this->batchData.isEmpty()) {
+		this->batchMillis = ERaMillis();
+	}
+	this->batchData.remove(name);
+	this->batchData.add(name, rsp.param);
+	full = (this->batchData.size() >= this->batchLimit);
+	ERaGuardUnlock(this->batchMutex);
+
+	if (full) {
+		this->flushBatchWrite();
+	}
+	return true;
+}
+
+template <class Transp, class Flash>
+void ERaProto<Transp, Flash>::runBatchWrite() {
+	if (!this->batchTimeout) {
+		return;
+	}
+
+	bool expired {false};
+	ERaGuardLock(this->batchMutex);
+	if (!this->batchData.isEmpty()) {
+		expired = !ERaRemainingTime(this->batchMillis, this->batchTimeout);
+	}
+	ERaGuardUnlock(this->batchMutex);
+
+	if (expired) {
+		this->flushBatchWrite();
+	}
+}
+
+template <class Transp, class Flash>
+void ERaProto<Transp, Flash>::flushBatchWrite() {
+	ERaGuardLock(this->batchMutex);
+	cJSON* root = this->batchData.detachObject();
+	ERaGuardUnlock(this->batchMutex);
+
+	if (root == nullptr) {
+		return;
+	}
+
+	ERaRsp_t rsp;
+	rsp.type = ERaTypeWriteT::ERA_WRITE_CONFIG_ID_MULTI;
+	rsp.retained = true;
+	rsp.id = 0;
+	rsp.param = root;
+	this->sendConfigIdMultiData(rsp);
+	cJSON_Delete(root);
+	root = nullptr;
+}
+
 template <class Transp, class Flash>
 bool ERaProto<Transp, Flash>::sendModbusData(ERaRsp_t& rsp) {
 	bool status {false};
@@ -826,7 +913,6 @@ void ERaProto<Transp, Flash>::sendCommand(const char* auth, ERaRsp_t& rsp, ApiDa
 		return;
 	}
 
-	char* payload = nullptr;
 	char topicName[MAX_TOPIC_LENGTH] {0};
     FormatString(topicName, "%s/%s", BASE_TOPIC, auth);
 	switch (rsp.type) {
@@ -850,24 +936,7 @@ void ERaProto<Transp, Flash>::sendCommand(const char* auth, ERaRsp_t& rsp, ApiDa
 			return;
 	}
 
-	cJSON* root = cJSON_CreateObject();
-	if (root == nullptr) {
-		return;
-	}
-	if (rsp.param.isString()) {
-		cJSON_AddStringToObject(root, "value", rsp.param.getString());
-	}
-	else if (rsp.param.isNumber()) {
-		cJSON_AddNumberWithDecimalToObject(root, "value", rsp.param.getDouble(), 5);
-	}
-	payload = cJSON_PrintUnformatted(root);
-	if (payload != nullptr) {
-		this->transp.publishData(topicName, payload, rsp.retained);
-	}
-	cJSON_Delete(root);
-	free(payload);
-	root = nullptr;
-	payload = nullptr;
+	this->sendValueData(topicName, "value", rsp);
 }
 
 template <class Transp, class Flash>
@@ -1037,22 +1106,4 @@ void ERaProto<Transp, Flash>::sendCommandModbus(ERaRsp_t& rsp, ERaDataBuff* data
 	root = nullptr;
 }
 
-template <class Transp, class Flash>
-size_t ERaProto<Transp, Flash>::splitString(char* strInput, const char* delims) {
-	if ((strInput == nullptr) ||
-		(delims == nullptr)) {
-		return -1;
-	}
-	if (!strlen(strInput)) {
-		return -1;
-	}
-	size_t size {0};
-    char* token = strtok(strInput, delims);
-	while (token != nullptr) {
-		++size;
-		token = strtok(nullptr, delims);
-	}
-	return size;
-}
-
 #endif /* INC_ERA_PROTOCOL_HPP_ */
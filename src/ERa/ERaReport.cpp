@@ -4,24 +4,35 @@
 using namespace std;
 
 ERaReport::ERaReport()
-	: numReport(0)
+	: report()
+	, heap()
+	, numReport(0)
 {}
 
-void ERaReport::run() {
+MillisTime_t ERaReport::run() {
+	Report_t* due[MAX_REPORTS] {nullptr};
+	size_t numDue {0};
 	unsigned long currentMillis = ERaMillis();
-    const ERaList<Report_t*>::iterator* e = this->report.end();
-    for (ERaList<Report_t*>::iterator* it = this->report.begin(); it != e; it = it->getNext()) {
-		Report_t* pReport = it->get();
+
+	/* Only reports whose deadline has passed are touched */
+	while (this->heap.isDue((MillisTime_t)currentMillis) &&
+		   (numDue < MAX_REPORTS)) {
+		due[numDue++] = this->heap.pop();
+	}
+
+	for (size_t i = 0; i < numDue; ++i) {
+		Report_t* pReport = due[i];
 		if (!this->isValidReport(pReport)) {
 			continue;
 		}
 		if (currentMillis - pReport->prevMillis < pReport->minInterval) {
+			this->schedule(pReport, currentMillis);
 			continue;
 		}
-		if (ERaFloatCompare(pReport->data.value, pReport->data.prevValue) ||
-			abs(pReport->data.value - pReport->data.prevValue) < pReport->reportableChange) {
+		if (!this->isChanged(pReport)) {
 			if ((currentMillis - pReport->prevMillis < pReport->maxInterval) ||
 				(pReport->maxInterval == REPORT_MAX_INTERVAL)) {
+				this->schedule(pReport, currentMillis);
 				continue;
 			}
 		}
@@ -29,6 +40,7 @@ void ERaReport::run() {
 		pReport->prevMillis = currentMillis;
 		// update value
 		pReport->data.prevValue = pReport->data.value;
+		this->schedule(pReport, currentMillis);
         if (!pReport->updated) {
             continue;
         }
@@ -39,10 +51,8 @@ void ERaReport::run() {
         this->setFlag(pReport->called, ReportFlagT::REPORT_ON_CALLED, true);
 	}
 
-    ERaList<Report_t*>::iterator* next = nullptr;
-    for (ERaList<Report_t*>::iterator* it = this->report.begin(); it != e; it = next) {
-        next = it->getNext();
-		Report_t* pReport = it->get();
+	for (size_t i = 0; i < numDue; ++i) {
+		Report_t* pReport = due[i];
 		if (!this->isValidReport(pReport)) {
 			continue;
 		}
@@ -58,15 +68,13 @@ void ERaReport::run() {
 			}
 		}
         if (this->getFlag(pReport->called, ReportFlagT::REPORT_ON_DELETE)) {
-            delete pReport;
-            pReport = nullptr;
-            it->get() = nullptr;
-            this->report.remove(it);
-            this->numReport--;
+			this->removeReport(pReport);
             continue;
         }
 		pReport->called = 0;
 	}
+
+	return this->heap.remaining(ERaMillis());
 }
 
 ERaReport::Report_t* ERaReport::setupReport(unsigned long minInterval, unsigned long maxInterval,
@@ -106,8 +114,10 @@ ERaReport::Report_t* ERaReport::setupReport(unsigned long minInterval, unsigned
 	pReport->enable = true;
 	pReport->updated = false;
 	pReport->called = false;
+	pReport->heapIndex = -1;
 	this->report.put(pReport);
 	this->numReport++;
+	this->schedule(pReport, pReport->prevMillis);
 	return pReport;
 }
 
@@ -149,8 +159,10 @@ ERaReport::Report_t* ERaReport::setupReport(unsigned long minInterval, unsigned
 	pReport->enable = true;
 	pReport->updated = false;
 	pReport->called = false;
+	pReport->heapIndex = -1;
 	this->report.put(pReport);
 	this->numReport++;
+	this->schedule(pReport, pReport->prevMillis);
 	return pReport;
 }
 
@@ -192,8 +204,10 @@ ERaReport::Report_t* ERaReport::setupReport(unsigned long minInterval, unsigned
 	pReport->enable = true;
 	pReport->updated = false;
 	pReport->called = false;
+	pReport->heapIndex = -1;
 	this->report.put(pReport);
 	this->numReport++;
+	this->schedule(pReport, pReport->prevMillis);
 	return pReport;
 }
 
@@ -212,6 +226,7 @@ bool ERaReport::changeReportableChange(Report_t* pReport, unsigned long minInter
 	pReport->reportableChange = minChange;
 	pReport->minInterval = minInterval;
 	pReport->maxInterval = maxInterval;
+	this->schedule(pReport, ERaMillis());
 	return true;
 }
 
@@ -237,6 +252,7 @@ bool ERaReport::changeReportableChange(Report_t* pReport, unsigned long minInter
     pReport->data.pin = pin;
     pReport->data.pinMode = pinMode;
 	pReport->data.configId = configId;
+	this->schedule(pReport, ERaMillis());
     return true;
 }
 
@@ -263,6 +279,7 @@ void ERaReport::updateReport(Report_t* pReport, float value, bool isRound, bool
 		}
     }
 	pReport->updated = true;
+	this->schedule(pReport, ERaMillis());
 }
 
 bool ERaReport::reportEvery(Report_t* pReport, unsigned long interval) {
@@ -274,6 +291,7 @@ bool ERaReport::reportEvery(Report_t* pReport, unsigned long interval) {
 	}
 
 	pReport->maxInterval = interval;
+	this->schedule(pReport, ERaMillis());
 	return true;
 }
 
@@ -284,11 +302,14 @@ void ERaReport::restartReport(Report_t* pReport) {
 
     pReport->updated = false;
     pReport->prevMillis = ERaMillis();
+	this->schedule(pReport, pReport->prevMillis);
 }
 
 void ERaReport::executeNow(Report_t* pReport) {
 	if (this->isValidReport(pReport)) {
-		pReport->prevMillis = ERaMillis() - pReport->maxInterval;
+		unsigned long currentMillis = ERaMillis();
+		pReport->prevMillis = currentMillis - pReport->maxInterval;
+		this->schedule(pReport, currentMillis);
 	}
 }
 
@@ -299,6 +320,8 @@ void ERaReport::deleteReport(Report_t* pReport) {
 
 	if (this->isValidReport(pReport)) {
         this->setFlag(pReport->called, ReportFlagT::REPORT_ON_DELETE, true);
+		/* Due right away so the next run() frees it */
+		this->schedule(pReport, ERaMillis());
 	}
 }
 
@@ -340,6 +363,7 @@ void ERaReport::setScale(Report_t* pReport, float min, float max, float rawMin,
 	pReport->data.scale.rawMax = rawMax;
 	pReport->reportableChange = ERaMapNumberRange(pReport->reportableChange,
 										0.0f, rawMax - rawMin, 0.0f, max - min);
+	this->schedule(pReport, ERaMillis());
 }
 
 ERaReport::ScaleData_t* ERaReport::getScale(Report_t* pReport) {
@@ -378,3 +402,44 @@ bool ERaReport::isReportFree() {
 
 	return true;
 }
+
+bool ERaReport::isChanged(const Report_t* pReport) const {
+	return !(ERaFloatCompare(pReport->data.value, pReport->data.prevValue) ||
+			abs(pReport->data.value - pReport->data.prevValue) < pReport->reportableChange);
+}
+
+void ERaReport::schedule(Report_t* pReport, unsigned long currentMillis) {
+	unsigned long interval = pReport->minInterval;
+	if (this->getFlag(pReport->called, ReportFlagT::REPORT_ON_DELETE)) {
+		interval = 0;
+	}
+	else if (!this->isChanged(pReport)) {
+		if (pReport->maxInterval == REPORT_MAX_INTERVAL) {
+			/* Nothing to do until the value changes */
+			this->heap.remove(pReport);
+			return;
+		}
+		interval = pReport->maxInterval;
+	}
+	unsigned long elapsed = currentMillis - pReport->prevMillis;
+	unsigned long remaining = ((elapsed < interval) ? (interval - elapsed) : 0);
+	if (remaining > ERA_MAX_DEADLINE) {
+		remaining = ERA_MAX_DEADLINE;
+	}
+	this->heap.schedule(pReport, (MillisTime_t)(currentMillis + remaining));
+}
+
+void ERaReport::removeReport(Report_t* pReport) {
+	this->heap.remove(pReport);
+    const ERaList<Report_t*>::iterator* e = this->report.end();
+    for (ERaList<Report_t*>::iterator* it = this->report.begin(); it != e; it = it->getNext()) {
+		if (it->get() == pReport) {
+			it->get() = nullptr;
+			this->report.remove(it);
+			break;
+		}
+	}
+	delete pReport;
+	pReport = nullptr;
+	this->numReport--;
+}
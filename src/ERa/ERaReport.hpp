@@ -7,6 +7,7 @@
 #include <ERa/ERaDefine.hpp>
 #include <ERa/ERaDetect.hpp>
 #include <Utility/ERaQueue.hpp>
+#include <Utility/ERaHeap.hpp>
 
 #if defined(__has_include) &&       \
     __has_include(<functional>) &&  \
@@ -64,6 +65,8 @@ private:
 		bool enable;
 		bool updated;
 		uint8_t called;
+		MillisTime_t deadline;
+		int heapIndex;
 	} Report_t;
 
 public:
@@ -207,7 +210,8 @@ public:
 	~ERaReport()
 	{}
 
-	void run();
+	/* Returns the time in ms until the next report is due */
+	MillisTime_t run();
 
     iterator setReporting(unsigned long minInterval, unsigned long maxInterval,
 						float minChange, ERaReport::ReportCallback_t cb) {
@@ -277,6 +281,9 @@ private:
 	}
 
 	bool isReportFree();
+	bool isChanged(const Report_t* pReport) const;
+	void schedule(Report_t* pReport, unsigned long currentMillis);
+	void removeReport(Report_t* pReport);
 
 	bool isValidReport(const Report_t* pReport) {
         if (pReport == nullptr) {
@@ -299,6 +306,7 @@ private:
     }
 
 	ERaList<Report_t*> report;
+	ERaHeap<Report_t, MAX_REPORTS> heap;
 	unsigned int numReport;
 };
 
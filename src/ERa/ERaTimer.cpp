@@ -4,23 +4,35 @@
 using namespace std;
 
 ERaTimer::ERaTimer()
-    : numTimer(0)
+    : timer()
+    , heap()
+    , numTimer(0)
 {}
 
-void ERaTimer::run() {
+MillisTime_t ERaTimer::run() {
+    Timer_t* due[MAX_TIMERS] {nullptr};
+    size_t numDue {0};
     unsigned long currentMillis = ERaMillis();
-    const ERaList<Timer_t*>::iterator* e = this->timer.end();
-    for (ERaList<Timer_t*>::iterator* it = this->timer.begin(); it != e; it = it->getNext()) {
-        Timer_t* pTimer = it->get();
+
+    /* Only timers whose deadline has passed are touched */
+    while (this->heap.isDue((MillisTime_t)currentMillis) &&
+           (numDue < MAX_TIMERS)) {
+        due[numDue++] = this->heap.pop();
+    }
+
+    for (size_t i = 0; i < numDue; ++i) {
+        Timer_t* pTimer = due[i];
         if (!this->isValidTimer(pTimer)) {
             continue;
         }
         if (currentMillis - pTimer->prevMillis < pTimer->delay) {
+            this->schedule(pTimer, currentMillis);
             continue;
         }
         unsigned long skipTimes = (currentMillis - pTimer->prevMillis) / pTimer->delay;
         // update time
         pTimer->prevMillis += pTimer->delay * skipTimes;
+        this->schedule(pTimer, currentMillis);
         // call callback
         if (!pTimer->enable) {
             continue;
@@ -28,10 +40,8 @@ void ERaTimer::run() {
         this->setFlag(pTimer->called, TimerFlagT::TIMER_ON_CALLED, true);
     }
 
-    ERaList<Timer_t*>::iterator* next = nullptr;
-    for (ERaList<Timer_t*>::iterator* it = this->timer.begin(); it != e; it = next) {
-        next = it->getNext();
-        Timer_t* pTimer = it->get();
+    for (size_t i = 0; i < numDue; ++i) {
+        Timer_t* pTimer = due[i];
         if (!this->isValidTimer(pTimer)) {
             continue;
         }
@@ -52,15 +62,13 @@ void ERaTimer::run() {
             }
         }
         if (this->getFlag(pTimer->called, TimerFlagT::TIMER_ON_DELETE)) {
-            delete pTimer;
-            pTimer = nullptr;
-            it->get() = nullptr;
-            this->timer.remove(it);
-            this->numTimer--;
+            this->removeTimer(pTimer);
             continue;
         }
         pTimer->called = 0;
     }
+
+    return this->heap.remaining(ERaMillis());
 }
 
 ERaTimer::Timer_t* ERaTimer::setupTimer(unsigned long interval, TimerCallback_t cb, unsigned int limit) {
@@ -85,8 +93,10 @@ ERaTimer::Timer_t* ERaTimer::setupTimer(unsigned long interval, TimerCallback_t
     pTimer->enable = true;
     pTimer->called = 0;
     pTimer->prevMillis = ERaMillis();
+    pTimer->heapIndex = -1;
     this->timer.put(pTimer);
     this->numTimer++;
+    this->schedule(pTimer, pTimer->prevMillis);
     return pTimer;
 }
 
@@ -112,8 +122,10 @@ ERaTimer::Timer_t* ERaTimer::setupTimer(unsigned long interval, TimerCallback_p_
     pTimer->enable = true;
     pTimer->called = 0;
     pTimer->prevMillis = ERaMillis();
+    pTimer->heapIndex = -1;
     this->timer.put(pTimer);
     this->numTimer++;
+    this->schedule(pTimer, pTimer->prevMillis);
     return pTimer;
 }
 
@@ -127,18 +139,22 @@ bool ERaTimer::changeInterval(Timer_t* pTimer, unsigned long interval) {
 
     pTimer->delay = interval;
     pTimer->prevMillis = ERaMillis();
+    this->schedule(pTimer, pTimer->prevMillis);
     return true;
 }
 
 void ERaTimer::restartTimer(Timer_t* pTimer) {
     if (this->isValidTimer(pTimer)) {
         pTimer->prevMillis = ERaMillis();
+        this->schedule(pTimer, pTimer->prevMillis);
     }
 }
 
 void ERaTimer::executeNow(Timer_t* pTimer) {
     if (this->isValidTimer(pTimer)) {
-        pTimer->prevMillis = ERaMillis() - pTimer->delay;
+        unsigned long currentMillis = ERaMillis();
+        pTimer->prevMillis = currentMillis - pTimer->delay;
+        this->schedule(pTimer, currentMillis);
     }
 }
 
@@ -149,6 +165,8 @@ void ERaTimer::deleteTimer(Timer_t* pTimer) {
 
     if (this->isValidTimer(pTimer)) {
         this->setFlag(pTimer->called, TimerFlagT::TIMER_ON_DELETE, true);
+        /* Due right away so the next run() frees it */
+        this->schedule(pTimer, ERaMillis());
     }
 }
 
@@ -200,3 +218,31 @@ bool ERaTimer::isTimerFree() {
 
     return true;
 }
+
+void ERaTimer::schedule(Timer_t* pTimer, unsigned long currentMillis) {
+    unsigned long remaining {0};
+    unsigned long elapsed = currentMillis - pTimer->prevMillis;
+    if (!this->getFlag(pTimer->called, TimerFlagT::TIMER_ON_DELETE) &&
+        (elapsed < pTimer->delay)) {
+        remaining = pTimer->delay - elapsed;
+    }
+    if (remaining > ERA_MAX_DEADLINE) {
+        remaining = ERA_MAX_DEADLINE;
+    }
+    this->heap.schedule(pTimer, (MillisTime_t)(currentMillis + remaining));
+}
+
+void ERaTimer::removeTimer(Timer_t* pTimer) {
+    this->heap.remove(pTimer);
+    const ERaList<Timer_t*>::iterator* e = this->timer.end();
+    for (ERaList<Timer_t*>::iterator* it = this->timer.begin(); it != e; it = it->getNext()) {
+        if (it->get() == pTimer) {
+            it->get() = nullptr;
+            this->timer.remove(it);
+            break;
+        }
+    }
+    delete pTimer;
+    pTimer = nullptr;
+    this->numTimer--;
+}
@@ -4,6 +4,7 @@
 #include <ERa/ERaDefine.hpp>
 #include <ERa/ERaDetect.hpp>
 #include <Utility/ERaQueue.hpp>
+#include <Utility/ERaHeap.hpp>
 
 #if defined(__has_include) &&       \
     __has_include(<functional>) &&  \
@@ -37,6 +38,8 @@ class ERaTimer
         void* param;
         bool enable;
         uint8_t called;
+        MillisTime_t deadline;
+        int heapIndex;
     } Timer_t;
 
 public:
@@ -133,7 +136,8 @@ public:
     ~ERaTimer()
     {}
 
-    void run();
+    /* Returns the time in ms until the next timer is due */
+    MillisTime_t run();
 
     iterator setInterval(unsigned long interval, ERaTimer::TimerCallback_t cb) {
         return iterator(this, this->setupTimer(interval, cb, 0));
@@ -174,6 +178,8 @@ private:
     Timer_t* setupTimer(unsigned long interval, ERaTimer::TimerCallback_t cb, unsigned int limit);
     Timer_t* setupTimer(unsigned long interval, ERaTimer::TimerCallback_p_t cb, void* arg, unsigned int limit);
     bool isTimerFree();
+    void schedule(Timer_t* pTimer, unsigned long currentMillis);
+    void removeTimer(Timer_t* pTimer);
 
     bool isValidTimer(const Timer_t* pTimer) {
         if (pTimer == nullptr) {
@@ -196,6 +202,7 @@ private:
     }
 
     ERaList<Timer_t*> timer;
+    ERaHeap<Timer_t, MAX_TIMERS> heap;
     unsigned int numTimer;
 };
 
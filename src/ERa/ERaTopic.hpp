@@ -0,0 +1,247 @@
+#ifndef INC_ERA_TOPIC_HPP_
+#define INC_ERA_TOPIC_HPP_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <ERa/ERaDefine.hpp>
+
+#if defined(__has_include) &&       \
+    __has_include(<functional>) &&  \
+    !defined(ERA_IGNORE_STD_FUNCTIONAL_STRING)
+    #include <functional>
+    #define TOPIC_HAS_FUNCTIONAL_H
+#endif
+
+#if !defined(ERA_MAX_TOPIC_ROUTES)
+    #define ERA_MAX_TOPIC_ROUTES    16
+#endif
+
+#if !defined(ERA_MAX_TOPIC_ARGS)
+    #define ERA_MAX_TOPIC_ARGS      4
+#endif
+
+/* Wildcard levels ('+') captured while matching a topic.
+   Each entry points into the original topic and is not null terminated. */
+class ERaTopicArgs
+{
+    typedef struct __Arg_t {
+        const char* ptr;
+        size_t length;
+    } Arg_t;
+
+public:
+    ERaTopicArgs()
+        : args()
+        , count(0)
+    {}
+    ~ERaTopicArgs()
+    {}
+
+    size_t size() const {
+        return this->count;
+    }
+
+    const char* at(size_t index) const {
+        if (index >= this->count) {
+            return nullptr;
+        }
+        return this->args[index].ptr;
+    }
+
+    size_t length(size_t index) const {
+        if (index >= this->count) {
+            return 0;
+        }
+        return this->args[index].length;
+    }
+
+    bool isNumber(size_t index) const {
+        size_t len = this->length(index);
+        if (!len) {
+            return false;
+        }
+        const char* ptr = this->args[index].ptr;
+        for (size_t i = 0; i < len; ++i) {
+            if ((ptr[i] < '0') || (ptr[i] > '9')) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int getInt(size_t index) const {
+        int value {0};
+        size_t len = this->length(index);
+        const char* ptr = this->at(index);
+        for (size_t i = 0; i < len; ++i) {
+            if ((ptr[i] < '0') || (ptr[i] > '9')) {
+                break;
+            }
+            value = (value * 10) + (ptr[i] - '0');
+        }
+        return value;
+    }
+
+    bool equals(size_t index, const char* str) const {
+        if ((str == nullptr) || (index >= this->count)) {
+            return false;
+        }
+        size_t len = this->args[index].length;
+        return (!strncmp(this->args[index].ptr, str, len) && (str[len] == '\0'));
+    }
+
+    size_t copy(size_t index, char* buf, size_t size) const {
+        if ((buf == nullptr) || !size) {
+            return 0;
+        }
+        size_t len = this->length(index);
+        if (len >= size) {
+            len = size - 1;
+        }
+        if (len) {
+            memcpy(buf, this->args[index].ptr, len);
+        }
+        buf[len] = '\0';
+        return len;
+    }
+
+    template <int size>
+    size_t copy(size_t index, char(&buf)[size]) const {
+        return this->copy(index, buf, size);
+    }
+
+    void clear() {
+        this->count = 0;
+    }
+
+    bool add(const char* ptr, size_t len) {
+        if (this->count >= ERA_MAX_TOPIC_ARGS) {
+            return false;
+        }
+        this->args[this->count].ptr = ptr;
+        this->args[this->count].length = len;
+        this->count++;
+        return true;
+    }
+
+private:
+    Arg_t args[ERA_MAX_TOPIC_ARGS];
+    size_t count;
+};
+
+/* Fixed size table of topic filters ("/virtual_pin/+", "/zigbee/+/down"...).
+   match() walks the topic in place, no copy and no allocation.
+   Routes are bucketed by a hash of their first level so a topic
+   only gets compared against filters that can possibly match. */
+class ERaTopicRouter
+{
+public:
+#if defined(TOPIC_HAS_FUNCTIONAL_H)
+    typedef std::function<void(const ERaTopicArgs&, const char*)> TopicCallback_t;
+#else
+    typedef void (*TopicCallback_t)(const ERaTopicArgs&, const char*);
+#endif
+
+    typedef struct __Route_t {
+        const char* filter;
+        uint32_t hash;
+        int id;
+        ERaTopicRouter::TopicCallback_t callback;
+    } Route_t;
+
+    ERaTopicRouter()
+        : routes()
+        , numRoutes(0)
+    {}
+    ~ERaTopicRouter()
+    {}
+
+    /* filter must stay valid (string literal), it is not copied */
+    bool add(const char* filter, int id, TopicCallback_t cb = nullptr) {
+        if (filter == nullptr) {
+            return false;
+        }
+        if (this->numRoutes >= ERA_MAX_TOPIC_ROUTES) {
+            return false;
+        }
+        Route_t& route = this->routes[this->numRoutes++];
+        route.filter = filter;
+        route.hash = ERaTopicRouter::levelHash(filter);
+        route.id = id;
+        route.callback = cb;
+        return true;
+    }
+
+    const Route_t* match(const char* topic, ERaTopicArgs& args) const {
+        if (topic == nullptr) {
+            return nullptr;
+        }
+        uint32_t hash = ERaTopicRouter::levelHash(topic);
+        for (size_t i = 0; i < this->numRoutes; ++i) {
+            const Route_t& route = this->routes[i];
+            if (route.hash && (route.hash != hash)) {
+                continue;
+            }
+            args.clear();
+            if (ERaTopicRouter::matchFilter(route.filter, topic, args)) {
+                return &route;
+            }
+        }
+        args.clear();
+        return nullptr;
+    }
+
+    size_t size() const {
+        return this->numRoutes;
+    }
+
+protected:
+private:
+    /* FNV-1a of the first level (after the leading '/'), 0 for a wildcard */
+    static uint32_t levelHash(const char* str) {
+        if (*str == '/') {
+            ++str;
+        }
+        if ((*str == '+') || (*str == '#')) {
+            return 0;
+        }
+        uint32_t hash = 2166136261UL;
+        while ((*str != '\0') && (*str != '/')) {
+            hash ^= (uint8_t)(*str++);
+            hash *= 16777619UL;
+        }
+        return (hash ? hash : 1);
+    }
+
+    static bool matchFilter(const char* filter, const char* topic, ERaTopicArgs& args) {
+        while (*filter != '\0') {
+            if (*filter == '#') {
+                return args.add(topic, strlen(topic));
+            }
+            if (*filter == '+') {
+                const char* start = topic;
+                while ((*topic != '\0') && (*topic != '/')) {
+                    ++topic;
+                }
+                if ((topic == start) ||
+                    !args.add(start, (size_t)(topic - start))) {
+                    return false;
+                }
+                ++filter;
+                continue;
+            }
+            if (*filter != *topic) {
+                return false;
+            }
+            ++filter;
+            ++topic;
+        }
+        return (*topic == '\0');
+    }
+
+    Route_t routes[ERA_MAX_TOPIC_ROUTES];
+    size_t numRoutes;
+};
+
+#endif /* INC_ERA_TOPIC_HPP_ */
@@ -14,6 +14,12 @@ void lwmqtt_init(lwmqtt_client_t *client, uint8_t *write_buf, size_t write_buf_s
   client->callback = NULL;
   client->callback_ref = NULL;
 
+  client->ack_callback = NULL;
+  client->ack_callback_ref = NULL;
+
+  client->suback_callback = NULL;
+  client->suback_callback_ref = NULL;
+
   client->network = NULL;
   client->network_read = NULL;
   client->network_write = NULL;
@@ -49,6 +55,16 @@ void lwmqtt_set_callback(lwmqtt_client_t *client, void *ref, lwmqtt_callback_t c
   client->callback = cb;
 }
 
+void lwmqtt_set_ack_callback(lwmqtt_client_t *client, void *ref, lwmqtt_ack_callback_t cb) {
+  client->ack_callback_ref = ref;
+  client->ack_callback = cb;
+}
+
+void lwmqtt_set_suback_callback(lwmqtt_client_t *client, void *ref, lwmqtt_suback_callback_t cb) {
+  client->suback_callback_ref = ref;
+  client->suback_callback = cb;
+}
+
 void lwmqtt_drop_overflow(lwmqtt_client_t *client, bool enabled, uint32_t *counter) {
   client->drop_overflow = enabled;
   client->overflow_counter = counter;
@@ -357,6 +373,51 @@ static lwmqtt_err_t lwmqtt_cycle_once(lwmqtt_client_t *client, size_t *read, lwm
       break;
     }
 
+    // handle puback and pubcomp packets
+    case LWMQTT_PUBACK_PACKET:
+    case LWMQTT_PUBCOMP_PACKET: {
+      // return if nobody tracks acknowledgements
+      if (client->ack_callback == NULL) {
+        break;
+      }
+
+      // decode ack packet
+      uint16_t packet_id;
+      err = lwmqtt_decode_ack(client->read_buf, client->read_buf_size, *packet_type, &packet_id);
+      if (err != LWMQTT_SUCCESS) {
+        return err;
+      }
+
+      // call callback
+      client->ack_callback(client, client->ack_callback_ref, packet_id,
+                           (*packet_type == LWMQTT_PUBACK_PACKET) ? LWMQTT_QOS1 : LWMQTT_QOS2);
+
+      break;
+    }
+
+    // handle suback packets
+    case LWMQTT_SUBACK_PACKET: {
+      // return if nobody tracks subscriptions
+      if (client->suback_callback == NULL) {
+        break;
+      }
+
+      // decode suback packet
+      int suback_count = 0;
+      lwmqtt_qos_t granted_qos[LWMQTT_MAX_SUBACK_CODES];
+      uint16_t packet_id;
+      err = lwmqtt_decode_suback(client->read_buf, client->read_buf_size, &packet_id, LWMQTT_MAX_SUBACK_CODES,
+                                 &suback_count, granted_qos);
+      if (err != LWMQTT_SUCCESS) {
+        return err;
+      }
+
+      // call callback
+      client->suback_callback(client, client->suback_callback_ref, packet_id, suback_count, granted_qos);
+
+      break;
+    }
+
     // handle pingresp packets
     case LWMQTT_PINGRESP_PACKET: {
       // set flag
@@ -409,6 +470,24 @@ lwmqtt_err_t lwmqtt_connect(lwmqtt_client_t *client, lwmqtt_connect_options_t *o
     options = &def_options;
   }
 
+  // send connect packet
+  lwmqtt_err_t err = lwmqtt_connect_start(client, options, will, timeout);
+  if (err != LWMQTT_SUCCESS) {
+    return err;
+  }
+
+  // wait for connack packet
+  return lwmqtt_connect_finish(client, options);
+}
+
+lwmqtt_err_t lwmqtt_connect_start(lwmqtt_client_t *client, lwmqtt_connect_options_t *options, lwmqtt_will_t *will,
+                                  uint32_t timeout) {
+  // ensure default options
+  static lwmqtt_connect_options_t def_options = lwmqtt_default_connect_options;
+  if (options == NULL) {
+    options = &def_options;
+  }
+
   // set command timer
   client->timer_set(client->command_timer, timeout);
 
@@ -433,14 +512,19 @@ lwmqtt_err_t lwmqtt_connect(lwmqtt_client_t *client, lwmqtt_connect_options_t *o
   }
 
   // send packet
-  err = lwmqtt_send_packet_in_buffer(client, len);
-  if (err != LWMQTT_SUCCESS) {
-    return err;
+  return lwmqtt_send_packet_in_buffer(client, len);
+}
+
+lwmqtt_err_t lwmqtt_connect_finish(lwmqtt_client_t *client, lwmqtt_connect_options_t *options) {
+  // ensure default options
+  static lwmqtt_connect_options_t def_options = lwmqtt_default_connect_options;
+  if (options == NULL) {
+    options = &def_options;
   }
 
   // wait for connack packet
   lwmqtt_packet_type_t packet_type = LWMQTT_NO_PACKET;
-  err = lwmqtt_cycle_until(client, &packet_type, 0, LWMQTT_CONNACK_PACKET);
+  lwmqtt_err_t err = lwmqtt_cycle_until(client, &packet_type, 0, LWMQTT_CONNACK_PACKET);
   if (err != LWMQTT_SUCCESS) {
     return err;
   } else if (packet_type != LWMQTT_CONNACK_PACKET) {
@@ -546,19 +630,9 @@ lwmqtt_err_t lwmqtt_publish(lwmqtt_client_t *client, lwmqtt_publish_options_t *o
 
 lwmqtt_err_t lwmqtt_subscribe(lwmqtt_client_t *client, int count, lwmqtt_string_t *topic_filter, lwmqtt_qos_t *qos,
                               uint32_t timeout) {
-  // set command timer
-  client->timer_set(client->command_timer, timeout);
-
-  // encode subscribe packet
-  size_t len;
-  lwmqtt_err_t err = lwmqtt_encode_subscribe(client->write_buf, client->write_buf_size, &len,
-                                             lwmqtt_get_next_packet_id(client), count, topic_filter, qos);
-  if (err != LWMQTT_SUCCESS) {
-    return err;
-  }
-
-  // send packet
-  err = lwmqtt_send_packet_in_buffer(client, len);
+  // send subscribe packet
+  uint16_t packet_id;
+  lwmqtt_err_t err = lwmqtt_subscribe_start(client, count, topic_filter, qos, &packet_id, timeout);
   if (err != LWMQTT_SUCCESS) {
     return err;
   }
@@ -575,7 +649,6 @@ lwmqtt_err_t lwmqtt_subscribe(lwmqtt_client_t *client, int count, lwmqtt_string_
   // decode packet
   int suback_count = 0;
   lwmqtt_qos_t granted_qos[count];
-  uint16_t packet_id;
   err = lwmqtt_decode_suback(client->read_buf, client->read_buf_size, &packet_id, count, &suback_count, granted_qos);
   if (err != LWMQTT_SUCCESS) {
     return err;
@@ -591,6 +664,24 @@ lwmqtt_err_t lwmqtt_subscribe(lwmqtt_client_t *client, int count, lwmqtt_string_
   return LWMQTT_SUCCESS;
 }
 
+lwmqtt_err_t lwmqtt_subscribe_start(lwmqtt_client_t *client, int count, lwmqtt_string_t *topic_filter,
+                                    lwmqtt_qos_t *qos, uint16_t *packet_id, uint32_t timeout) {
+  // set command timer
+  client->timer_set(client->command_timer, timeout);
+
+  // encode subscribe packet
+  size_t len;
+  *packet_id = lwmqtt_get_next_packet_id(client);
+  lwmqtt_err_t err =
+      lwmqtt_encode_subscribe(client->write_buf, client->write_buf_size, &len, *packet_id, count, topic_filter, qos);
+  if (err != LWMQTT_SUCCESS) {
+    return err;
+  }
+
+  // send packet
+  return lwmqtt_send_packet_in_buffer(client, len);
+}
+
 lwmqtt_err_t lwmqtt_subscribe_one(lwmqtt_client_t *client, lwmqtt_string_t topic_filter, lwmqtt_qos_t qos,
                                   uint32_t timeout) {
   return lwmqtt_subscribe(client, 1, &topic_filter, &qos, timeout);
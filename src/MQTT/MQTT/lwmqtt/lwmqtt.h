@@ -7,6 +7,13 @@
 #include <stdlib.h>
 #include "../../../ERa/ERaDefine.hpp"
 
+/**
+ * The most return codes of a suback packet reported to the suback callback.
+ */
+#ifndef LWMQTT_MAX_SUBACK_CODES
+#define LWMQTT_MAX_SUBACK_CODES 32
+#endif
+
 /**
  * The error type used by all exposed APIs.
  *
@@ -215,6 +222,29 @@ typedef int32_t (*lwmqtt_timer_get_t)(void *ref);
  */
 typedef void (*lwmqtt_callback_t)(lwmqtt_client_t *client, void *ref, lwmqtt_string_t str, lwmqtt_message_t msg);
 
+/**
+ * The callback used to report incoming puback and pubcomp packets, so publishes sent with skip_ack can be completed.
+ *
+ * @param client - The client object.
+ * @param ref - A custom reference.
+ * @param packet_id - The acknowledged packet id.
+ * @param qos - LWMQTT_QOS1 for a puback, LWMQTT_QOS2 for a pubcomp.
+ */
+typedef void (*lwmqtt_ack_callback_t)(lwmqtt_client_t *client, void *ref, uint16_t packet_id, lwmqtt_qos_t qos);
+
+/**
+ * The callback used to report incoming suback packets, so subscriptions sent with lwmqtt_subscribe_start() can be
+ * completed.
+ *
+ * @param client - The client object.
+ * @param ref - A custom reference.
+ * @param packet_id - The acknowledged packet id.
+ * @param count - The number of return codes.
+ * @param granted_qos - The granted QOS level or LWMQTT_QOS_FAILURE of each topic filter, in request order.
+ */
+typedef void (*lwmqtt_suback_callback_t)(lwmqtt_client_t *client, void *ref, uint16_t packet_id, int count,
+                                         lwmqtt_qos_t *granted_qos);
+
 /**
  * The client object.
  */
@@ -229,6 +259,12 @@ struct lwmqtt_client_t {
   lwmqtt_callback_t callback;
   void *callback_ref;
 
+  lwmqtt_ack_callback_t ack_callback;
+  void *ack_callback_ref;
+
+  lwmqtt_suback_callback_t suback_callback;
+  void *suback_callback_ref;
+
   void *network;
   lwmqtt_network_read_t network_read;
   lwmqtt_network_write_t network_write;
@@ -285,6 +321,24 @@ void lwmqtt_set_timers(lwmqtt_client_t *client, void *keep_alive_timer, void *co
  */
 void lwmqtt_set_callback(lwmqtt_client_t *client, void *ref, lwmqtt_callback_t cb);
 
+/**
+ * Will set the callback used to receive publish acknowledgements.
+ *
+ * @param client - The client object.
+ * @param ref - A custom reference that will passed to the callback.
+ * @param cb - The callback to be called.
+ */
+void lwmqtt_set_ack_callback(lwmqtt_client_t *client, void *ref, lwmqtt_ack_callback_t cb);
+
+/**
+ * Will set the callback used to receive subscribe acknowledgements.
+ *
+ * @param client - The client object.
+ * @param ref - A custom reference that will passed to the callback.
+ * @param cb - The callback to be called.
+ */
+void lwmqtt_set_suback_callback(lwmqtt_client_t *client, void *ref, lwmqtt_suback_callback_t cb);
+
 /**
  * Will configure the client to drop packets that overflow the read buffer. If a counter is provided it will be
  * incremented with each dropped packet.
@@ -311,6 +365,28 @@ void lwmqtt_drop_overflow(lwmqtt_client_t *client, bool enabled, uint32_t *count
 lwmqtt_err_t lwmqtt_connect(lwmqtt_client_t *client, lwmqtt_connect_options_t *options, lwmqtt_will_t *will,
                             uint32_t timeout);
 
+/**
+ * Will send a connect packet without waiting for the connack response, see lwmqtt_connect_finish().
+ *
+ * @param client - The client object.
+ * @param options - The optional connect options.
+ * @param will - The will object.
+ * @param timeout - The command timeout.
+ * @return An error value.
+ */
+lwmqtt_err_t lwmqtt_connect_start(lwmqtt_client_t *client, lwmqtt_connect_options_t *options, lwmqtt_will_t *will,
+                                  uint32_t timeout);
+
+/**
+ * Will read the connack response to a connect packet sent with lwmqtt_connect_start(). Should be called once data is
+ * available on the network, the return code and whether a session was present are stored in the options.
+ *
+ * @param client - The client object.
+ * @param options - The optional connect options.
+ * @return An error value.
+ */
+lwmqtt_err_t lwmqtt_connect_finish(lwmqtt_client_t *client, lwmqtt_connect_options_t *options);
+
 /**
  * Will send a publish packet and wait for all acks to complete. If the encoded packet (without payload) is bigger than
  * the write buffer the function will return LWMQTT_BUFFER_TOO_SHORT without attempting to send the packet.
@@ -346,6 +422,20 @@ lwmqtt_err_t lwmqtt_publish(lwmqtt_client_t *client, lwmqtt_publish_options_t *o
 lwmqtt_err_t lwmqtt_subscribe(lwmqtt_client_t *client, int count, lwmqtt_string_t *topic_filter, lwmqtt_qos_t *qos,
                               uint32_t timeout);
 
+/**
+ * Will send a subscribe packet without waiting for the suback, which is reported to the suback callback.
+ *
+ * @param client - The client object.
+ * @param count - The number of topic filters and QOS levels.
+ * @param topic_filter - The list of topic filters.
+ * @param qos - The list of QOS levels.
+ * @param packet_id - Variable that is set with the used packet id.
+ * @param timeout - The command timeout.
+ * @return An error value.
+ */
+lwmqtt_err_t lwmqtt_subscribe_start(lwmqtt_client_t *client, int count, lwmqtt_string_t *topic_filter,
+                                    lwmqtt_qos_t *qos, uint16_t *packet_id, uint32_t timeout);
+
 /**
  * Will send a subscribe packet with a single topic filter plus QOS level and wait for the suback to complete.
  *
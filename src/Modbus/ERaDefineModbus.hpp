@@ -24,10 +24,10 @@
 #define HI_WORD(a)                      (((a) >> 8) & 0xFF)
 #define LO_WORD(a)                      ((a) & 0xFF)
 
-#define LOC_BUFFER_MODBUS(len)                      \
+#define LOC_BUFFER_MODBUS(size)                     \
     uint8_t locData[32] {0};                        \
     uint8_t* pData = locData;                       \
-    uint16_t pDataLen = request->getLength() * len; \
+    uint16_t pDataLen = size;                       \
     if (pDataLen > sizeof(locData)) {               \
         pData = (uint8_t*)malloc(pDataLen);         \
         if (pData == nullptr) {                     \
@@ -54,6 +54,20 @@ enum ModbusFunctionT : uint8_t {
     PRESET_MULTIPLE_REGISTERS = 0x10
 };
 
+/* Value type of a decoded point, or'ed with the order flags.
+   32 bit values default to big endian, high word first */
+enum ModbusDataTypeT : uint8_t {
+    MODBUS_TYPE_BIT = 0x00,
+    MODBUS_TYPE_INT16 = 0x01,
+    MODBUS_TYPE_UINT16 = 0x02,
+    MODBUS_TYPE_INT32 = 0x03,
+    MODBUS_TYPE_UINT32 = 0x04,
+    MODBUS_TYPE_FLOAT32 = 0x05,
+    MODBUS_TYPE_MASK = 0x0F,
+    MODBUS_WORD_SWAP = 0x40,
+    MODBUS_BYTE_SWAP = 0x80
+};
+
 enum ModbusTransportT : uint8_t {
     MODBUS_TRANSPORT_RTU = 0x00,
     MODBUS_TRANSPORT_TCP = 0x01
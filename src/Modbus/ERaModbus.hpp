@@ -4,11 +4,14 @@
 #include <math.h>
 #include <ERa/ERaParam.hpp>
 #include <Utility/ERaUtility.hpp>
+#include <Utility/ERaJsonReader.hpp>
 #include <Modbus/ERaModbusState.hpp>
 #include <Modbus/ERaParse.hpp>
 #include <Modbus/ERaModbusConfig.hpp>
 #include <Modbus/ERaDefineModbus.hpp>
 #include <Modbus/ERaModbusTransp.hpp>
+#include <Modbus/ERaModbusHealth.hpp>
+#include <Modbus/ERaModbusPoint.hpp>
 
 using namespace std;
 
@@ -19,10 +22,23 @@ class ERaModbus
     typedef struct __ModbusAction_t {
         char* key;
     } ModbusAction_t;
-    typedef struct __TCPIp_t {
-        IPAddress ip;
+    typedef struct __TCPClient_t {
+        Client* client;
+        uint32_t ip;
         uint16_t port;
-    } TCPIp_t;
+        bool owned;
+        MillisTime_t usedMillis;
+        MillisTime_t retryMillis;
+        MillisTime_t backoff;
+    } TCPClient_t;
+    /* MBAP header: transaction id, protocol id, length */
+    typedef struct __MBAPReader_t {
+        Stream* stream;
+        uint8_t header[6];
+        size_t position;
+        uint16_t remain;
+        ERaModbusResponse* response;
+    } MBAPReader_t;
     typedef void* TaskHandle_t;
     typedef void* QueueMessage_t;
     const char* TAG = "Modbus";
@@ -32,12 +48,19 @@ class ERaModbus
 
     friend class ERaModbusTransp < ERaModbus<Api> >;
 	typedef ERaModbusTransp < ERaModbus<Api> > ModbusTransp;
+    typedef ERaModbusHealth::SlaveHealth_t SlaveHealth_t;
 
 public:
     ERaModbus()
         : modbusConfig(ERaApplication::config())
         , modbusControl(ERaApplication::control())
         , timeout(DEFAULT_TIMEOUT_MODBUS)
+        , maxTimeout(DEFAULT_TIMEOUT_MODBUS)
+        , health()
+        , points()
+        , inflight(ERA_MODBUS_TCP_INFLIGHT)
+        , pipelineSlaves(ERA_MODBUS_TCP_PIPELINE_SLAVES)
+        , frameMillis(0)
         , prevMillis(0)
         , total(0)
         , failRead(0)
@@ -45,11 +68,8 @@ public:
         , dePin(-1)
         , transp(0)
         , streamRTU(NULL)
-        , clientTCP(NULL)
-        , ip {
-            .ip = {},
-            .port = 502
-        }
+        , clientsTCP()
+        , numClients(0)
         , stream(NULL)
         , _streamDefault(false)
         , _modbusTask(NULL)
@@ -60,20 +80,51 @@ public:
     ~ERaModbus()
     {
         this->switchToModbusRTU();
+        for (uint8_t i = 0; i < this->numClients; ++i) {
+            this->releaseTCPClient(this->clientsTCP[i]);
+        }
     }
 
     void setModbusClient(Client& _client, IPAddress _ip = IPAddress(0, 0, 0, 0), uint16_t _port = 502) {
-        this->clientTCP = &_client;
-        this->ip.ip = _ip;
-        this->ip.port = _port;
+        this->setTCPClient(0, &_client, _ip, _port, false);
+    }
+
+    /* Extra connection for the TCP pool, so reads to
+       different slaves do not reconnect each other */
+    bool addModbusClient(Client& _client) {
+        if (this->numClients >= ERA_MODBUS_MAX_TCP_CLIENTS) {
+            return false;
+        }
+        this->setTCPClient(this->numClients, &_client, 0, 0, false);
+        return true;
     }
 
     void setModbusStream(Stream& _stream) {
         this->streamRTU = &_stream;
     }
 
+    /* Upper bound, each slave waits less once its replies are known */
     void setModbusTimeout(uint32_t _timeout) {
         this->timeout = _timeout;
+        this->maxTimeout = _timeout;
+    }
+
+    /* Outstanding reads per Modbus TCP slave, the slave
+       must accept pipelined requests */
+    void setModbusPipeline(uint8_t depth) {
+        if (!depth) {
+            depth = 1;
+        }
+        else if (depth > ERA_MODBUS_MAX_INFLIGHT) {
+            depth = ERA_MODBUS_MAX_INFLIGHT;
+        }
+        this->inflight = depth;
+    }
+
+    /* Reads to different slaves in flight together,
+       each on its own connection of the pool */
+    void setModbusPipelineSlaves(bool enable) {
+        this->pipelineSlaves = enable;
     }
 
     void setPubModbusInterval(uint32_t _interval) {
@@ -85,6 +136,18 @@ public:
 
     void setModbusDEPin(int _pin);
 
+    /* Publish a typed value out of read config readId on configId
+       whenever it moves by minChange, at most every minInterval
+       and at least every maxInterval (ms). The raw data is then
+       only sent on the publish interval */
+    bool addModbusPoint(int readId, uint16_t index, uint8_t type, unsigned int configId,
+                        float scale = 1.0f, float offset = 0.0f, float minChange = 0.0f,
+                        unsigned long minInterval = 1000UL,
+                        unsigned long maxInterval = DEFAULT_PUB_MODBUS_INTERVAL) {
+        return (this->points.add(readId, index, type, configId, scale, offset, minChange,
+                                minInterval, maxInterval, ERaModbus::sendPointEvent, this) != nullptr);
+    }
+
 protected:
     void begin() {
         ERaApplication::getConfig();
@@ -109,7 +172,7 @@ protected:
 
     void runRead() {
         ModbusState::set(ModbusStateT::STATE_MB_RUNNING);
-        if (!ERaRemainingTime(this->modbusConfig->modbusInterval.prevMillis, this->modbusConfig->modbusInterval.delay)) {
+        if (!ERaRemainingTime((MillisTime_t)this->modbusConfig->modbusInterval.prevMillis, this->modbusConfig->modbusInterval.delay)) {
             this->modbusConfig->modbusInterval.prevMillis = ERaMillis();
             this->readModbusConfig();
         }
@@ -211,60 +274,271 @@ private:
         ptr = nullptr;
     }
 
-    void updateConfig(ERaApplication* config, const char* buf, const char* name) {
-        cJSON* root = cJSON_Parse(buf);
-        if (!cJSON_IsObject(root)) {
-            cJSON_Delete(root);
-            root = nullptr;
+    void updateConfig(ERaApplication* config, char* buf, const char* name) {
+        ERaJsonReader root(buf);
+        ERaJsonReader data = root.get("data");
+        if (!data.isObject()) {
             return;
         }
 
-        cJSON* data = cJSON_GetObjectItem(root, "data");
-        cJSON* item = cJSON_GetObjectItem(data, "hash_id");
-        if (cJSON_IsString(item)) {
-            config->updateHashID(item->valuestring);
+        char hash[37] {0};
+        if (data.get("hash_id").getString(hash)) {
+            config->updateHashID(hash);
         }
-        item = cJSON_GetObjectItem(data, name);
-        if (cJSON_IsString(item)) {
-            config->parseConfig(item->valuestring);
+        /* Unescaped in place, buf is not parsed again */
+        ERaJsonReader item = data.get(name);
+        if (item.isString()) {
+            config->parseConfig(item.getStringInSitu());
         }
-
-        cJSON_Delete(root);
-        root = nullptr;
     }
 
     void nextTransport(const ModbusConfig_t& param) {
         this->switchToModbusRTU();
-        if (this->clientTCP == nullptr) {
+        if (!param.ipSlave.ip.dword ||
+            !this->maxTCPClients()) {
             return;
         }
-        if (param.ipSlave.ip.dword) {
-            this->switchToModbusTCP();
+        int index = this->findTCPClient(param, 0);
+        this->switchToModbusTCP((index < 0) ? nullptr : this->openTCPClient(index, param));
+    }
+
+    void switchToModbusRTU() {
+        this->stream = this->streamRTU;
+        this->transp = ModbusTransportT::MODBUS_TRANSPORT_RTU;
+    }
+
+    /* A null client fails the request without waiting */
+    void switchToModbusTCP(Client* client) {
+        this->stream = client;
+        this->transp = ModbusTransportT::MODBUS_TRANSPORT_TCP;
+    }
+
+    void selectStream(Stream* _stream) {
+        this->stream = _stream;
+    }
+
+    bool isPipelined(const ModbusConfig_t& param) {
+        if (!this->maxTCPClients() ||
+            (param.groupCount > 1) ||
+            !param.ipSlave.ip.dword) {
+            return false;
+        }
+        if ((this->inflight < 2) &&
+            (!this->pipelineSlaves || (this->maxTCPClients() < 2))) {
+            return false;
         }
-        if ((ip.ip == IPAddress(param.ipSlave.ip.dword)) ||
-            (param.ipSlave.ip.dword == 0)) {
+        return ((param.func >= ModbusFunctionT::READ_COIL_STATUS) &&
+                (param.func <= ModbusFunctionT::READ_INPUT_REGISTERS));
+    }
+
+    size_t maxTCPClients() const {
+#if defined(ERA_MODBUS_TCP_AUTO_CLIENT)
+        return ERA_MODBUS_MAX_TCP_CLIENTS;
+#else
+        return this->numClients;
+#endif
+    }
+
+    static uint16_t getSlavePort(const ModbusConfig_t& param) {
+        return (param.ipSlave.port ? param.ipSlave.port : 502);
+    }
+
+    static bool isSameSlave(const ModbusConfig_t& a, const ModbusConfig_t& b) {
+        return ((a.ipSlave.ip.dword == b.ipSlave.ip.dword) &&
+                (getSlavePort(a) == getSlavePort(b)));
+    }
+
+    void setTCPClient(uint8_t index, Client* client, uint32_t _ip, uint16_t _port, bool owned) {
+        if (index >= ERA_MODBUS_MAX_TCP_CLIENTS) {
             return;
         }
-        if (param.ipSlave.port == 0) {
+        if (index < this->numClients) {
+            this->releaseTCPClient(this->clientsTCP[index]);
+        }
+        else {
+            index = this->numClients++;
+        }
+        TCPClient_t& entry = this->clientsTCP[index];
+        entry.client = client;
+        entry.ip = _ip;
+        entry.port = _port;
+        entry.owned = owned;
+        entry.usedMillis = ERaMillis();
+        entry.retryMillis = entry.usedMillis;
+        entry.backoff = 0;
+    }
+
+    void releaseTCPClient(TCPClient_t& entry) {
+        if (entry.client == nullptr) {
             return;
         }
-        ip.ip = param.ipSlave.ip.dword;
-        ip.port = param.ipSlave.port;
-        // TODO
-        if (this->clientTCP->connected()) {
-            this->clientTCP->stop();
+        if (this->stream == entry.client) {
+            this->stream = NULL;
         }
-        this->clientTCP->connect(ip.ip, ip.port);
+        if (entry.owned) {
+            delete entry.client;
+        }
+        entry.client = nullptr;
     }
 
-    void switchToModbusRTU() {
-        this->stream = this->streamRTU;
-        this->transp = ModbusTransportT::MODBUS_TRANSPORT_RTU;
+    /* Connection bound to the slave, else a free one, else the one
+       idle for the longest time that is not in the busy mask */
+    int findTCPClient(const ModbusConfig_t& param, uint32_t busy) {
+        int index {-1};
+        uint16_t port = getSlavePort(param);
+        for (uint8_t i = 0; i < this->numClients; ++i) {
+            if ((this->clientsTCP[i].ip == param.ipSlave.ip.dword) &&
+                (this->clientsTCP[i].port == port)) {
+                return i;
+            }
+        }
+        for (uint8_t i = 0; i < this->numClients; ++i) {
+            if (!this->clientsTCP[i].ip) {
+                return i;
+            }
+        }
+#if defined(ERA_MODBUS_TCP_AUTO_CLIENT)
+        if (this->numClients < ERA_MODBUS_MAX_TCP_CLIENTS) {
+            Client* client = this->createTCPClient();
+            if (client != nullptr) {
+                this->setTCPClient(this->numClients, client, 0, 0, true);
+                return (this->numClients - 1);
+            }
+        }
+#endif
+        MillisTime_t now = ERaMillis();
+        for (uint8_t i = 0; i < this->numClients; ++i) {
+            if (busy & (1UL << i)) {
+                continue;
+            }
+            if ((index < 0) ||
+                ((MillisTime_t)(now - this->clientsTCP[i].usedMillis) >
+                (MillisTime_t)(now - this->clientsTCP[index].usedMillis))) {
+                index = i;
+            }
+        }
+        return index;
     }
 
-    void switchToModbusTCP() {
-        this->stream = this->clientTCP;
-        this->transp = ModbusTransportT::MODBUS_TRANSPORT_TCP;
+    /* Reconnect lazily, a slave that refused the last connect
+       is skipped until its backoff expires */
+    Client* openTCPClient(int index, const ModbusConfig_t& param) {
+        TCPClient_t& entry = this->clientsTCP[index];
+        uint16_t port = getSlavePort(param);
+        entry.usedMillis = ERaMillis();
+        if ((entry.ip != param.ipSlave.ip.dword) ||
+            (entry.port != port)) {
+            if (entry.client->connected()) {
+                entry.client->stop();
+            }
+            entry.ip = param.ipSlave.ip.dword;
+            entry.port = port;
+            entry.backoff = 0;
+        }
+        if (entry.client->connected()) {
+            return entry.client;
+        }
+        if (ERaRemainingTime(entry.retryMillis, entry.backoff)) {
+            return nullptr;
+        }
+        if (entry.client->connect(IPAddress(entry.ip), entry.port)) {
+            entry.backoff = 0;
+            return entry.client;
+        }
+        entry.retryMillis = ERaMillis();
+        entry.backoff = (entry.backoff ? (entry.backoff * 2) : ERA_MODBUS_TCP_RETRY_MS);
+        if (entry.backoff > ERA_MODBUS_TCP_BACKOFF_MS) {
+            entry.backoff = ERA_MODBUS_TCP_BACKOFF_MS;
+        }
+        return nullptr;
+    }
+
+    /* RTU inter-frame gap: 3.5 characters of 11 bits,
+       fixed to 1.75 ms above 19200 baud */
+    MillisTime_t frameGap() {
+        if (this->transp != ModbusTransportT::MODBUS_TRANSPORT_RTU) {
+            return 0;
+        }
+        uint32_t baud = this->modbusConfig->baudSpeed;
+        if (!baud) {
+            baud = MODBUS_BAUDRATE;
+        }
+        if (baud > 19200) {
+            return 2;
+        }
+        return (MillisTime_t)((38500UL + baud - 1) / baud);
+    }
+
+    void waitFrameGap() {
+        MillisTime_t remain = ERaRemainingTime(this->frameMillis, this->frameGap());
+        if (remain) {
+            ERaDelay(remain);
+        }
+    }
+
+    SlaveHealth_t* getSlave(const ModbusConfig_t& param) {
+        if (!param.ipSlave.ip.dword) {
+            return this->health.get(0, 0, param.addr);
+        }
+        return this->health.get(param.ipSlave.ip.dword, getSlavePort(param), param.addr);
+    }
+
+    /* RTU time on the wire of request and reply, 11 bits a character */
+    MillisTime_t wireTime(const ModbusConfig_t& param) {
+        if (param.ipSlave.ip.dword) {
+            return 0;
+        }
+        uint32_t baud = this->modbusConfig->baudSpeed;
+        if (!baud) {
+            baud = MODBUS_BAUDRATE;
+        }
+        uint16_t length = BUILD_WORD(param.len1, param.len2);
+        uint32_t bytes {16};
+        switch (param.func) {
+            case ModbusFunctionT::READ_COIL_STATUS:
+            case ModbusFunctionT::READ_INPUT_STATUS:
+            case ModbusFunctionT::FORCE_MULTIPLE_COILS:
+                bytes = (uint32_t)(13UL + ((length + 7UL) / 8UL));
+                break;
+            case ModbusFunctionT::READ_HOLDING_REGISTERS:
+            case ModbusFunctionT::READ_INPUT_REGISTERS:
+            case ModbusFunctionT::PRESET_MULTIPLE_REGISTERS:
+                bytes = (uint32_t)(13UL + (length * 2UL));
+                break;
+            default:
+                break;
+        }
+        return (MillisTime_t)(((bytes * 11000UL) + baud - 1) / baud);
+    }
+
+    void setSlaveTimeout(const SlaveHealth_t* slave, MillisTime_t wire) {
+        this->timeout = this->health.timeout(slave, wire, this->maxTimeout);
+    }
+
+    void updateSlave(SlaveHealth_t* slave, const ModbusConfig_t& param, bool status) {
+        if (status) {
+            if (this->health.success(slave)) {
+                ERA_LOG(TAG, ERA_PSTR("Slave %d back online"), param.addr);
+            }
+        }
+        else if (this->health.failure(slave)) {
+            ERA_LOG(TAG, ERA_PSTR("Slave %d not responding, probe every %dms"),
+                    param.addr, (int)this->health.probeDelay(slave));
+        }
+    }
+
+    /* Reply time past the wire time feeds the slave timeout */
+    void sampleSlave(SlaveHealth_t* slave, MillisTime_t elapsed, MillisTime_t wire) {
+        this->health.sample(slave, ((elapsed > wire) ? (elapsed - wire) : 0));
+    }
+
+    static void sendPointEvent(void* args) {
+        ModbusPoint_t* point = (ModbusPoint_t*)args;
+        if ((point == nullptr) ||
+            (point->owner == nullptr)) {
+            return;
+        }
+        static_cast<ERaModbus*>(point->owner)->thisApi().configIdWrite(point->configId, point->value);
     }
 
     void configModbus();
@@ -277,16 +551,30 @@ private:
     bool actionModbus(const char* key);
     bool eachActionModbus(Action_t& action, ModbusConfig_t*& config);
     void sendModbusRead(ModbusConfig_t& param);
+    ERaList<ModbusConfig_t*>::iterator* sendModbusReadGroup(ERaList<ModbusConfig_t*>::iterator* it,
+                                                            const ERaList<ModbusConfig_t*>::iterator* e);
+    ERaList<ModbusConfig_t*>::iterator* sendModbusReadMulti(ERaList<ModbusConfig_t*>::iterator* it,
+                                                            const ERaList<ModbusConfig_t*>::iterator* e);
     bool sendModbusWrite(ModbusConfig_t& param);
     void onData(ERaModbusRequest* request, ERaModbusResponse* response);
     void onError(ERaModbusRequest* request);
+    void addData(int readId, uint8_t function, ERaModbusResponse* response, uint16_t offset, uint16_t length);
+    void addError(uint8_t function, uint16_t length);
     bool waitResponse(ERaModbusResponse* response);
+    void waitResponses(ERaModbusResponse** responses, Stream** streams, MillisTime_t* elapsed, size_t count);
+    ERaModbusResponse* readMBAP(MBAPReader_t& reader, uint8_t value, ERaModbusResponse** responses,
+                                Stream** streams, size_t count);
+    ERaModbusResponse* findResponse(ERaModbusResponse** responses, Stream** streams, size_t count,
+                                    const Stream* _stream, uint16_t packetId);
+#if defined(ERA_MODBUS_TCP_AUTO_CLIENT)
+    Client* createTCPClient();
+#endif
     void sendCommand(uint8_t* data, size_t size);
     void switchToTransmit();
     void switchToReceive();
 
     void waitTCPIpReady() {
-        if (this->clientTCP == nullptr) {
+        if (!this->numClients) {
             return;
         }
         do {
@@ -333,6 +621,12 @@ private:
     ERaApplication*& modbusConfig;
     ERaApplication*& modbusControl;
     uint32_t timeout;
+    uint32_t maxTimeout;
+    ERaModbusHealth health;
+    ERaModbusPoints points;
+    uint8_t inflight;
+    bool pipelineSlaves;
+    MillisTime_t frameMillis;
     unsigned long prevMillis;
     int total;
     int failRead;
@@ -340,8 +634,8 @@ private:
     int dePin;
     uint8_t transp;
     Stream* streamRTU;
-    Client* clientTCP;
-    TCPIp_t ip;
+    TCPClient_t clientsTCP[ERA_MODBUS_MAX_TCP_CLIENTS];
+    uint8_t numClients;
     Stream* stream;
     bool _streamDefault;
     TaskHandle_t _modbusTask;
@@ -357,13 +651,23 @@ void ERaModbus<Api>::readModbusConfig() {
     }
     this->dataBuff.clear();
     const ERaList<ModbusConfig_t*>::iterator* e = this->modbusConfig->modbusConfigParam.end();
-    for (ERaList<ModbusConfig_t*>::iterator* it = this->modbusConfig->modbusConfigParam.begin(); it != e; it = it->getNext()) {
+    for (ERaList<ModbusConfig_t*>::iterator* it = this->modbusConfig->modbusConfigParam.begin(); it != e;) {
         ModbusConfig_t* param = it->get();
         if (param == nullptr) {
+            it = it->getNext();
             continue;
         }
         ERaGuardLock(this->mutex);
-        this->sendModbusRead(*param);
+        if (param->groupCount > 1) {
+            it = this->sendModbusReadGroup(it, e);
+        }
+        else if (this->isPipelined(*param)) {
+            it = this->sendModbusReadMulti(it, e);
+        }
+        else {
+            this->sendModbusRead(*param);
+            it = it->getNext();
+        }
         ERaGuardUnlock(this->mutex);
         this->delayModbus(param->addr);
         if (ModbusState::is(ModbusStateT::STATE_MB_PARSE) ||
@@ -372,10 +676,12 @@ void ERaModbus<Api>::readModbusConfig() {
             return;
         }
     }
+    this->points.run();
     if (this->dataBuff.isEmpty()) {
         return;
     }
-    if (this->dataBuff.isChange()) {
+    /* Changes already went out as points */
+    if (this->dataBuff.isChange() && !this->points.size()) {
         this->prevMillis = ERaMillis();
     }
     else if (!this->checkPubDataInterval()) {
@@ -398,7 +704,8 @@ bool ERaModbus<Api>::checkPubDataInterval() {
 
 template <class Api>
 void ERaModbus<Api>::delayModbus(const int address) {
-    MillisTime_t delayMs {10L};
+    /* Back to back by default, sendModbusRead/Write keep the frame gap */
+    MillisTime_t delayMs {0};
     MillisTime_t startMillis = ERaMillis();
     const ERaList<SensorDelay_t*>::iterator* e = this->modbusConfig->sensorDelay.end();
     for (ERaList<SensorDelay_t*>::iterator* it = this->modbusConfig->sensorDelay.begin(); it != e; it = it->getNext()) {
@@ -410,6 +717,9 @@ void ERaModbus<Api>::delayModbus(const int address) {
             break;
         }
     }
+    if (!delayMs) {
+        return;
+    }
     do {
 #if defined(ERA_NO_RTOS)
         ERaOnWaiting();
@@ -497,7 +807,22 @@ bool ERaModbus<Api>::eachActionModbus(Action_t& action, ModbusConfig_t*& config)
 template <class Api>
 void ERaModbus<Api>::sendModbusRead(ModbusConfig_t& param) {
     bool status {false};
+    if ((param.func < ModbusFunctionT::READ_COIL_STATUS) ||
+        (param.func > ModbusFunctionT::READ_INPUT_REGISTERS)) {
+        return;
+    }
+    SlaveHealth_t* slave = this->getSlave(param);
+    if (!this->health.allow(slave)) {
+        /* Slave offline, keep the data slot without waiting */
+        this->addError(param.func, BUILD_WORD(param.len1, param.len2));
+        param.totalFail++;
+        return;
+    }
+    MillisTime_t wire = this->wireTime(param);
+    this->setSlaveTimeout(slave, wire);
     this->nextTransport(param);
+    this->waitFrameGap();
+    MillisTime_t startMillis = ERaMillis();
     switch (param.func) {
         case ModbusFunctionT::READ_COIL_STATUS:
             status = ModbusTransp::readCoilStatus(this->transp, param);
@@ -514,8 +839,11 @@ void ERaModbus<Api>::sendModbusRead(ModbusConfig_t& param) {
         default:
             return;
     }
+    this->frameMillis = ERaMillis();
+    this->updateSlave(slave, param, status);
 
     if (status) {
+        this->sampleSlave(slave, this->frameMillis - startMillis, wire);
         param.totalFail = 0;
     }
     else {
@@ -524,10 +852,161 @@ void ERaModbus<Api>::sendModbusRead(ModbusConfig_t& param) {
     }
 }
 
+/* One request for a coalesced range, the reply is split back
+   into the data slot of every config in the group */
+template <class Api>
+ERaList<ModbusConfig_t*>::iterator* ERaModbus<Api>::sendModbusReadGroup(ERaList<ModbusConfig_t*>::iterator* it,
+                                                                        const ERaList<ModbusConfig_t*>::iterator* e) {
+    bool status {false};
+    ModbusConfig_t* head = it->get();
+    ModbusConfig_t param = *head;
+    param.sa1 = HI_WORD(head->groupStart);
+    param.sa2 = LO_WORD(head->groupStart);
+    param.len1 = HI_WORD(head->groupLen);
+    param.len2 = LO_WORD(head->groupLen);
+
+    /* Slave offline, keep the data slots without waiting */
+    SlaveHealth_t* slave = this->getSlave(param);
+    bool skip = !this->health.allow(slave);
+    MillisTime_t wire = this->wireTime(param);
+    if (!skip) {
+        this->setSlaveTimeout(slave, wire);
+        this->nextTransport(param);
+        this->waitFrameGap();
+    }
+    ERaModbusRequestRead request(this->transp, param, this->requestBuffer);
+    ERaModbusResponse response(&request, request.responseLength(), this->responseBuffer);
+    if (!skip) {
+        MillisTime_t startMillis = ERaMillis();
+        this->sendCommand(request.getMessage(), request.getSize());
+        status = this->waitResponse(&response);
+        this->frameMillis = ERaMillis();
+        this->updateSlave(slave, param, status);
+        if (status) {
+            this->sampleSlave(slave, this->frameMillis - startMillis, wire);
+        }
+    }
+
+    uint8_t count = head->groupCount;
+    for (; (it != e) && count; it = it->getNext()) {
+        ModbusConfig_t* member = it->get();
+        if (member == nullptr) {
+            continue;
+        }
+        count--;
+        uint16_t length = BUILD_WORD(member->len1, member->len2);
+        if (status) {
+            this->addData(member->id, param.func, &response, (BUILD_WORD(member->sa1, member->sa2) - head->groupStart), length);
+            member->totalFail = 0;
+        }
+        else {
+            this->addError(param.func, length);
+            if (!skip) {
+                this->failRead++;
+            }
+            member->totalFail++;
+        }
+    }
+
+    return it;
+}
+
+/* Reads in flight together, up to the pipeline depth per slave.
+   Each slave has its own pooled connection, so replies from
+   different slaves are awaited at the same time */
+template <class Api>
+ERaList<ModbusConfig_t*>::iterator* ERaModbus<Api>::sendModbusReadMulti(ERaList<ModbusConfig_t*>::iterator* it,
+                                                                        const ERaList<ModbusConfig_t*>::iterator* e) {
+    size_t count {0};
+    uint32_t busy {0};
+    MillisTime_t maxWait {0};
+    bool status[ERA_MODBUS_MAX_INFLIGHT] {false};
+    MillisTime_t elapsed[ERA_MODBUS_MAX_INFLIGHT] {0};
+    SlaveHealth_t* slaves[ERA_MODBUS_MAX_INFLIGHT] {nullptr};
+    ModbusConfig_t* params[ERA_MODBUS_MAX_INFLIGHT] {nullptr};
+    Stream* streams[ERA_MODBUS_MAX_INFLIGHT] {nullptr};
+    for (; (it != e) && (count < ERA_MODBUS_MAX_INFLIGHT); it = it->getNext()) {
+        ModbusConfig_t* param = it->get();
+        if (param == nullptr) {
+            continue;
+        }
+        if (!this->isPipelined(*param)) {
+            break;
+        }
+        if (!this->pipelineSlaves && count &&
+            !isSameSlave(*params[0], *param)) {
+            break;
+        }
+        size_t queued {0};
+        Stream* client {nullptr};
+        for (size_t i = 0; i < count; ++i) {
+            if (!isSameSlave(*params[i], *param)) {
+                continue;
+            }
+            client = streams[i];
+            queued++;
+        }
+        if (queued >= this->inflight) {
+            break;
+        }
+        int index {-1};
+        if (!queued) {
+            index = this->findTCPClient(*param, busy);
+            if ((index < 0) && count) {
+                break;
+            }
+        }
+        SlaveHealth_t* slave = this->getSlave(*param);
+        if (!this->health.allow(slave)) {
+            /* Offline slave ends the batch, alone it is skipped */
+            if (count) {
+                break;
+            }
+            this->addError(param->func, BUILD_WORD(param->len1, param->len2));
+            param->totalFail++;
+            return it->getNext();
+        }
+        if (index >= 0) {
+            busy |= (1UL << index);
+            client = this->openTCPClient(index, *param);
+        }
+        /* Replies are awaited together, the longest timeout counts */
+        MillisTime_t slaveTimeout = this->health.timeout(slave, 0, this->maxTimeout);
+        if (!count || (slaveTimeout > maxWait)) {
+            maxWait = slaveTimeout;
+        }
+        slaves[count] = slave;
+        params[count] = param;
+        streams[count++] = client;
+    }
+
+    this->timeout = maxWait;
+    this->switchToModbusTCP(nullptr);
+    ModbusTransp::processReadMulti(this->transp, params, streams, status, elapsed, count);
+    this->frameMillis = ERaMillis();
+
+    for (size_t i = 0; i < count; ++i) {
+        this->updateSlave(slaves[i], *params[i], status[i]);
+        if (status[i]) {
+            this->sampleSlave(slaves[i], elapsed[i], 0);
+            params[i]->totalFail = 0;
+        }
+        else {
+            this->failRead++;
+            params[i]->totalFail++;
+        }
+    }
+    return it;
+}
+
 template <class Api>
 bool ERaModbus<Api>::sendModbusWrite(ModbusConfig_t& param) {
     bool status {false};
+    /* Writes are always sent, the breaker only shortens the wait */
+    SlaveHealth_t* slave = this->getSlave(param);
+    this->setSlaveTimeout(slave, this->wireTime(param));
     this->nextTransport(param);
+    this->waitFrameGap();
     switch (param.func) {
         case ModbusFunctionT::FORCE_SINGLE_COIL:
             status = ModbusTransp::forceSingleCoil(this->transp, param);
@@ -544,6 +1023,8 @@ bool ERaModbus<Api>::sendModbusWrite(ModbusConfig_t& param) {
         default:
             return false;
     }
+    this->frameMillis = ERaMillis();
+    this->updateSlave(slave, param, status);
 
     if (!status) {
         this->failWrite++;
@@ -551,6 +1032,132 @@ bool ERaModbus<Api>::sendModbusWrite(ModbusConfig_t& param) {
     return status;
 }
 
+/* elapsed[i] is the time from the sends to the reply of request i */
+template <class Api>
+void ERaModbus<Api>::waitResponses(ERaModbusResponse** responses, Stream** streams,
+                                   MillisTime_t* elapsed, size_t count) {
+    size_t pending {0};
+    size_t numReaders {0};
+    MBAPReader_t readers[ERA_MODBUS_MAX_INFLIGHT] {};
+    for (size_t i = 0; i < count; ++i) {
+        if ((responses[i] == nullptr) ||
+            (streams[i] == NULL)) {
+            continue;
+        }
+        if (this->total++ > 99) {
+            this->total = 1;
+            this->failRead = 0;
+            this->failWrite = 0;
+        }
+        pending++;
+        size_t k {0};
+        while ((k < numReaders) && (readers[k].stream != streams[i])) {
+            k++;
+        }
+        if (k == numReaders) {
+            readers[numReaders++].stream = streams[i];
+        }
+    }
+
+    size_t turn {0};
+    MillisTime_t startMillis = ERaMillis();
+
+    while (pending && ERaRemainingTime(startMillis, this->timeout)) {
+        bool received {false};
+        for (size_t k = 0; (k < numReaders) && pending; ++k) {
+            while (pending && readers[k].stream->available()) {
+                received = true;
+                ERaModbusResponse* response = this->readMBAP(readers[k], (uint8_t)readers[k].stream->read(),
+                                                             responses, streams, count);
+                if (response == nullptr) {
+                    continue;
+                }
+                for (size_t i = 0; i < count; ++i) {
+                    if (responses[i] == response) {
+                        elapsed[i] = ERaMillis() - startMillis;
+                    }
+                }
+                pending--;
+            }
+        }
+        if (received) {
+            continue;
+        }
+#if defined(ERA_NO_RTOS)
+        ERaOnWaiting();
+        this->thisApi().run();
+#endif
+        if (ModbusState::is(ModbusStateT::STATE_MB_PARSE)) {
+            break;
+        }
+#if defined(LINUX)
+        MillisTime_t remain = ERaRemainingTime(startMillis, this->timeout);
+        if ((numReaders > 1) && (remain > ERA_MODBUS_TCP_POLL_MS)) {
+            remain = ERA_MODBUS_TCP_POLL_MS;
+        }
+        readers[turn++ % numReaders].stream->waitAvailable(remain);
+#else
+        ERA_FORCE_UNUSED(turn);
+        ERA_MODBUS_YIELD();
+#endif
+    }
+}
+
+/* Feed one byte of a connection, the response once
+   a frame for one of the requests is complete */
+template <class Api>
+ERaModbusResponse* ERaModbus<Api>::readMBAP(MBAPReader_t& reader, uint8_t value, ERaModbusResponse** responses,
+                                            Stream** streams, size_t count) {
+    if (reader.position < sizeof(reader.header)) {
+        reader.header[reader.position++] = value;
+        if (reader.position < sizeof(reader.header)) {
+            return nullptr;
+        }
+        reader.remain = BUILD_WORD(reader.header[4], reader.header[5]);
+        reader.response = this->findResponse(responses, streams, count, reader.stream,
+                                             BUILD_WORD(reader.header[0], reader.header[1]));
+        for (size_t i = 0; (i < sizeof(reader.header)) && (reader.response != nullptr); ++i) {
+            reader.response->add(reader.header[i]);
+        }
+        if (!reader.remain) {
+            reader.position = 0;
+            reader.response = nullptr;
+        }
+        return nullptr;
+    }
+    if (reader.response != nullptr) {
+        reader.response->add(value);
+    }
+    if (--reader.remain) {
+        return nullptr;
+    }
+    ERaModbusResponse* done = reader.response;
+    if (done != nullptr) {
+        ERaLogHex("MB <<", done->getMessage(), done->getPosition());
+    }
+    reader.position = 0;
+    reader.response = nullptr;
+    return done;
+}
+
+template <class Api>
+ERaModbusResponse* ERaModbus<Api>::findResponse(ERaModbusResponse** responses, Stream** streams, size_t count,
+                                                const Stream* _stream, uint16_t packetId) {
+    for (size_t i = 0; i < count; ++i) {
+        if ((responses[i] == nullptr) ||
+            (streams[i] != _stream)) {
+            continue;
+        }
+        if (responses[i]->getPosition()) {
+            continue;
+        }
+        if (responses[i]->getRequest()->getPacketId() == packetId) {
+            return responses[i];
+        }
+    }
+    return nullptr;
+}
+
 template <class Api>
 void ERaModbus<Api>::onData(ERaModbusRequest* request, ERaModbusResponse* response) {
     if ((request == nullptr) ||
@@ -558,49 +1165,70 @@ void ERaModbus<Api>::onData(ERaModbusRequest* request, ERaModbusResponse* respon
         return;
     }
 
-    switch (request->getFunction()) {
+    this->addData(request->getReadId(), request->getFunction(), response, 0, request->getLength());
+}
+
+template <class Api>
+void ERaModbus<Api>::onError(ERaModbusRequest* request) {
+    if (request == nullptr) {
+        return;
+    }
+
+    this->addError(request->getFunction(), request->getLength());
+}
+
+/* Append coils or registers [offset, offset + length) of the reply */
+template <class Api>
+void ERaModbus<Api>::addData(int readId, uint8_t function, ERaModbusResponse* response, uint16_t offset, uint16_t length) {
+    switch (function) {
         case ModbusFunctionT::READ_COIL_STATUS:
         case ModbusFunctionT::READ_INPUT_STATUS: {
-            LOC_BUFFER_MODBUS(1)
-            uint16_t bits = request->getLength();
-            for (int i = 0; (i < response->getBytes()) && (bits > 0); ++i) {
-                for (int j = 0; j < ((bits > 8) ? 8 : bits); ++j) {
-                    pData[i * 8 + j] = this->getBit(response->getData()[i], j);
+            LOC_BUFFER_MODBUS(length)
+            for (uint16_t i = 0; i < length; ++i) {
+                uint16_t bit = offset + i;
+                if ((bit / 8) >= response->getBytes()) {
+                    break;
                 }
-                bits -= ((bits > 8) ? 8 : bits);
+                pData[i] = this->getBit(response->getData()[bit / 8], bit % 8);
             }
             this->dataBuff.add_hex_array(pData, pDataLen);
+            this->points.update(readId, pData, length, true);
             FREE_BUFFER_MODBUS
         }
             break;
-        default:
-            this->dataBuff.add_hex_array(response->getData(), response->getBytes());
+        default: {
+            size_t bytes = (size_t)length * 2;
+            size_t skip = (size_t)offset * 2;
+            if (skip > response->getBytes()) {
+                skip = response->getBytes();
+            }
+            if ((skip + bytes) > response->getBytes()) {
+                bytes = response->getBytes() - skip;
+            }
+            this->dataBuff.add_hex_array(response->getData() + skip, bytes);
+            this->points.update(readId, response->getData() + skip, bytes, false);
+        }
             break;
     }
     this->dataBuff.add("1");
 }
 
 template <class Api>
-void ERaModbus<Api>::onError(ERaModbusRequest* request) {
-    if (request == nullptr) {
-        return;
-    }
+void ERaModbus<Api>::addError(uint8_t function, uint16_t length) {
     if (ModbusState::is(ModbusStateT::STATE_MB_PARSE)) {
         return;
     }
 
-    switch (request->getFunction()) {
+    switch (function) {
         case ModbusFunctionT::READ_COIL_STATUS:
         case ModbusFunctionT::READ_INPUT_STATUS:
             if (!this->dataBuff.next()) {
-                size_t pDataLen = request->getLength();
-                this->dataBuff.add_zero_array(pDataLen);
+                this->dataBuff.add_zero_array(length);
             }
             break;
         default:
             if (!this->dataBuff.next()) {
-                size_t pDataLen = request->getLength() * 2;
-                this->dataBuff.add_zero_array(pDataLen);
+                this->dataBuff.add_zero_array(length * 2);
             }
             break;
     }
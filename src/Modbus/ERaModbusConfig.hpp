@@ -70,6 +70,92 @@
     #endif
 #endif
 
+/* Requests kept in flight on one Modbus TCP connection,
+   1 sends the next request only after the previous reply */
+#if !defined(ERA_MODBUS_MAX_INFLIGHT)
+    #define ERA_MODBUS_MAX_INFLIGHT     8
+#endif
+
+#if !defined(ERA_MODBUS_TCP_INFLIGHT)
+    #define ERA_MODBUS_TCP_INFLIGHT     1
+#endif
+
+/* Reads to different Modbus TCP slaves in flight together,
+   off by default as with ERA_MODBUS_TCP_INFLIGHT */
+#if !defined(ERA_MODBUS_TCP_PIPELINE_SLAVES)
+    #define ERA_MODBUS_TCP_PIPELINE_SLAVES  false
+#endif
+
+/* Persistent Modbus TCP connections, one per slave ip and port.
+   The least recently used one is reassigned when all are bound */
+#if !defined(ERA_MODBUS_MAX_TCP_CLIENTS)
+    #define ERA_MODBUS_MAX_TCP_CLIENTS  4
+#endif
+
+/* First retry after a failed connect, doubled up to the max */
+#if !defined(ERA_MODBUS_TCP_RETRY_MS)
+    #define ERA_MODBUS_TCP_RETRY_MS     1000
+#endif
+
+#if !defined(ERA_MODBUS_TCP_BACKOFF_MS)
+    #define ERA_MODBUS_TCP_BACKOFF_MS   30000
+#endif
+
+/* Longest sleep on one connection while replies are
+   pending on several */
+#if !defined(ERA_MODBUS_TCP_POLL_MS)
+    #define ERA_MODBUS_TCP_POLL_MS      5
+#endif
+
+/* Platforms with their own sockets open pool connections on demand */
+#if defined(LINUX) && \
+    !defined(ERA_MODBUS_TCP_NO_AUTO_CLIENT)
+    #define ERA_MODBUS_TCP_AUTO_CLIENT
+#endif
+
+/* Transceiver enable switched by the kernel (TIOCSRS485) on
+   Linux serial ports that support it, instead of the DE pin */
+#if defined(ERA_MODBUS_RS485)
+    #if !defined(ERA_MODBUS_RS485_DELAY_BEFORE)
+        #define ERA_MODBUS_RS485_DELAY_BEFORE   0
+    #endif
+    #if !defined(ERA_MODBUS_RS485_DELAY_AFTER)
+        #define ERA_MODBUS_RS485_DELAY_AFTER    0
+    #endif
+#endif
+
+/* Per slave timeouts, learned from the replies, and the
+   breaker that leaves offline slaves to a slow probe */
+#if !defined(ERA_MODBUS_MAX_SLAVES)
+    #define ERA_MODBUS_MAX_SLAVES       16
+#endif
+
+/* Replies seen before the timeout drops below the configured one */
+#if !defined(ERA_MODBUS_TIMEOUT_SAMPLES)
+    #define ERA_MODBUS_TIMEOUT_SAMPLES  8
+#endif
+
+#if !defined(ERA_MODBUS_MIN_TIMEOUT)
+    #define ERA_MODBUS_MIN_TIMEOUT      100
+#endif
+
+#if !defined(ERA_MODBUS_TIMEOUT_MARGIN)
+    #define ERA_MODBUS_TIMEOUT_MARGIN   50
+#endif
+
+/* Misses in a row to open the breaker, 0 never opens it */
+#if !defined(ERA_MODBUS_BREAKER_FAILS)
+    #define ERA_MODBUS_BREAKER_FAILS    3
+#endif
+
+#if !defined(ERA_MODBUS_PROBE_MIN_MS)
+    #define ERA_MODBUS_PROBE_MIN_MS     5000
+#endif
+
+#if !defined(ERA_MODBUS_PROBE_MAX_MS)
+    #define ERA_MODBUS_PROBE_MAX_MS     60000
+#endif
+
 #if !defined(ERA_MODBUS_EXECUTE_MS)
     #define ERA_MODBUS_EXECUTE_MS       0
 #endif
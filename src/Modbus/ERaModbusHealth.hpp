@@ -0,0 +1,168 @@
+#ifndef INC_ERA_MODBUS_HEALTH_HPP_
+#define INC_ERA_MODBUS_HEALTH_HPP_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <Utility/ERaUtility.hpp>
+#include <Modbus/ERaModbusConfig.hpp>
+
+/* Response time and availability of each slave, keyed by
+   TCP address (0 for RTU) and unit id.
+   The timeout is the smoothed latency plus 4 deviations
+   (Jacobson), which follows the tail (~p99) of the replies,
+   and doubles after each miss.
+   After ERA_MODBUS_BREAKER_FAILS misses in a row the slave is
+   only probed, one request per probe interval, the interval
+   doubling up to ERA_MODBUS_PROBE_MAX_MS until it answers */
+class ERaModbusHealth
+{
+public:
+    typedef struct __SlaveHealth_t {
+        uint32_t ip;
+        uint16_t port;
+        uint8_t addr;
+        bool used;
+        uint8_t samples;
+        uint8_t fails;
+        uint32_t srtt;
+        uint32_t rttvar;
+        MillisTime_t usedMillis;
+        MillisTime_t probeMillis;
+        MillisTime_t probeDelay;
+    } SlaveHealth_t;
+
+    ERaModbusHealth()
+        : slaves()
+    {}
+    ~ERaModbusHealth()
+    {}
+
+    /* Entry of the slave, the least recently used one
+       is taken over when the table is full */
+    SlaveHealth_t* get(uint32_t ip, uint16_t port, uint8_t addr) {
+        SlaveHealth_t* entry {nullptr};
+        MillisTime_t now = ERaMillis();
+        for (size_t i = 0; i < ERA_MODBUS_MAX_SLAVES; ++i) {
+            SlaveHealth_t& slave = this->slaves[i];
+            if (slave.used && (slave.ip == ip) &&
+                (slave.port == port) && (slave.addr == addr)) {
+                slave.usedMillis = now;
+                return &slave;
+            }
+            if ((entry == nullptr) ||
+                (entry->used && !slave.used) ||
+                (entry->used && ((MillisTime_t)(now - slave.usedMillis) >
+                                (MillisTime_t)(now - entry->usedMillis)))) {
+                entry = &slave;
+            }
+        }
+        memset(entry, 0, sizeof(SlaveHealth_t));
+        entry->ip = ip;
+        entry->port = port;
+        entry->addr = addr;
+        entry->used = true;
+        entry->usedMillis = now;
+        return entry;
+    }
+
+    /* False while the breaker is open and no probe is due,
+       otherwise a due probe is taken by this request */
+    bool allow(SlaveHealth_t* slave) {
+        if ((slave == nullptr) || !slave->probeDelay) {
+            return true;
+        }
+        if (ERaRemainingTime(slave->probeMillis, slave->probeDelay)) {
+            return false;
+        }
+        slave->probeMillis = ERaMillis();
+        return true;
+    }
+
+    bool isOpen(const SlaveHealth_t* slave) const {
+        return ((slave != nullptr) && slave->probeDelay);
+    }
+
+    MillisTime_t probeDelay(const SlaveHealth_t* slave) const {
+        return ((slave != nullptr) ? slave->probeDelay : 0);
+    }
+
+    /* wire is the transmission time of request and reply,
+       max the configured timeout, used until enough replies */
+    MillisTime_t timeout(const SlaveHealth_t* slave, MillisTime_t wire, MillisTime_t max) const {
+        if ((slave == nullptr) ||
+            (slave->samples < ERA_MODBUS_TIMEOUT_SAMPLES)) {
+            return max;
+        }
+        uint32_t value = (wire + (slave->srtt >> 3) + slave->rttvar + ERA_MODBUS_TIMEOUT_MARGIN);
+        if (value < ERA_MODBUS_MIN_TIMEOUT) {
+            value = ERA_MODBUS_MIN_TIMEOUT;
+        }
+        value <<= ((slave->fails < 8) ? slave->fails : 8);
+        return ((value < max) ? (MillisTime_t)value : max);
+    }
+
+    /* Reply time without the wire time, srtt is kept x8, rttvar x4 */
+    void sample(SlaveHealth_t* slave, MillisTime_t latency) {
+        if (slave == nullptr) {
+            return;
+        }
+        if (!slave->samples) {
+            slave->srtt = ((uint32_t)latency << 3);
+            slave->rttvar = ((uint32_t)latency << 1);
+        }
+        else {
+            int32_t error = ((int32_t)latency - (int32_t)(slave->srtt >> 3));
+            slave->srtt = (uint32_t)((int32_t)slave->srtt + error);
+            if (error < 0) {
+                error = -error;
+            }
+            slave->rttvar = (uint32_t)((int32_t)slave->rttvar + error - (int32_t)(slave->rttvar >> 2));
+        }
+        if (slave->samples < 0xFF) {
+            slave->samples++;
+        }
+    }
+
+    /* True if the slave was taken as offline until now */
+    bool success(SlaveHealth_t* slave) {
+        if (slave == nullptr) {
+            return false;
+        }
+        bool recovered = this->isOpen(slave);
+        slave->fails = 0;
+        slave->probeDelay = 0;
+        return recovered;
+    }
+
+    /* True if this miss opened the breaker */
+    bool failure(SlaveHealth_t* slave) {
+        if (slave == nullptr) {
+            return false;
+        }
+        if (slave->fails < 0xFF) {
+            slave->fails++;
+        }
+        if (!ERA_MODBUS_BREAKER_FAILS ||
+            (slave->fails < ERA_MODBUS_BREAKER_FAILS)) {
+            return false;
+        }
+        bool opened = !this->isOpen(slave);
+        if (opened) {
+            slave->probeDelay = ERA_MODBUS_PROBE_MIN_MS;
+        }
+        else if (slave->probeDelay < (ERA_MODBUS_PROBE_MAX_MS / 2)) {
+            slave->probeDelay *= 2;
+        }
+        else {
+            slave->probeDelay = ERA_MODBUS_PROBE_MAX_MS;
+        }
+        slave->probeMillis = ERaMillis();
+        return opened;
+    }
+
+protected:
+private:
+    SlaveHealth_t slaves[ERA_MODBUS_MAX_SLAVES];
+};
+
+#endif /* INC_ERA_MODBUS_HEALTH_HPP_ */
@@ -4,6 +4,7 @@
 #include <new>
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 #include <ERa/ERaDetect.hpp>
 
 #if defined(ERA_UNUSED_STD_NOTHROW)
@@ -12,19 +13,29 @@
     #define new_modbus  new(std::nothrow)
 #endif
 
+/* Owns its buffer unless one is passed in, callers
+   reusing a buffer keep it alive and unshared meanwhile */
 class ERaModbusMessage
 {
 public:
-    ERaModbusMessage(uint8_t _length)
-        : buffer(nullptr)
+    ERaModbusMessage(uint8_t _length, uint8_t* _buffer = nullptr)
+        : buffer(_buffer)
         , length(_length)
         , index(0)
+        , owned(_buffer == nullptr)
     {
-        this->buffer = new_modbus uint8_t[_length] {0};
+        if (this->owned) {
+            this->buffer = new_modbus uint8_t[_length] {0};
+        }
+        else {
+            memset(this->buffer, 0, _length);
+        }
     }
     virtual ~ERaModbusMessage()
     {
-        delete[] this->buffer;
+        if (this->owned) {
+            delete[] this->buffer;
+        }
     }
 
     uint8_t* getMessage() {
@@ -50,6 +61,7 @@ protected:
     uint8_t* buffer;
     uint8_t length;
     uint8_t index;
+    bool owned;
 };
 
 #endif /* INC_ERA_MODBUS_MESSAGE_HPP_ */
@@ -0,0 +1,182 @@
+#ifndef INC_ERA_MODBUS_POINT_HPP_
+#define INC_ERA_MODBUS_POINT_HPP_
+
+#include <math.h>
+#include <string.h>
+#include <stdint.h>
+#include <ERa/ERaReport.hpp>
+#include <Utility/ERaQueue.hpp>
+#include <Modbus/ERaDefineModbus.hpp>
+#include <Modbus/ERaModbusMessage.hpp>
+
+typedef struct __ModbusPoint_t {
+    int readId;
+    uint16_t index;
+    uint8_t type;
+    unsigned int configId;
+    float scale;
+    float offset;
+    float value;
+    void* owner;
+    ERaReport::iterator report;
+} ModbusPoint_t;
+
+/* Typed values decoded from the reply of a read config.
+   index counts registers (bits for coil and input reads) from
+   the start of the read, value = raw * scale + offset.
+   Each point reports on its own through ERaReport,
+   minChange being the deadband */
+class ERaModbusPoints
+{
+    typedef void (*PointCallback_t)(void*);
+
+public:
+    ERaModbusPoints()
+        : points()
+        , report()
+        , numPoints(0)
+    {}
+    ~ERaModbusPoints()
+    {
+        const ERaList<ModbusPoint_t*>::iterator* e = this->points.end();
+        for (ERaList<ModbusPoint_t*>::iterator* it = this->points.begin(); it != e; it = it->getNext()) {
+            delete it->get();
+            it->get() = nullptr;
+        }
+        this->points.clear();
+    }
+
+    ModbusPoint_t* add(int readId, uint16_t index, uint8_t type, unsigned int configId,
+                        float scale, float offset, float minChange,
+                        unsigned long minInterval, unsigned long maxInterval,
+                        PointCallback_t cb, void* owner) {
+        ModbusPoint_t* point = new_modbus ModbusPoint_t();
+        if (point == nullptr) {
+            return nullptr;
+        }
+        point->readId = readId;
+        point->index = index;
+        point->type = type;
+        point->configId = configId;
+        point->scale = scale;
+        point->offset = offset;
+        point->value = 0.0f;
+        point->owner = owner;
+        point->report = this->report.setReporting(minInterval, maxInterval, minChange, cb, point);
+        if (!point->report) {
+            delete point;
+            return nullptr;
+        }
+        this->points.put(point);
+        this->numPoints++;
+        return point;
+    }
+
+    /* data holds the reply of the read, one byte per bit
+       for coil and input reads, registers otherwise */
+    void update(int readId, const uint8_t* data, size_t size, bool bits) {
+        if (!this->numPoints) {
+            return;
+        }
+        float value {0.0f};
+        const ERaList<ModbusPoint_t*>::iterator* e = this->points.end();
+        for (ERaList<ModbusPoint_t*>::iterator* it = this->points.begin(); it != e; it = it->getNext()) {
+            ModbusPoint_t* point = it->get();
+            if ((point == nullptr) ||
+                (point->readId != readId)) {
+                continue;
+            }
+            if (bits) {
+                if (point->index >= size) {
+                    continue;
+                }
+                value = (data[point->index] ? 1.0f : 0.0f);
+            }
+            else if (!ERaModbusPoints::decode(data, size, point->index, point->type, value)) {
+                continue;
+            }
+            point->value = ((value * point->scale) + point->offset);
+            point->report.updateReport(point->value);
+        }
+    }
+
+    MillisTime_t run() {
+        if (!this->numPoints) {
+            return REPORT_MAX_INTERVAL;
+        }
+        return this->report.run();
+    }
+
+    size_t size() const {
+        return this->numPoints;
+    }
+
+    static bool decode(const uint8_t* data, size_t size, uint16_t index, uint8_t type, float& value) {
+        uint8_t bytes[4] {0};
+        size_t count {2};
+        switch (type & ModbusDataTypeT::MODBUS_TYPE_MASK) {
+            case ModbusDataTypeT::MODBUS_TYPE_INT32:
+            case ModbusDataTypeT::MODBUS_TYPE_UINT32:
+            case ModbusDataTypeT::MODBUS_TYPE_FLOAT32:
+                count = 4;
+                break;
+            default:
+                break;
+        }
+        size_t position = ((size_t)index * 2);
+        if ((position + count) > size) {
+            return false;
+        }
+        memcpy(bytes, data + position, count);
+        if (type & ModbusDataTypeT::MODBUS_BYTE_SWAP) {
+            for (size_t i = 0; i < count; i += 2) {
+                uint8_t tmp = bytes[i];
+                bytes[i] = bytes[i + 1];
+                bytes[i + 1] = tmp;
+            }
+        }
+        if ((count == 4) &&
+            (type & ModbusDataTypeT::MODBUS_WORD_SWAP)) {
+            uint8_t tmp[2] {bytes[0], bytes[1]};
+            bytes[0] = bytes[2];
+            bytes[1] = bytes[3];
+            bytes[2] = tmp[0];
+            bytes[3] = tmp[1];
+        }
+        uint32_t raw = ((count == 4) ? (((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) |
+                                        ((uint32_t)bytes[2] << 8) | (uint32_t)bytes[3])
+                                     : (((uint32_t)bytes[0] << 8) | (uint32_t)bytes[1]));
+        switch (type & ModbusDataTypeT::MODBUS_TYPE_MASK) {
+            case ModbusDataTypeT::MODBUS_TYPE_BIT:
+                value = (raw ? 1.0f : 0.0f);
+                break;
+            case ModbusDataTypeT::MODBUS_TYPE_INT16:
+                value = (float)(int16_t)raw;
+                break;
+            case ModbusDataTypeT::MODBUS_TYPE_INT32:
+                value = (float)(int32_t)raw;
+                break;
+            case ModbusDataTypeT::MODBUS_TYPE_FLOAT32: {
+                float number {0.0f};
+                memcpy(&number, &raw, sizeof(number));
+                if (isnan(number) || isinf(number)) {
+                    return false;
+                }
+                value = number;
+            }
+                break;
+            default:
+                value = (float)raw;
+                break;
+        }
+        return true;
+    }
+
+protected:
+private:
+    ERaList<ModbusPoint_t*> points;
+    ERaReport report;
+    size_t numPoints;
+};
+
+#endif /* INC_ERA_MODBUS_POINT_HPP_ */
@@ -3,8 +3,10 @@
 
 #include <math.h>
 #include <Modbus/ERaParse.hpp>
+#include <Modbus/ERaModbusConfig.hpp>
 #include <Modbus/ERaDefineModbus.hpp>
 #include <Modbus/ERaModbusMessage.hpp>
+#include <Modbus/ERaModbusFrame.hpp>
 
 class ERaModbusResponse;
 
@@ -14,14 +16,16 @@ class ERaModbusRequest
     friend class ERaModbusResponse;
 
 public:
-    ERaModbusRequest(uint8_t _transp, uint8_t _length)
-        : ERaModbusMessage(_length)
+    ERaModbusRequest(uint8_t _transp, uint8_t _length,
+                    uint8_t* _buffer = nullptr)
+        : ERaModbusMessage(_length, _buffer)
         , transp(_transp)
         , packetId(0)
         , slaveAddr(0)
         , function(0)
         , addr(0)
         , len(0)
+        , readId(0)
     {
         if (this->transp == ModbusTransportT::MODBUS_TRANSPORT_RTU) {
             return;
@@ -43,6 +47,11 @@ public:
         return this->len;
     }
 
+    /* ModbusConfig_t::id of the read this request was built from */
+    int getReadId() {
+        return this->readId;
+    }
+
 protected:
     bool isRTU() {
         return (this->transp == ModbusTransportT::MODBUS_TRANSPORT_RTU);
@@ -57,23 +66,7 @@ protected:
     }
 
     uint16_t modbusCRC(uint8_t* buf, size_t len) {
-        uint16_t crc = 0xFFFF;
-
-        for (size_t pos = 0; pos < len; pos++) {
-            crc ^= (uint16_t)buf[pos];
-
-            for (int i = 8; i != 0; i--) {
-                if ((crc & 0x0001) != 0) {
-                    crc >>= 1;
-                    crc ^= 0xA001;
-                }
-                else {
-                    crc >>= 1;
-                }
-            }
-        }
-
-        return crc;
+        return ERaModbusCRC(buf, len);
     }
 
     static uint16_t nextPacketId() {
@@ -90,6 +83,7 @@ protected:
     uint8_t function;
     uint16_t addr;
     uint16_t len;
+    int readId;
 };
 
 class ERaModbusResponse
@@ -97,8 +91,9 @@ class ERaModbusResponse
 {
 public:
     ERaModbusResponse(ERaModbusRequest* _request,
-                    uint8_t _length)
-        : ERaModbusMessage(_length)
+                    uint8_t _length,
+                    uint8_t* _buffer = nullptr)
+        : ERaModbusMessage(_length, _buffer)
         , request(_request)
     {}
 
@@ -120,6 +115,10 @@ public:
         return BUILD_WORD(this->buffer[0], this->buffer[1]);
     }
 
+    ERaModbusRequest* getRequest() {
+        return this->request;
+    }
+
     uint8_t getSlaveAddress() {
         if (this->request->isRTU()) {
             return this->buffer[0];
@@ -150,7 +149,7 @@ public:
 
     bool checkCRC() {
         uint16_t crc = this->request->modbusCRC(this->buffer, this->length - 2);
-        if ((this->buffer[this->length - 1] == HI_WORD(crc)) ||
+        if ((this->buffer[this->length - 1] == HI_WORD(crc)) &&
             (this->buffer[this->length - 2] == LO_WORD(crc))) {
             return true;
         }
@@ -209,61 +208,28 @@ private:
     ERaModbusRequest* request;
 };
 
-class ERaModbusRequest01
+/* Reads 01 to 04. The frame compiled with the config is copied
+   as is, only the MBAP transaction id is new for each request */
+class ERaModbusRequestRead
     : public ERaModbusRequest
 {
 public:
-    ERaModbusRequest01(uint8_t _transp,
-                    uint8_t _slaveAddr,
-                    uint16_t _addr,
-                    uint16_t _len)
-        : ERaModbusRequest(_transp, ((_transp == ModbusTransportT::MODBUS_TRANSPORT_RTU) ? 8 : 12))
+    ERaModbusRequestRead(uint8_t _transp,
+                        const ModbusConfig_t& param,
+                        uint8_t* _buffer = nullptr)
+        : ERaModbusRequest(_transp, ((_transp == ModbusTransportT::MODBUS_TRANSPORT_RTU) ? 8 : 12), _buffer)
     {
-        this->slaveAddr = _slaveAddr;
-        this->function = ModbusFunctionT::READ_COIL_STATUS;
-        this->addr = _addr;
-        this->len = _len;
-        if (!this->isRTU()) {
-            this->add(HI_WORD(this->packetId));
-            this->add(LO_WORD(this->packetId));
-            this->add(0x00);
-            this->add(0x00);
-            this->add(0x00);
-            this->add(0x06);
-        }
-        this->add(this->slaveAddr);
-        this->add(this->function);
-        this->add(HI_WORD(this->addr));
-        this->add(LO_WORD(this->addr));
-        this->add(HI_WORD(this->len));
-        this->add(LO_WORD(this->len));
-        if (this->isRTU()) {
-            uint16_t crc = this->modbusCRC(this->buffer, 6);
-            this->add(LO_WORD(crc));
-            this->add(HI_WORD(crc));
+        this->slaveAddr = param.addr;
+        this->function = param.func;
+        this->addr = BUILD_WORD(param.sa1, param.sa2);
+        this->len = BUILD_WORD(param.len1, param.len2);
+        this->readId = param.id;
+        uint8_t frame[8] {0};
+        const uint8_t* pFrame = param.frame;
+        if (!ERaModbusRequestRead::isCompiled(param)) {
+            ERaModbusBuildFrame(frame, this->slaveAddr, this->function, this->addr, this->len);
+            pFrame = frame;
         }
-    }
-
-    uint8_t responseLength() {
-        return ((this->isRTU() ? 5 : 9) +
-                ::ceil(static_cast<float>(this->len) / 8));
-    }
-};
-
-class ERaModbusRequest02
-    : public ERaModbusRequest
-{
-public:
-    ERaModbusRequest02(uint8_t _transp,
-                    uint8_t _slaveAddr,
-                    uint16_t _addr,
-                    uint16_t _len)
-        : ERaModbusRequest(_transp, ((_transp == ModbusTransportT::MODBUS_TRANSPORT_RTU) ? 8 : 12))
-    {
-        this->slaveAddr = _slaveAddr;
-        this->function = ModbusFunctionT::READ_INPUT_STATUS;
-        this->addr = _addr;
-        this->len = _len;
         if (!this->isRTU()) {
             this->add(HI_WORD(this->packetId));
             this->add(LO_WORD(this->packetId));
@@ -272,104 +238,33 @@ public:
             this->add(0x00);
             this->add(0x06);
         }
-        this->add(this->slaveAddr);
-        this->add(this->function);
-        this->add(HI_WORD(this->addr));
-        this->add(LO_WORD(this->addr));
-        this->add(HI_WORD(this->len));
-        this->add(LO_WORD(this->len));
-        if (this->isRTU()) {
-            uint16_t crc = this->modbusCRC(this->buffer, 6);
-            this->add(LO_WORD(crc));
-            this->add(HI_WORD(crc));
+        for (size_t i = 0; i < (this->isRTU() ? 8 : 6); ++i) {
+            this->add(pFrame[i]);
         }
     }
 
     uint8_t responseLength() {
-        return ((this->isRTU() ? 5 : 9) +
-                ::ceil(static_cast<float>(this->len) / 8));
-    }
-};
-
-class ERaModbusRequest03
-    : public ERaModbusRequest
-{
-public:
-    ERaModbusRequest03(uint8_t _transp,
-                    uint8_t _slaveAddr,
-                    uint16_t _addr,
-                    uint16_t _len)
-        : ERaModbusRequest(_transp, ((_transp == ModbusTransportT::MODBUS_TRANSPORT_RTU) ? 8 : 12))
-    {
-        this->slaveAddr = _slaveAddr;
-        this->function = ModbusFunctionT::READ_HOLDING_REGISTERS;
-        this->addr = _addr;
-        this->len = _len;
-        if (!this->isRTU()) {
-            this->add(HI_WORD(this->packetId));
-            this->add(LO_WORD(this->packetId));
-            this->add(0x00);
-            this->add(0x00);
-            this->add(0x00);
-            this->add(0x06);
-        }
-        this->add(this->slaveAddr);
-        this->add(this->function);
-        this->add(HI_WORD(this->addr));
-        this->add(LO_WORD(this->addr));
-        this->add(HI_WORD(this->len));
-        this->add(LO_WORD(this->len));
-        if (this->isRTU()) {
-            uint16_t crc = this->modbusCRC(this->buffer, 6);
-            this->add(LO_WORD(crc));
-            this->add(HI_WORD(crc));
+        switch (this->function) {
+            case ModbusFunctionT::READ_COIL_STATUS:
+            case ModbusFunctionT::READ_INPUT_STATUS:
+                return (uint8_t)((this->isRTU() ? 5 : 9) +
+                                ((this->len + 7) / 8));
+            default:
+                return (uint8_t)((this->isRTU() ? 5 : 9) +
+                                (this->len * 2));
         }
     }
 
-    uint8_t responseLength() {
-        return ((this->isRTU() ? 5 : 9) +
-                (this->len * 2));
-    }
-};
-
-class ERaModbusRequest04
-    : public ERaModbusRequest
-{
-public:
-    ERaModbusRequest04(uint8_t _transp,
-                    uint8_t _slaveAddr,
-                    uint16_t _addr,
-                    uint16_t _len)
-        : ERaModbusRequest(_transp, ((_transp == ModbusTransportT::MODBUS_TRANSPORT_RTU) ? 8 : 12))
-    {
-        this->slaveAddr = _slaveAddr;
-        this->function = ModbusFunctionT::READ_INPUT_REGISTERS;
-        this->addr = _addr;
-        this->len = _len;
-        if (!this->isRTU()) {
-            this->add(HI_WORD(this->packetId));
-            this->add(LO_WORD(this->packetId));
-            this->add(0x00);
-            this->add(0x00);
-            this->add(0x00);
-            this->add(0x06);
-        }
-        this->add(this->slaveAddr);
-        this->add(this->function);
-        this->add(HI_WORD(this->addr));
-        this->add(LO_WORD(this->addr));
-        this->add(HI_WORD(this->len));
-        this->add(LO_WORD(this->len));
-        if (this->isRTU()) {
-            uint16_t crc = this->modbusCRC(this->buffer, 6);
-            this->add(LO_WORD(crc));
-            this->add(HI_WORD(crc));
-        }
-    }
-
-    uint8_t responseLength() {
-        return ((this->isRTU() ? 5 : 9) +
-                (this->len * 2));
+private:
+    /* Range may have been changed since, e.g. a group head
+       sent with the merged range */
+    static bool isCompiled(const ModbusConfig_t& param) {
+        return ((param.frame[0] == param.addr) &&
+                (param.frame[1] == param.func) &&
+                (param.frame[2] == param.sa1) &&
+                (param.frame[3] == param.sa2) &&
+                (param.frame[4] == param.len1) &&
+                (param.frame[5] == param.len2));
     }
 };
 
@@ -552,32 +447,26 @@ class ERaModbusTransp
 {
 public:
     ERaModbusTransp()
+        : requestBuffer()
+        , responseBuffer()
     {}
     ~ERaModbusTransp()
     {}
 
     bool readCoilStatus(const uint8_t transp, const ModbusConfig_t& param) {
-        ERaModbusRequest* request = new_modbus ERaModbusRequest01(transp, param.addr,
-                                    BUILD_WORD(param.sa1, param.sa2), BUILD_WORD(param.len1, param.len2));
-        return this->processRead(request);
+        return this->processRead(transp, param);
     }
 
     bool readInputStatus(const uint8_t transp, const ModbusConfig_t& param) {
-        ERaModbusRequest* request = new_modbus ERaModbusRequest02(transp, param.addr,
-                                    BUILD_WORD(param.sa1, param.sa2), BUILD_WORD(param.len1, param.len2));
-        return this->processRead(request);
+        return this->processRead(transp, param);
     }
 
     bool readHoldingRegisters(const uint8_t transp, const ModbusConfig_t& param) {
-        ERaModbusRequest* request = new_modbus ERaModbusRequest03(transp, param.addr,
-                                    BUILD_WORD(param.sa1, param.sa2), BUILD_WORD(param.len1, param.len2));
-        return this->processRead(request);
+        return this->processRead(transp, param);
     }
 
     bool readInputRegisters(const uint8_t transp, const ModbusConfig_t& param) {
-        ERaModbusRequest* request = new_modbus ERaModbusRequest04(transp, param.addr,
-                                    BUILD_WORD(param.sa1, param.sa2), BUILD_WORD(param.len1, param.len2));
-        return this->processRead(request);
+        return this->processRead(transp, param);
     }
 
     bool forceSingleCoil(const uint8_t transp, const ModbusConfig_t& param) {
@@ -604,21 +493,71 @@ public:
         return this->processWrite(request);
     }
 
-    bool processRead(ERaModbusRequest* request) {
+    ERaModbusRequest* createReadRequest(const uint8_t transp, const ModbusConfig_t& param) {
+        switch (param.func) {
+            case ModbusFunctionT::READ_COIL_STATUS:
+            case ModbusFunctionT::READ_INPUT_STATUS:
+            case ModbusFunctionT::READ_HOLDING_REGISTERS:
+            case ModbusFunctionT::READ_INPUT_REGISTERS:
+                return new_modbus ERaModbusRequestRead(transp, param);
+            default:
+                return nullptr;
+        }
+    }
+
+    /* Send every read before waiting, replies are matched by
+       connection and transaction id and reported in request order */
+    size_t processReadMulti(const uint8_t transp, ModbusConfig_t** params, Stream** streams,
+                            bool* status, MillisTime_t* elapsed, size_t count) {
+        size_t success {0};
+        ERaModbusRequest* requests[ERA_MODBUS_MAX_INFLIGHT] {nullptr};
+        ERaModbusResponse* responses[ERA_MODBUS_MAX_INFLIGHT] {nullptr};
+        if (count > ERA_MODBUS_MAX_INFLIGHT) {
+            count = ERA_MODBUS_MAX_INFLIGHT;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            requests[i] = this->createReadRequest(transp, *params[i]);
+            if (requests[i] == nullptr) {
+                continue;
+            }
+            responses[i] = new_modbus ERaModbusResponse(requests[i], requests[i]->responseLength());
+            if (responses[i] == nullptr) {
+                continue;
+            }
+            this->thisModbus().selectStream(streams[i]);
+            this->thisModbus().sendCommand(requests[i]->getMessage(), requests[i]->getSize());
+        }
+        this->thisModbus().selectStream(nullptr);
+        this->thisModbus().waitResponses(responses, streams, elapsed, count);
+        for (size_t i = 0; i < count; ++i) {
+            status[i] = ((responses[i] != nullptr) && responses[i]->isSuccess());
+            if (status[i]) {
+                this->thisModbus().onData(requests[i], responses[i]);
+                success++;
+            }
+            else {
+                this->thisModbus().onError(requests[i]);
+            }
+            delete requests[i];
+            delete responses[i];
+        }
+        return success;
+    }
+
+    /* One read at a time reuses the transport buffers,
+       nothing is allocated per poll */
+    bool processRead(const uint8_t transp, const ModbusConfig_t& param) {
         bool status {false};
-        ERA_ASSERT_NULL(request, false)
-        ERaModbusResponse* response = new_modbus ERaModbusResponse(request, request->responseLength());
-        ERA_ASSERT_NULL(response, false)
-        this->thisModbus().sendCommand(request->getMessage(), request->getSize());
-        status = this->thisModbus().waitResponse(response);
+        ERaModbusRequestRead request(transp, param, this->requestBuffer);
+        ERaModbusResponse response(&request, request.responseLength(), this->responseBuffer);
+        this->thisModbus().sendCommand(request.getMessage(), request.getSize());
+        status = this->thisModbus().waitResponse(&response);
         if (status) {
-            this->thisModbus().onData(request, response);
+            this->thisModbus().onData(&request, &response);
         }
         else {
-            this->thisModbus().onError(request);
+            this->thisModbus().onError(&request);
         }
-        delete request;
-        delete response;
         return status;
     }
 
@@ -639,6 +578,11 @@ public:
         return status;
     }
 
+protected:
+    /* Request and reply of the read in progress */
+    uint8_t requestBuffer[12];
+    uint8_t responseBuffer[MODBUS_BUFFER_SIZE];
+
 private:
 	inline
 	const Modbus& thisModbus() const {
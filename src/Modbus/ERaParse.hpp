@@ -5,6 +5,8 @@
 #include <ERa/ERaDebug.hpp>
 #include <ERa/ERaHelperDef.hpp>
 #include <Utility/ERaQueue.hpp>
+#include <Modbus/ERaDefineModbus.hpp>
+#include <Modbus/ERaModbusFrame.hpp>
 
 #ifndef MAX_DEVICE_MODBUS
     #define MAX_DEVICE_MODBUS           20
@@ -26,6 +28,15 @@
     #define DEFAULT_MIN_MODBUS_INTERVAL 1000
 #endif
 
+/* Protocol limits for one FC03/FC04 and FC01/FC02 read */
+#ifndef MODBUS_MAX_READ_REGISTERS
+    #define MODBUS_MAX_READ_REGISTERS   125
+#endif
+
+#ifndef MODBUS_MAX_READ_COILS
+    #define MODBUS_MAX_READ_COILS       2000
+#endif
+
 typedef struct __SensorDelay_t {
 	int delay;
 	int address;
@@ -52,10 +63,14 @@ typedef struct __ModbusConfig_t {
 	uint8_t button;
 	uint16_t delay;
 	IPSlave_t ipSlave;
+	uint16_t groupStart;
+	uint16_t groupLen;
+	uint8_t groupCount;
 	uint8_t totalFail;
 	uint8_t sizeData;
 	uint32_t value;
 	uint8_t ack;
+	uint8_t frame[8];
 } ModbusConfig_t;
 
 typedef struct __Action_t {
@@ -187,6 +202,9 @@ private:
     void parseOneAction(char* ptr, size_t len, ModbusConfigAlias_t& config);
     void actOneAction(int* ptr, size_t len, ModbusConfigAlias_t& config);
     void processParseIsEnableBluetooth(char* ptr, size_t len);
+    void planReadConfig();
+    bool coalesceReadConfig(ModbusConfig_t& head, const ModbusConfig_t& config);
+    void compileReadConfig(ModbusConfig_t& config);
 
     template <typename T>
     T* create() {
@@ -233,6 +251,8 @@ void ERaApplication::parseConfig(char* ptr) {
             position = i + 1;
         }
     }
+
+    this->planReadConfig();
 }
 
 inline
@@ -412,6 +432,104 @@ void ERaApplication::processParseConfigSensorReadWrite(char* ptr, size_t len) {
     }
 }
 
+/* Merge consecutive reads of adjacent or overlapping ranges
+   on the same slave and function into the first one.
+   The head keeps the merged range and groupCount, members get 0 */
+inline
+void ERaApplication::planReadConfig() {
+    ModbusConfig_t* head = nullptr;
+    const ERaList<ModbusConfig_t*>::iterator* e = this->modbusConfigParam.end();
+    for (ERaList<ModbusConfig_t*>::iterator* it = this->modbusConfigParam.begin(); it != e; it = it->getNext()) {
+        ModbusConfig_t* config = it->get();
+        if (config == nullptr) {
+            continue;
+        }
+        config->groupStart = BUILD_WORD(config->sa1, config->sa2);
+        config->groupLen = BUILD_WORD(config->len1, config->len2);
+        config->groupCount = 1;
+#if !defined(ERA_MODBUS_NO_COALESCE)
+        if ((head != nullptr) &&
+            this->coalesceReadConfig(*head, *config)) {
+            config->groupCount = 0;
+            continue;
+        }
+#endif
+        head = config;
+    }
+
+    for (ERaList<ModbusConfig_t*>::iterator* it = this->modbusConfigParam.begin(); it != e; it = it->getNext()) {
+        ModbusConfig_t* config = it->get();
+        if (config == nullptr) {
+            continue;
+        }
+        this->compileReadConfig(*config);
+    }
+}
+
+/* RTU frame of the read a head sends each poll, built once here
+   so the poll loop only copies it. Left zeroed otherwise */
+inline
+void ERaApplication::compileReadConfig(ModbusConfig_t& config) {
+    memset(config.frame, 0, sizeof(config.frame));
+    if (!config.groupCount) {
+        return;
+    }
+    switch (config.func) {
+        case ModbusFunctionT::READ_COIL_STATUS:
+        case ModbusFunctionT::READ_INPUT_STATUS:
+        case ModbusFunctionT::READ_HOLDING_REGISTERS:
+        case ModbusFunctionT::READ_INPUT_REGISTERS:
+            ERaModbusBuildFrame(config.frame, config.addr, config.func,
+                                config.groupStart, config.groupLen);
+            break;
+        default:
+            break;
+    }
+}
+
+inline
+bool ERaApplication::coalesceReadConfig(ModbusConfig_t& head, const ModbusConfig_t& config) {
+    uint32_t maxLen {0};
+    /* Largest read whose reply still fits a 255 byte message */
+    uint32_t maxBytes = (config.ipSlave.ip.dword ? (255 - 9) : (255 - 5));
+    switch (config.func) {
+        case ModbusFunctionT::READ_COIL_STATUS:
+        case ModbusFunctionT::READ_INPUT_STATUS:
+            maxLen = ((MODBUS_MAX_READ_COILS < (maxBytes * 8)) ? MODBUS_MAX_READ_COILS : (maxBytes * 8));
+            break;
+        case ModbusFunctionT::READ_HOLDING_REGISTERS:
+        case ModbusFunctionT::READ_INPUT_REGISTERS:
+            maxLen = ((MODBUS_MAX_READ_REGISTERS < (maxBytes / 2)) ? MODBUS_MAX_READ_REGISTERS : (maxBytes / 2));
+            break;
+        default:
+            return false;
+    }
+    if ((head.addr != config.addr) ||
+        (head.func != config.func) ||
+        (head.ipSlave.ip.dword != config.ipSlave.ip.dword) ||
+        (head.ipSlave.port != config.ipSlave.port) ||
+        (head.groupCount == 0xFF) ||
+        !head.groupLen ||
+        !config.groupLen) {
+        return false;
+    }
+    uint32_t headEnd = (uint32_t)head.groupStart + head.groupLen;
+    uint32_t configEnd = (uint32_t)config.groupStart + config.groupLen;
+    if ((config.groupStart > headEnd) ||
+        (configEnd < head.groupStart)) {
+        return false;
+    }
+    uint16_t start = ((config.groupStart < head.groupStart) ? config.groupStart : head.groupStart);
+    uint32_t end = ((configEnd > headEnd) ? configEnd : headEnd);
+    if ((end - start) > maxLen) {
+        return false;
+    }
+    head.groupStart = start;
+    head.groupLen = (uint16_t)(end - start);
+    head.groupCount++;
+    return true;
+}
+
 inline
 void ERaApplication::parseOneConfigSensorReadWrite(char* ptr, size_t len, ModbusConfig_t& config) {
     LOC_BUFFER_PARSE
@@ -21,6 +21,7 @@
     #define FILENAME_MODBUS_CONFIG      "database/modbus/config.txt"
     #define FILENAME_MODBUS_CONTROL     "database/modbus/control.txt"
     #define FILENAME_ZIGBEE_DEVICES     "database/zigbee/devices.txt"
+    #define FILENAME_ZIGBEE_STORE       "database/zigbee/devices.log"
 #elif defined(ARDUINO_ARCH_STM32)
     #define FILENAME_BT_CONFIG          "bt/config.txt"
     #define FILENAME_PIN_CONFIG         "pin/config.txt"
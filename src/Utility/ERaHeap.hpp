@@ -0,0 +1,153 @@
+#ifndef INC_ERA_HEAP_HPP_
+#define INC_ERA_HEAP_HPP_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <Utility/ERaUtility.hpp>
+
+/* Longest wait a deadline can express, also returned when nothing is queued */
+#define ERA_MAX_DEADLINE        (MillisTime_t)(((MillisTime_t)~(MillisTime_t)0) >> 1)
+
+/* Binary min-heap ordered by deadline.
+   T needs "MillisTime_t deadline" and "int heapIndex" members,
+   heapIndex must be -1 while the entry is not queued.
+   Deadlines are compared across the millis wrap, so queued
+   deadlines must stay within ERA_MAX_DEADLINE of each other. */
+template <class T, int N>
+class ERaHeap
+{
+public:
+    ERaHeap()
+        : entries()
+        , count(0)
+    {}
+    ~ERaHeap()
+    {}
+
+    bool isEmpty() const {
+        return !this->count;
+    }
+
+    size_t size() const {
+        return (size_t)this->count;
+    }
+
+    T* top() const {
+        return (this->count ? this->entries[0] : nullptr);
+    }
+
+    bool isDue(MillisTime_t now) const {
+        if (!this->count) {
+            return false;
+        }
+        return !ERaHeap::isBefore(now, this->entries[0]->deadline);
+    }
+
+    /* Milliseconds until the first entry is due */
+    MillisTime_t remaining(MillisTime_t now) const {
+        if (!this->count) {
+            return ERA_MAX_DEADLINE;
+        }
+        if (this->isDue(now)) {
+            return 0;
+        }
+        return (MillisTime_t)(this->entries[0]->deadline - now);
+    }
+
+    /* Queue the entry or move it to its new deadline */
+    bool schedule(T* entry, MillisTime_t deadline) {
+        if (entry == nullptr) {
+            return false;
+        }
+        entry->deadline = deadline;
+        if (entry->heapIndex < 0) {
+            if (this->count >= N) {
+                return false;
+            }
+            entry->heapIndex = this->count;
+            this->entries[this->count++] = entry;
+        }
+        this->siftUp(this->siftDown(entry->heapIndex));
+        return true;
+    }
+
+    T* pop() {
+        T* entry = this->top();
+        this->remove(entry);
+        return entry;
+    }
+
+    void remove(T* entry) {
+        if ((entry == nullptr) || (entry->heapIndex < 0) ||
+            (entry->heapIndex >= this->count) ||
+            (this->entries[entry->heapIndex] != entry)) {
+            return;
+        }
+        int index = entry->heapIndex;
+        entry->heapIndex = -1;
+        if (index != --this->count) {
+            this->place(index, this->entries[this->count]);
+            this->siftUp(this->siftDown(index));
+        }
+        this->entries[this->count] = nullptr;
+    }
+
+    void clear() {
+        for (int i = 0; i < this->count; ++i) {
+            this->entries[i]->heapIndex = -1;
+            this->entries[i] = nullptr;
+        }
+        this->count = 0;
+    }
+
+protected:
+private:
+    static bool isBefore(MillisTime_t a, MillisTime_t b) {
+        return ((MillisTime_t)(a - b) > ERA_MAX_DEADLINE);
+    }
+
+    void place(int index, T* entry) {
+        this->entries[index] = entry;
+        entry->heapIndex = index;
+    }
+
+    int siftUp(int index) {
+        T* entry = this->entries[index];
+        while (index > 0) {
+            int parent = ((index - 1) / 2);
+            if (!ERaHeap::isBefore(entry->deadline, this->entries[parent]->deadline)) {
+                break;
+            }
+            this->place(index, this->entries[parent]);
+            index = parent;
+        }
+        this->place(index, entry);
+        return index;
+    }
+
+    int siftDown(int index) {
+        T* entry = this->entries[index];
+        while (true) {
+            int child = ((index * 2) + 1);
+            if (child >= this->count) {
+                break;
+            }
+            if (((child + 1) < this->count) &&
+                ERaHeap::isBefore(this->entries[child + 1]->deadline, this->entries[child]->deadline)) {
+                child++;
+            }
+            if (!ERaHeap::isBefore(this->entries[child]->deadline, entry->deadline)) {
+                break;
+            }
+            this->place(index, this->entries[child]);
+            index = child;
+        }
+        this->place(index, entry);
+        return index;
+    }
+
+    T* entries[N];
+    int count;
+};
+
+#endif /* INC_ERA_HEAP_HPP_ */
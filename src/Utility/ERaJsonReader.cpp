@@ -0,0 +1,453 @@
+#include <stdlib.h>
+#include <ERa/ERaDefine.hpp>
+#include <Utility/ERaLoc.hpp>
+#include <Utility/ERaJsonReader.hpp>
+
+int ERaJsonReader::getInt() const {
+    double number = this->getDouble();
+    if (number >= (double)INT32_MAX) {
+        return INT32_MAX;
+    }
+    else if (number <= (double)INT32_MIN) {
+        return INT32_MIN;
+    }
+    return (int)number;
+}
+
+double ERaJsonReader::getDouble() const {
+    if (!this->isNumber()) {
+        return 0.0;
+    }
+    /* Number was validated, strtod stops at the delimiter */
+    return strtod(this->ptr, nullptr);
+}
+
+size_t ERaJsonReader::getStringLength() const {
+    if (!this->isString()) {
+        return 0;
+    }
+    return ERaJsonReader::unescape(this->ptr, this->ptr + this->length, nullptr, 0);
+}
+
+bool ERaJsonReader::getString(char* buf, size_t size) const {
+    if ((buf == nullptr) || !size) {
+        return false;
+    }
+    if (!this->isString()) {
+        buf[0] = '\0';
+        return false;
+    }
+    size_t len = ERaJsonReader::unescape(this->ptr, this->ptr + this->length, buf, size);
+    return (len < size);
+}
+
+char* ERaJsonReader::dupString() const {
+    if (!this->isString()) {
+        return nullptr;
+    }
+    size_t len = this->getStringLength();
+    char* buf = (char*)ERA_MALLOC(len + 1);
+    if (buf == nullptr) {
+        return nullptr;
+    }
+    ERaJsonReader::unescape(this->ptr, this->ptr + this->length, buf, len + 1);
+    return buf;
+}
+
+char* ERaJsonReader::getStringInSitu() {
+    if (!this->isString()) {
+        return nullptr;
+    }
+    /* Unescaped text is never longer than the escaped one,
+       so writing behind the read position is safe */
+    char* buf = const_cast<char*>(this->ptr) + 1;
+    ERaJsonReader::unescape(this->ptr, this->ptr + this->length, buf, this->length);
+    return buf;
+}
+
+bool ERaJsonReader::equals(const char* str) const {
+    if ((str == nullptr) || !this->isString()) {
+        return false;
+    }
+    return ERaJsonReader::keyEquals(this->ptr, this->ptr + this->length, str, strlen(str));
+}
+
+ERaJsonReader ERaJsonReader::get(const char* path) const {
+    if (path == nullptr) {
+        return ERaJsonReader();
+    }
+    ERaJsonReader item = *this;
+    do {
+        const char* dot = strchr(path, '.');
+        size_t len = ((dot != nullptr) ? (size_t)(dot - path) : strlen(path));
+        item = item.member(path, len);
+        path = ((dot != nullptr) ? (dot + 1) : nullptr);
+    } while (item.isValid() && (path != nullptr));
+    return item;
+}
+
+size_t ERaJsonReader::size() const {
+    size_t count {0};
+    for (ERaJsonReader item = this->begin(); item.isValid(); item = item.next()) {
+        count++;
+    }
+    return count;
+}
+
+ERaJsonReader ERaJsonReader::at(size_t index) const {
+    ERaJsonReader item = this->begin();
+    while (index-- && item.isValid()) {
+        item = item.next();
+    }
+    return item;
+}
+
+ERaJsonReader ERaJsonReader::begin() const {
+    if (!this->isArray() && !this->isObject()) {
+        return ERaJsonReader();
+    }
+    /* limit points at the closing bracket */
+    return ERaJsonReader::element(this->ptr + 1, this->ptr + this->length - 1, this->isObject());
+}
+
+ERaJsonReader ERaJsonReader::next() const {
+    if (!this->isValid() || (this->limit == nullptr)) {
+        return ERaJsonReader();
+    }
+    const char* p = ERaJsonReader::skipSpace(this->ptr + this->length, this->limit);
+    if ((p >= this->limit) || (*p != ',')) {
+        return ERaJsonReader();
+    }
+    return ERaJsonReader::element(p + 1, this->limit, (this->name != nullptr));
+}
+
+bool ERaJsonReader::getName(char* buf, size_t size) const {
+    if ((buf == nullptr) || !size) {
+        return false;
+    }
+    buf[0] = '\0';
+    if (this->name == nullptr) {
+        return false;
+    }
+    const char* end = ERaJsonReader::skipString(this->name, this->ptr);
+    if (end == nullptr) {
+        return false;
+    }
+    size_t len = ERaJsonReader::unescape(this->name, end, buf, size);
+    return (len < size);
+}
+
+void ERaJsonReader::parse(const char* json, const char* end) {
+    ERaJsonTypeT _type {ERaJsonTypeT::ERA_JSON_INVALID};
+    const char* p = ERaJsonReader::skipSpace(json, end);
+    const char* q = ERaJsonReader::skipValue(p, end, _type);
+    if (q == nullptr) {
+        return;
+    }
+    this->ptr = p;
+    this->length = (size_t)(q - p);
+    this->type = _type;
+}
+
+ERaJsonReader ERaJsonReader::member(const char* key, size_t keyLen) const {
+    if (!this->isObject()) {
+        return ERaJsonReader();
+    }
+    for (ERaJsonReader item = this->begin(); item.isValid(); item = item.next()) {
+        const char* end = ERaJsonReader::skipString(item.name, item.ptr);
+        if (ERaJsonReader::keyEquals(item.name, end, key, keyLen)) {
+            return item;
+        }
+    }
+    return ERaJsonReader();
+}
+
+ERaJsonReader ERaJsonReader::element(const char* from, const char* limit, bool object) {
+    ERaJsonTypeT _type {ERaJsonTypeT::ERA_JSON_INVALID};
+    const char* key {nullptr};
+    const char* p = ERaJsonReader::skipSpace(from, limit);
+    if (p >= limit) {
+        return ERaJsonReader();
+    }
+    if (object) {
+        key = p;
+        p = ERaJsonReader::skipString(p, limit);
+        p = ERaJsonReader::skipSpace(p, limit);
+        if ((p == nullptr) || (p >= limit) || (*p != ':')) {
+            return ERaJsonReader();
+        }
+        p = ERaJsonReader::skipSpace(p + 1, limit);
+    }
+    const char* q = ERaJsonReader::skipValue(p, limit, _type);
+    if (q == nullptr) {
+        return ERaJsonReader();
+    }
+    return ERaJsonReader(p, q, key, limit, _type);
+}
+
+const char* ERaJsonReader::skipSpace(const char* p, const char* end) {
+    if (p == nullptr) {
+        return nullptr;
+    }
+    while ((p < end) && ((*p == ' ') || (*p == '\t') ||
+                         (*p == '\n') || (*p == '\r'))) {
+        ++p;
+    }
+    return p;
+}
+
+const char* ERaJsonReader::skipString(const char* p, const char* end) {
+    if ((p == nullptr) || (p >= end) || (*p != '\"')) {
+        return nullptr;
+    }
+    ++p;
+    while ((p < end) && (*p != '\0')) {
+        if (*p == '\"') {
+            return (p + 1);
+        }
+        if (*p == '\\') {
+            ++p;
+            if ((p >= end) || (*p == '\0')) {
+                break;
+            }
+        }
+        ++p;
+    }
+    return nullptr;
+}
+
+const char* ERaJsonReader::skipValue(const char* p, const char* end, ERaJsonTypeT& type, int depth) {
+    type = ERaJsonTypeT::ERA_JSON_INVALID;
+    if ((p == nullptr) || (p >= end)) {
+        return nullptr;
+    }
+    switch (*p) {
+        case '\"':
+            type = ERaJsonTypeT::ERA_JSON_STRING;
+            return ERaJsonReader::skipString(p, end);
+        case '{':
+        case '[': {
+            if (depth >= ERA_JSON_NESTING_LIMIT) {
+                return nullptr;
+            }
+            bool object = (*p == '{');
+            char close = (object ? '}' : ']');
+            ERaJsonTypeT child {ERaJsonTypeT::ERA_JSON_INVALID};
+            p = ERaJsonReader::skipSpace(p + 1, end);
+            if ((p < end) && (*p == close)) {
+                type = (object ? ERaJsonTypeT::ERA_JSON_OBJECT : ERaJsonTypeT::ERA_JSON_ARRAY);
+                return (p + 1);
+            }
+            while (p < end) {
+                if (object) {
+                    p = ERaJsonReader::skipSpace(ERaJsonReader::skipString(p, end), end);
+                    if ((p == nullptr) || (p >= end) || (*p != ':')) {
+                        return nullptr;
+                    }
+                    p = ERaJsonReader::skipSpace(p + 1, end);
+                }
+                p = ERaJsonReader::skipSpace(ERaJsonReader::skipValue(p, end, child, depth + 1), end);
+                if ((p == nullptr) || (p >= end)) {
+                    return nullptr;
+                }
+                if (*p == close) {
+                    type = (object ? ERaJsonTypeT::ERA_JSON_OBJECT : ERaJsonTypeT::ERA_JSON_ARRAY);
+                    return (p + 1);
+                }
+                if (*p != ',') {
+                    return nullptr;
+                }
+                p = ERaJsonReader::skipSpace(p + 1, end);
+            }
+            return nullptr;
+        }
+        case 't':
+            if (((end - p) >= 4) && !strncmp(p, "true", 4)) {
+                type = ERaJsonTypeT::ERA_JSON_TRUE;
+                return (p + 4);
+            }
+            return nullptr;
+        case 'f':
+            if (((end - p) >= 5) && !strncmp(p, "false", 5)) {
+                type = ERaJsonTypeT::ERA_JSON_FALSE;
+                return (p + 5);
+            }
+            return nullptr;
+        case 'n':
+            if (((end - p) >= 4) && !strncmp(p, "null", 4)) {
+                type = ERaJsonTypeT::ERA_JSON_NULL;
+                return (p + 4);
+            }
+            return nullptr;
+        default:
+            break;
+    }
+    if ((*p != '-') && ((*p < '0') || (*p > '9'))) {
+        return nullptr;
+    }
+    const char* start = p++;
+    while ((p < end) && (((*p >= '0') && (*p <= '9')) ||
+                         (*p == '.') || (*p == 'e') || (*p == 'E') ||
+                         (*p == '+') || (*p == '-'))) {
+        ++p;
+    }
+    if ((*start == '-') && (p == (start + 1))) {
+        return nullptr;
+    }
+    type = ERaJsonTypeT::ERA_JSON_NUMBER;
+    return p;
+}
+
+bool ERaJsonReader::keyEquals(const char* p, const char* end, const char* key, size_t keyLen) {
+    if ((p == nullptr) || (end == nullptr) || ((end - p) < 2)) {
+        return false;
+    }
+    size_t rawLen = (size_t)(end - p - 2);
+    if (memchr(p + 1, '\\', rawLen) == nullptr) {
+        return ((rawLen == keyLen) && !memcmp(p + 1, key, keyLen));
+    }
+    if (ERaJsonReader::unescape(p, end, nullptr, 0) != keyLen) {
+        return false;
+    }
+    char* buf = (char*)ERA_MALLOC(keyLen + 1);
+    if (buf == nullptr) {
+        return false;
+    }
+    ERaJsonReader::unescape(p, end, buf, keyLen + 1);
+    bool status = !memcmp(buf, key, keyLen);
+    free(buf);
+    buf = nullptr;
+    return status;
+}
+
+static inline int hexValue(char c) {
+    if ((c >= '0') && (c <= '9')) {
+        return (c - '0');
+    }
+    else if ((c >= 'a') && (c <= 'f')) {
+        return (c - 'a' + 10);
+    }
+    else if ((c >= 'A') && (c <= 'F')) {
+        return (c - 'A' + 10);
+    }
+    return -1;
+}
+
+static inline bool parseHex4(const char* p, const char* end, uint32_t& value) {
+    if ((end - p) < 4) {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        int digit = hexValue(p[i]);
+        if (digit < 0) {
+            return false;
+        }
+        value = ((value << 4) | (uint32_t)digit);
+    }
+    return true;
+}
+
+/* p points at the opening quote, end right after the closing one.
+   Returns the unescaped length, out may be nullptr to only measure it. */
+size_t ERaJsonReader::unescape(const char* p, const char* end, char* out, size_t size) {
+    size_t len {0};
+    char utf8[4] {0};
+    size_t utf8Len {0};
+
+    if ((p == nullptr) || (end == nullptr) || ((end - p) < 2)) {
+        if ((out != nullptr) && size) {
+            out[0] = '\0';
+        }
+        return 0;
+    }
+
+    ++p;
+    --end;
+    while (p < end) {
+        if (*p != '\\') {
+            utf8[0] = *p++;
+            utf8Len = 1;
+        }
+        else if ((end - p) < 2) {
+            break;
+        }
+        else {
+            ++p;
+            utf8Len = 1;
+            switch (*p++) {
+                case 'b':
+                    utf8[0] = '\b';
+                    break;
+                case 'f':
+                    utf8[0] = '\f';
+                    break;
+                case 'n':
+                    utf8[0] = '\n';
+                    break;
+                case 'r':
+                    utf8[0] = '\r';
+                    break;
+                case 't':
+                    utf8[0] = '\t';
+                    break;
+                case 'u': {
+                    uint32_t code {0};
+                    if (!parseHex4(p, end, code)) {
+                        utf8Len = 0;
+                        break;
+                    }
+                    p += 4;
+                    if ((code >= 0xD800) && (code <= 0xDBFF)) {
+                        uint32_t low {0};
+                        if (((end - p) < 6) || (p[0] != '\\') || (p[1] != 'u') ||
+                            !parseHex4(p + 2, end, low) ||
+                            (low < 0xDC00) || (low > 0xDFFF)) {
+                            utf8Len = 0;
+                            break;
+                        }
+                        p += 6;
+                        code = (0x10000 + (((code & 0x3FF) << 10) | (low & 0x3FF)));
+                    }
+                    if (code < 0x80) {
+                        utf8[0] = (char)code;
+                    }
+                    else if (code < 0x800) {
+                        utf8[0] = (char)(0xC0 | (code >> 6));
+                        utf8[1] = (char)(0x80 | (code & 0x3F));
+                        utf8Len = 2;
+                    }
+                    else if (code < 0x10000) {
+                        utf8[0] = (char)(0xE0 | (code >> 12));
+                        utf8[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+                        utf8[2] = (char)(0x80 | (code & 0x3F));
+                        utf8Len = 3;
+                    }
+                    else {
+                        utf8[0] = (char)(0xF0 | (code >> 18));
+                        utf8[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+                        utf8[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+                        utf8[3] = (char)(0x80 | (code & 0x3F));
+                        utf8Len = 4;
+                    }
+                }
+                    break;
+                default:
+                    /* \" \\ \/ */
+                    utf8[0] = *(p - 1);
+                    break;
+            }
+        }
+        for (size_t i = 0; i < utf8Len; ++i) {
+            if ((out != nullptr) && ((len + 1) < size)) {
+                out[len] = utf8[i];
+            }
+            len++;
+        }
+    }
+
+    if ((out != nullptr) && size) {
+        out[((len < size) ? len : (size - 1))] = '\0';
+    }
+    return len;
+}
@@ -0,0 +1,178 @@
+#ifndef INC_ERA_JSON_READER_HPP_
+#define INC_ERA_JSON_READER_HPP_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define ERA_JSON_NESTING_LIMIT      64
+
+enum ERaJsonTypeT {
+    ERA_JSON_INVALID = 0,
+    ERA_JSON_NULL = 1,
+    ERA_JSON_FALSE = 2,
+    ERA_JSON_TRUE = 3,
+    ERA_JSON_NUMBER = 4,
+    ERA_JSON_STRING = 5,
+    ERA_JSON_ARRAY = 6,
+    ERA_JSON_OBJECT = 7
+};
+
+/* View of one JSON value inside a text buffer. Lookups scan the text
+   on demand, nothing is allocated and the text is never copied, so
+   picking "action" or "data.hash_id" out of a large payload costs
+   one pass over the bytes that precede it.
+   The text must outlive every reader taken from it. */
+class ERaJsonReader
+{
+public:
+    ERaJsonReader()
+        : ptr(nullptr)
+        , length(0)
+        , type(ERaJsonTypeT::ERA_JSON_INVALID)
+        , name(nullptr)
+        , limit(nullptr)
+    {}
+    ERaJsonReader(const char* json)
+        : ptr(nullptr)
+        , length(0)
+        , type(ERaJsonTypeT::ERA_JSON_INVALID)
+        , name(nullptr)
+        , limit(nullptr)
+    {
+        if (json != nullptr) {
+            this->parse(json, json + strlen(json));
+        }
+    }
+    ERaJsonReader(const char* json, size_t len)
+        : ptr(nullptr)
+        , length(0)
+        , type(ERaJsonTypeT::ERA_JSON_INVALID)
+        , name(nullptr)
+        , limit(nullptr)
+    {
+        if (json != nullptr) {
+            this->parse(json, json + len);
+        }
+    }
+    ~ERaJsonReader()
+    {}
+
+    bool isValid() const {
+        return (this->type != ERaJsonTypeT::ERA_JSON_INVALID);
+    }
+
+    bool isNull() const {
+        return (this->type == ERaJsonTypeT::ERA_JSON_NULL);
+    }
+
+    bool isBool() const {
+        return ((this->type == ERaJsonTypeT::ERA_JSON_FALSE) ||
+                (this->type == ERaJsonTypeT::ERA_JSON_TRUE));
+    }
+
+    bool isNumber() const {
+        return (this->type == ERaJsonTypeT::ERA_JSON_NUMBER);
+    }
+
+    bool isString() const {
+        return (this->type == ERaJsonTypeT::ERA_JSON_STRING);
+    }
+
+    bool isArray() const {
+        return (this->type == ERaJsonTypeT::ERA_JSON_ARRAY);
+    }
+
+    bool isObject() const {
+        return (this->type == ERaJsonTypeT::ERA_JSON_OBJECT);
+    }
+
+    ERaJsonTypeT getType() const {
+        return this->type;
+    }
+
+    /* Raw text of the value, strings include their quotes */
+    const char* getRaw() const {
+        return this->ptr;
+    }
+
+    size_t getRawLength() const {
+        return this->length;
+    }
+
+    bool getBool() const {
+        return (this->type == ERaJsonTypeT::ERA_JSON_TRUE);
+    }
+
+    int getInt() const;
+    double getDouble() const;
+
+    /* Unescaped length of a string value, without terminator */
+    size_t getStringLength() const;
+    /* Unescape into buf, returns false if it does not fit */
+    bool getString(char* buf, size_t size) const;
+    /* Unescape into a new ERA_MALLOC buffer, caller frees */
+    char* dupString() const;
+    /* Unescape in place, the text must be writable. Returns the
+       null terminated string, which starts right after the opening quote.
+       The surrounding text is no longer valid JSON afterwards */
+    char* getStringInSitu();
+
+    template <int size>
+    bool getString(char(&buf)[size]) const {
+        return this->getString(buf, size);
+    }
+
+    bool equals(const char* str) const;
+
+    /* Member lookup, "data.configuration" walks nested objects */
+    ERaJsonReader get(const char* path) const;
+    size_t size() const;
+    ERaJsonReader at(size_t index) const;
+
+    /* Iterate array elements or object members */
+    ERaJsonReader begin() const;
+    ERaJsonReader next() const;
+    /* Key of an object member obtained from begin()/next() */
+    bool getName(char* buf, size_t size) const;
+
+    ERaJsonReader operator [] (const char* path) const {
+        return this->get(path);
+    }
+
+    ERaJsonReader operator [] (size_t index) const {
+        return this->at(index);
+    }
+
+    operator bool() const {
+        return this->isValid();
+    }
+
+protected:
+private:
+    ERaJsonReader(const char* _ptr, const char* _end, const char* _name, const char* _limit, ERaJsonTypeT _type)
+        : ptr(_ptr)
+        , length((size_t)(_end - _ptr))
+        , type(_type)
+        , name(_name)
+        , limit(_limit)
+    {}
+
+    void parse(const char* json, const char* end);
+    ERaJsonReader member(const char* key, size_t keyLen) const;
+    static ERaJsonReader element(const char* from, const char* limit, bool object);
+
+    static const char* skipSpace(const char* p, const char* end);
+    static const char* skipString(const char* p, const char* end);
+    static const char* skipValue(const char* p, const char* end, ERaJsonTypeT& type, int depth = 0);
+    static bool keyEquals(const char* p, const char* end, const char* key, size_t keyLen);
+    static size_t unescape(const char* p, const char* end, char* out, size_t size);
+
+    const char* ptr;
+    size_t length;
+    ERaJsonTypeT type;
+    const char* name;
+    const char* limit;
+};
+
+#endif /* INC_ERA_JSON_READER_HPP_ */
@@ -683,6 +683,19 @@ long long ERaAtoll(const char* str) {
     return value;
 }
 
+/* CRC-32 (IEEE), chained by passing the previous result */
+uint32_t ERaCrc32(uint32_t crc, const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        for (int i = 0; i < 8; ++i) {
+            crc = ((crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1))));
+        }
+    }
+    return ~crc;
+}
+
 char* ERaDtostrf(double number, int decimal, char* str) {
     if (str == nullptr) {
         return nullptr;
@@ -33,6 +33,7 @@ uint8_t GSMToPercentage(uint8_t value);
 
 long long ERaAtoll(const char* str);
 char* ERaDtostrf(double number, int decimal, char* str);
+uint32_t ERaCrc32(uint32_t crc, const void* data, size_t len);
 
 template<typename T>
 inline
@@ -1,9 +1,16 @@
 #include <math.h>
+#include <float.h>
+#include <limits.h>
 #include <Utility/ERacJSON.hpp>
 #include <Utility/ERaUtility.hpp>
 
 using namespace std;
 
+static bool compare_double(double a, double b) {
+    double maxVal = ((fabs(a) > fabs(b)) ? fabs(a) : fabs(b));
+    return (fabs(a - b) <= (maxVal * DBL_EPSILON));
+}
+
 /* Utility for array list handling. */
 static void suffix_object(cJSON *prev, cJSON *item) {
     prev->next = item;
@@ -175,3 +182,181 @@ CJSON_PUBLIC(cJSON*) cJSON_SetNullToObject(cJSON * const object, const char * co
 CJSON_PUBLIC(cJSON_bool) cJSON_Empty(const cJSON * const object) {
     return (cJSON_IsNull(object) || (cJSON_IsString(object) && !strlen(object->valuestring)));
 }
+
+/* Append escaped string (with quotes) to output, same escaping as cJSON print_string_ptr. */
+static cJSON_bool print_string_preallocated(const char* const string, char** output, const char* const end) {
+    char* out = *output;
+    const unsigned char* input = (const unsigned char*)((string == NULL) ? "" : string);
+
+    if (out >= end) {
+        return false;
+    }
+    *out++ = '\"';
+    for (; *input != '\0'; ++input) {
+        char escape {0};
+        switch (*input) {
+            case '\"':
+                escape = '\"';
+                break;
+            case '\\':
+                escape = '\\';
+                break;
+            case '\b':
+                escape = 'b';
+                break;
+            case '\f':
+                escape = 'f';
+                break;
+            case '\n':
+                escape = 'n';
+                break;
+            case '\r':
+                escape = 'r';
+                break;
+            case '\t':
+                escape = 't';
+                break;
+            default:
+                break;
+        }
+        if (escape) {
+            if ((end - out) < 2) {
+                return false;
+            }
+            *out++ = '\\';
+            *out++ = escape;
+        }
+        else if (*input < 32) {
+            if ((end - out) < 6) {
+                return false;
+            }
+            snprintf(out, 7, "\\u%04x", *input);
+            out += 6;
+        }
+        else {
+            if (out >= end) {
+                return false;
+            }
+            *out++ = (char)*input;
+        }
+    }
+    if (out >= end) {
+        return false;
+    }
+    *out++ = '\"';
+    *output = out;
+    return true;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintNumberPreallocated(const double number, int decimal, char *buffer, const int length) {
+    if ((buffer == NULL) || (length <= 0)) {
+        return false;
+    }
+
+    int size {0};
+    char number_buffer[26] {0};
+
+    if (isnan(number) || isinf(number)) {
+        size = snprintf(number_buffer, sizeof(number_buffer), "null");
+    }
+    else if ((round(number) == number) || (decimal <= 0) ||
+            (number > 4294967040.0) || (number < -4294967040.0)) {
+        if ((number >= INT_MIN) && (number <= INT_MAX) &&
+            (number == (double)(int)number)) {
+            size = snprintf(number_buffer, sizeof(number_buffer), "%d", (int)number);
+        }
+        else {
+            /* Same as cJSON, 17 digits when 15 do not round-trip */
+            double test {0.0};
+            size = snprintf(number_buffer, sizeof(number_buffer), "%1.15g", number);
+            if ((sscanf(number_buffer, "%lg", &test) != 1) || !compare_double(test, number)) {
+                size = snprintf(number_buffer, sizeof(number_buffer), "%1.17g", number);
+            }
+        }
+    }
+    else if (fabs(number) < 1.0) {
+        /* Same significant digits as cJSON_AddNumberWithDecimalToObject */
+        char number_format[16] {0};
+        double n = number;
+        while (fabs(n) < 1.0 && --decimal) {
+            n *= 10;
+        }
+        /* A double has no more than 17 significant digits */
+        snprintf(number_format, sizeof(number_format), "%%.%dg", ERaMin(decimal + 1, 17));
+        size = snprintf(number_buffer, sizeof(number_buffer), number_format, number);
+    }
+    else {
+        /* Fixed point with ERaDtostrf, then drop the trailing zeros */
+        ERaDtostrf(number, ERaMin(decimal, 9), number_buffer);
+        size = (int)strlen(number_buffer);
+        if (strchr(number_buffer, '.') != NULL) {
+            while ((size > 0) && (number_buffer[size - 1] == '0')) {
+                number_buffer[--size] = '\0';
+            }
+            if ((size > 0) && (number_buffer[size - 1] == '.')) {
+                number_buffer[--size] = '\0';
+            }
+        }
+    }
+
+    if ((size <= 0) || (size >= length)) {
+        return false;
+    }
+    memcpy(buffer, number_buffer, size + 1);
+    return true;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintStringObjectPreallocated(const char* const name, const char* const string, char *buffer, const int length) {
+    if ((buffer == NULL) || (length < 3)) {
+        return false;
+    }
+
+    char* out = buffer;
+    const char* end = buffer + length - 1;
+
+    *out++ = '{';
+    if (!print_string_preallocated(name, &out, end)) {
+        return false;
+    }
+    if (out >= end) {
+        return false;
+    }
+    *out++ = ':';
+    if (!print_string_preallocated(string, &out, end)) {
+        return false;
+    }
+    if (out >= end) {
+        return false;
+    }
+    *out++ = '}';
+    *out = '\0';
+    return true;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintNumberObjectPreallocated(const char* const name, const double number, int decimal, char *buffer, const int length) {
+    if ((buffer == NULL) || (length < 3)) {
+        return false;
+    }
+
+    char* out = buffer;
+    const char* end = buffer + length - 1;
+
+    *out++ = '{';
+    if (!print_string_preallocated(name, &out, end)) {
+        return false;
+    }
+    if (out >= end) {
+        return false;
+    }
+    *out++ = ':';
+    if (!cJSON_PrintNumberPreallocated(number, decimal, out, (int)(end - out))) {
+        return false;
+    }
+    out += strlen(out);
+    if (out >= end) {
+        return false;
+    }
+    *out++ = '}';
+    *out = '\0';
+    return true;
+}
@@ -19,4 +19,10 @@ CJSON_PUBLIC(cJSON*) cJSON_SetStringToObject(cJSON * const object, const char *
 CJSON_PUBLIC(cJSON*) cJSON_SetNullToObject(cJSON * const object, const char * const name);
 CJSON_PUBLIC(cJSON_bool) cJSON_Empty(const cJSON * const object);
 
+/* Render {"name":value} straight into a caller-owned buffer, without building a cJSON tree.
+ * Returns false if the buffer is too small, the caller can then fall back to cJSON_Print. */
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintNumberPreallocated(const double number, int decimal, char *buffer, const int length);
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintStringObjectPreallocated(const char* const name, const char* const string, char *buffer, const int length);
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintNumberObjectPreallocated(const char* const name, const double number, int decimal, char *buffer, const int length);
+
 #endif /* INC_ERA_CJSON_HPP_ */
@@ -6,6 +6,7 @@
 #include <Utility/ERaUtility.hpp>
 #include "definition/ERaDefineZigbee.hpp"
 #include "utility/ERaUtilityZigbee.hpp"
+#include "utility/ERaZnpPending.hpp"
 
 template <class ToZigbee>
 class ERaCommandZigbee
@@ -222,13 +223,20 @@ protected:
 
     ResultT resetFactoryDefaultsGenBasic(AFAddrType_t& dstAddr);
 
-    ResultT onoffGenOnOff(AFAddrType_t& dstAddr, uint8_t state);
-    ResultT onWithTimeOffGenOnOff(AFAddrType_t& dstAddr, uint8_t ctrlBits, uint16_t onTime, uint16_t offWaitTime);
+    /* With a callback the command is queued and the result delivered later */
+    ResultT onoffGenOnOff(AFAddrType_t& dstAddr, uint8_t state,
+                        ERaZnpCallback_t callback = nullptr, void* args = nullptr);
+    ResultT onWithTimeOffGenOnOff(AFAddrType_t& dstAddr, uint8_t ctrlBits, uint16_t onTime, uint16_t offWaitTime,
+                                ERaZnpCallback_t callback = nullptr, void* args = nullptr);
 
-    ResultT moveToLevelGenLevelCtrl(AFAddrType_t& dstAddr, uint8_t level, uint16_t transtime);
-    ResultT stopGenLevelCtrl(AFAddrType_t& dstAddr);
-    ResultT moveToLevelWithOnOffGenLevelCtrl(AFAddrType_t& dstAddr, uint8_t level, uint16_t transtime);
-    ResultT stopWithOnOffGenLevelCtrl(AFAddrType_t& dstAddr);
+    ResultT moveToLevelGenLevelCtrl(AFAddrType_t& dstAddr, uint8_t level, uint16_t transtime,
+                                    ERaZnpCallback_t callback = nullptr, void* args = nullptr);
+    ResultT stopGenLevelCtrl(AFAddrType_t& dstAddr,
+                            ERaZnpCallback_t callback = nullptr, void* args = nullptr);
+    ResultT moveToLevelWithOnOffGenLevelCtrl(AFAddrType_t& dstAddr, uint8_t level, uint16_t transtime,
+                                            ERaZnpCallback_t callback = nullptr, void* args = nullptr);
+    ResultT stopWithOnOffGenLevelCtrl(AFAddrType_t& dstAddr,
+                                    ERaZnpCallback_t callback = nullptr, void* args = nullptr);
 
 private:
 	inline
@@ -5,6 +5,10 @@
 #include <Utility/ERacJSON.hpp>
 #include "definition/ERaDefineZigbee.hpp"
 
+#if defined(LINUX)
+    #include <Utility/ERaStoreLinux.hpp>
+#endif
+
 template <class Zigbee>
 class ERaDBZigbee
 {
@@ -14,6 +18,9 @@ public:
     ERaDBZigbee()
         : device(InfoDevice_t::instance())
         , coordinator(InfoCoordinator_t::instance())
+#if defined(LINUX)
+        , store(FILENAME_ZIGBEE_STORE)
+#endif
     {}
     ~ERaDBZigbee()
     {}
@@ -21,6 +28,8 @@ public:
 protected:
     void parseZigbeeDevice();
     void storeZigbeeDevice();
+    void storeZigbeeDevice(const IdentDeviceAddr_t& deviceInfo);
+    void removeZigbeeDevice(const uint8_t* ieeeAddr);
     IdentDeviceAddr_t* getDeviceFromCoordinator();
     IdentDeviceAddr_t* setDeviceToCoordinator(bool final);
 
@@ -28,6 +37,9 @@ private:
     void parseDevice(const cJSON* const root);
     cJSON* createDevice(const IdentDeviceAddr_t& deviceInfo);
     void checkDevice();
+#if defined(LINUX)
+    void replayZigbeeDevice();
+#endif
 
 	inline
 	const Zigbee& thisZigbee() const {
@@ -41,24 +53,23 @@ private:
 
     InfoDevice_t*& device;
     InfoCoordinator_t*& coordinator;
+#if defined(LINUX)
+    ERaStoreLinux store;
+#endif
 };
 
 template <class Zigbee>
 void ERaDBZigbee<Zigbee>::parseDevice(const cJSON* const root) {
-    if (this->coordinator->deviceCount >= MAX_DEVICE_ZIGBEE) {
-        return;
-    }
-
-    IdentDeviceAddr_t& deviceInfo = coordinator->deviceIdent[coordinator->deviceCount++];
+    IdentDeviceAddr_t deviceInfo {};
 
     deviceInfo.isConnected = true;
     cJSON* typeItem = cJSON_GetObjectItem(root, "type");
 	if (cJSON_IsNumber(typeItem)) {
-		deviceInfo.typeDevice = typeItem->valueint;
+		deviceInfo.typeDevice = static_cast<uint8_t>(typeItem->valueint);
     }
     cJSON* nwkItem = cJSON_GetObjectItem(root, "nwk_addr");
 	if (cJSON_IsNumber(nwkItem)) {
-		deviceInfo.address.addr.nwkAddr = nwkItem->valueint;
+		deviceInfo.address.addr.nwkAddr = static_cast<uint16_t>(nwkItem->valueint);
     }
     cJSON* ieeeItem = cJSON_GetObjectItem(root, "ieee_addr");
 	if (cJSON_IsString(ieeeItem)) {
@@ -66,17 +77,37 @@ void ERaDBZigbee<Zigbee>::parseDevice(const cJSON* const root) {
     }
 	cJSON* appVerItem = cJSON_GetObjectItem(root, "app_ver");
 	if (cJSON_IsNumber(appVerItem)) {
-		deviceInfo.appVer = appVerItem->valueint;
+		deviceInfo.appVer = static_cast<uint8_t>(appVerItem->valueint);
     }
 	cJSON* modelItem = cJSON_GetObjectItem(root, "model");
 	if (cJSON_IsString(modelItem)) {
 		ClearMem(deviceInfo.modelName);
         CopyString(modelItem->valuestring, deviceInfo.modelName);
     }
+
+    /* Later records of the same device win */
+    IdentDeviceAddr_t* entry = this->coordinator->devices.find(deviceInfo.address.addr.ieeeAddr);
+    if (entry == nullptr) {
+        this->coordinator->devices.add(deviceInfo);
+        return;
+    }
+    entry->typeDevice = deviceInfo.typeDevice;
+    entry->appVer = deviceInfo.appVer;
+    this->coordinator->devices.setNwkAddr(entry, deviceInfo.address.addr.nwkAddr);
+    ClearMem(entry->modelName);
+    CopyString(deviceInfo.modelName, entry->modelName);
 }
 
 template <class Zigbee>
 void ERaDBZigbee<Zigbee>::parseZigbeeDevice() {
+#if defined(LINUX)
+    if (this->store.exists()) {
+        this->replayZigbeeDevice();
+        this->checkDevice();
+        return;
+    }
+#endif
+
     char* ptr = nullptr;
     cJSON* item = nullptr;
     // Begin read from flash
@@ -100,7 +131,44 @@ void ERaDBZigbee<Zigbee>::parseZigbeeDevice() {
     this->checkDevice();
     item = nullptr;
 	ptr = nullptr;
+
+#if defined(LINUX)
+    /* Carry the line file over to the log */
+    if (this->coordinator->devices.size()) {
+        this->storeZigbeeDevice();
+    }
+#endif
+}
+
+#if defined(LINUX)
+template <class Zigbee>
+void ERaDBZigbee<Zigbee>::replayZigbeeDevice() {
+    cJSON* item = nullptr;
+    const ERaStoreRecord_t* record = nullptr;
+    if (!this->store.beginRead()) {
+        return;
+    }
+    while ((record = this->store.read()) != nullptr) {
+        if (record->erase) {
+            uint8_t ieeeAddr[LENGTH_EXTADDR_IEEE] {0};
+            StringToIEEE(record->key, ieeeAddr);
+            this->coordinator->removeDevice(this->coordinator->devices.find(ieeeAddr));
+            continue;
+        }
+        item = cJSON_Parse(record->value);
+        if (cJSON_IsObject(item)) {
+            this->parseDevice(item);
+        }
+        cJSON_Delete(item);
+    }
+    this->store.endRead();
+    item = nullptr;
+
+    if (this->store.needCompact(this->coordinator->devices.size())) {
+        this->storeZigbeeDevice();
+    }
 }
+#endif
 
 template <class Zigbee>
 cJSON* ERaDBZigbee<Zigbee>::createDevice(const IdentDeviceAddr_t& deviceInfo) {
@@ -124,10 +192,34 @@ template <class Zigbee>
 void ERaDBZigbee<Zigbee>::storeZigbeeDevice() {
     char* ptr = nullptr;
     cJSON* item = nullptr;
+#if defined(LINUX)
+    /* Snapshot of the registry replaces the log */
+    if (!this->store.beginCompact()) {
+        return;
+    }
+    for (size_t i = 0; i < this->coordinator->devices.size(); ++i) {
+        const IdentDeviceAddr_t* deviceInfo = this->coordinator->devices[i];
+        if (deviceInfo == nullptr) {
+            continue;
+        }
+        item = this->createDevice(*deviceInfo);
+        ptr = cJSON_PrintUnformatted(item);
+        cJSON_Delete(item);
+        if (ptr != nullptr) {
+            this->store.compact(IEEEToString(deviceInfo->address.addr.ieeeAddr).c_str(), ptr);
+            free(ptr);
+        }
+    }
+    this->store.endCompact();
+#else
     // Begin write to flash
     this->thisZigbee().beginWriteToFlash(FILENAME_DEVICES);
-    for (size_t i = 0; i < this->coordinator->deviceCount; ++i) {
-        item = this->createDevice(this->coordinator->deviceIdent[i]);
+    for (size_t i = 0; i < this->coordinator->devices.size(); ++i) {
+        const IdentDeviceAddr_t* deviceInfo = this->coordinator->devices[i];
+        if (deviceInfo == nullptr) {
+            continue;
+        }
+        item = this->createDevice(*deviceInfo);
         ptr = cJSON_PrintUnformatted(item);
         cJSON_Delete(item);
         if (ptr != nullptr) {
@@ -138,15 +230,52 @@ void ERaDBZigbee<Zigbee>::storeZigbeeDevice() {
     }
     // End write to flash
     this->thisZigbee().endWriteToFlash();
+#endif
+    item = nullptr;
+    ptr = nullptr;
+}
+
+/* One device changed, a record on Linux, the whole file elsewhere */
+template <class Zigbee>
+void ERaDBZigbee<Zigbee>::storeZigbeeDevice(const IdentDeviceAddr_t& deviceInfo) {
+#if defined(LINUX)
+    cJSON* item = this->createDevice(deviceInfo);
+    char* ptr = cJSON_PrintUnformatted(item);
+    cJSON_Delete(item);
+    if (ptr != nullptr) {
+        this->store.put(IEEEToString(deviceInfo.address.addr.ieeeAddr).c_str(), ptr);
+        free(ptr);
+    }
+    if (this->store.needCompact(this->coordinator->devices.size())) {
+        this->storeZigbeeDevice();
+    }
     item = nullptr;
     ptr = nullptr;
+#else
+    ERA_FORCE_UNUSED(deviceInfo);
+    this->storeZigbeeDevice();
+#endif
+}
+
+/* Called once the device has left the registry */
+template <class Zigbee>
+void ERaDBZigbee<Zigbee>::removeZigbeeDevice(const uint8_t* ieeeAddr) {
+#if defined(LINUX)
+    uint8_t key[LENGTH_EXTADDR_IEEE] {0};
+    memcpy(key, ieeeAddr, sizeof(key));
+    this->store.erase(IEEEToString(key).c_str());
+    if (this->store.needCompact(this->coordinator->devices.size())) {
+        this->storeZigbeeDevice();
+    }
+#else
+    ERA_FORCE_UNUSED(ieeeAddr);
+    this->storeZigbeeDevice();
+#endif
 }
 
 template <class Zigbee>
 IdentDeviceAddr_t* ERaDBZigbee<Zigbee>::getDeviceFromCoordinator() {
-    IdentDeviceAddr_t* deviceInfo = std::find_if(std::begin(this->coordinator->deviceIdent), std::end(this->coordinator->deviceIdent),
-                                    find_deviceWithIEEEAddr_t(this->device->address.addr.ieeeAddr));
-    return ((deviceInfo != std::end(this->coordinator->deviceIdent)) ? deviceInfo : nullptr);
+    return this->coordinator->devices.find(this->device->address.addr.ieeeAddr);
 }
 
 template <class Zigbee>
@@ -156,19 +285,23 @@ IdentDeviceAddr_t* ERaDBZigbee<Zigbee>::setDeviceToCoordinator(bool final) {
     }
     IdentDeviceAddr_t* deviceInfo = this->getDeviceFromCoordinator();
     if (deviceInfo != nullptr) {
-        deviceInfo->address.addr.nwkAddr = this->device->address.addr.nwkAddr;
+        this->coordinator->devices.setNwkAddr(deviceInfo, this->device->address.addr.nwkAddr);
         if (!final) {
             return deviceInfo;
         }
     }
     else {
-        if ((this->coordinator->deviceCount >= MAX_DEVICE_ZIGBEE) ||
+        if (this->coordinator->devices.full() ||
             !strlen(this->device->modelName)) {
             return nullptr;
         }
-        deviceInfo = &this->coordinator->deviceIdent[this->coordinator->deviceCount++];
-        deviceInfo->address.addr.nwkAddr = this->device->address.addr.nwkAddr;
-        CopyArray(this->device->address.addr.ieeeAddr, deviceInfo->address.addr.ieeeAddr);
+        IdentDeviceAddr_t newDevice {};
+        newDevice.address.addr.nwkAddr = this->device->address.addr.nwkAddr;
+        CopyArray(this->device->address.addr.ieeeAddr, newDevice.address.addr.ieeeAddr);
+        deviceInfo = this->coordinator->devices.add(newDevice);
+        if (deviceInfo == nullptr) {
+            return nullptr;
+        }
     }
     deviceInfo->typeDevice = this->device->typeDevice;
     deviceInfo->appVer = this->device->appVer;
@@ -177,21 +310,24 @@ IdentDeviceAddr_t* ERaDBZigbee<Zigbee>::setDeviceToCoordinator(bool final) {
         CopyString(this->device->modelName, deviceInfo->modelName);
     }
     if (final) {
-        this->storeZigbeeDevice();
+        this->storeZigbeeDevice(*deviceInfo);
     }
     return deviceInfo;
 }
 
 template <class Zigbee>
 void ERaDBZigbee<Zigbee>::checkDevice() {
-    if (!this->coordinator->deviceCount) {
+    if (!this->coordinator->devices.size()) {
         return;
     }
-    for (int i = this->coordinator->deviceCount - 1; i >= 0; --i) {
-        if (IsZeroArray(this->coordinator->deviceIdent[i].address.addr.ieeeAddr) ||
-            !strlen(this->coordinator->deviceIdent[i].modelName)) {
-			std::move(std::begin(this->coordinator->deviceIdent) + i + 1, std::end(this->coordinator->deviceIdent), std::begin(this->coordinator->deviceIdent) + i);
-			this->coordinator->deviceCount--;
+    for (int i = static_cast<int>(this->coordinator->devices.size()) - 1; i >= 0; --i) {
+        IdentDeviceAddr_t* deviceInfo = this->coordinator->devices[i];
+        if (deviceInfo == nullptr) {
+            continue;
+        }
+        if (IsZeroArray(deviceInfo->address.addr.ieeeAddr) ||
+            !strlen(deviceInfo->modelName)) {
+			this->coordinator->removeDevice(deviceInfo);
         }
     }
 }
@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <Utility/ERacJSON.hpp>
 #include "definition/ERaDefineZigbee.hpp"
+#include "utility/ERaZnpFrame.hpp"
 
 template <class Zigbee>
 class ERaFromZigbee
@@ -17,7 +18,7 @@ public:
     {}
 
 protected:
-    Response_t fromZigbee(const uint8_t* payload, void* value = nullptr);
+    Response_t fromZigbee(uint8_t* payload, void* value = nullptr);
     void createDeviceEvent(const DeviceEventT event, const AFAddrType_t* dstAddr = nullptr);
 
 private:
@@ -30,21 +31,21 @@ private:
     bool temperatureMeasFromZigbee(const DataAFMsg_t& afMsg, cJSON* root, uint16_t attribute, uint64_t& value);
     bool pressureMeasFromZigbee(const DataAFMsg_t& afMsg, cJSON* root, uint16_t attribute, uint64_t& value);
     bool humidityMeasFromZigbee(const DataAFMsg_t& afMsg, cJSON* root, uint16_t attribute, uint64_t& value);
-    void processNodeDescriptor(vector<uint8_t>& data, void* value = nullptr);
-    void processSimpleDescriptor(vector<uint8_t>& data, void* value = nullptr);
-    void processActiveEndpoint(vector<uint8_t>& data, void* value = nullptr);
-    void processBindUnbind(vector<uint8_t>& data, void* value = nullptr);
-    void processTCDeviceIndication(vector<uint8_t>& data, void* value = nullptr);
-    void processZDOState(vector<uint8_t>& data, void* value = nullptr);
-    void processDeviceAnnounce(vector<uint8_t>& data, void* value = nullptr);
-    void processDeviceLeave(vector<uint8_t>& data, void* value = nullptr);
-    void processReadOsalNVItems(vector<uint8_t>& data, void* value = nullptr);
-    void processWriteOsalNVItems(vector<uint8_t>& data, void* value = nullptr);
-    void processLengthOsalNVItems(vector<uint8_t>& data, void* value = nullptr);
-    void processCoordVersion(vector<uint8_t>& data, void* value = nullptr);
-    void processReadConfig(vector<uint8_t>& data, void* value = nullptr);
-    void processDeviceInfo(vector<uint8_t>& data, void* value = nullptr);
-    bool getDataAFMsg(DataAFMsg_t& afMsg, vector<uint8_t>& data);
+    void processNodeDescriptor(ERaZnpView& data, void* value = nullptr);
+    void processSimpleDescriptor(ERaZnpView& data, void* value = nullptr);
+    void processActiveEndpoint(ERaZnpView& data, void* value = nullptr);
+    void processBindUnbind(ERaZnpView& data, void* value = nullptr);
+    void processTCDeviceIndication(ERaZnpView& data, void* value = nullptr);
+    void processZDOState(ERaZnpView& data, void* value = nullptr);
+    void processDeviceAnnounce(ERaZnpView& data, void* value = nullptr);
+    void processDeviceLeave(ERaZnpView& data, void* value = nullptr);
+    void processReadOsalNVItems(ERaZnpView& data, void* value = nullptr);
+    void processWriteOsalNVItems(ERaZnpView& data, void* value = nullptr);
+    void processLengthOsalNVItems(ERaZnpView& data, void* value = nullptr);
+    void processCoordVersion(ERaZnpView& data, void* value = nullptr);
+    void processReadConfig(ERaZnpView& data, void* value = nullptr);
+    void processDeviceInfo(ERaZnpView& data, void* value = nullptr);
+    bool getDataAFMsg(DataAFMsg_t& afMsg, ERaZnpView& data);
     void processDataAFMsg(const DataAFMsg_t& afMsg, Response_t& rsp, void* value = nullptr);
     void processFrameTypeGlobal(const DataAFMsg_t& afMsg, DefaultRsp_t& defaultRsp, void* value = nullptr);
     void processFrameTypeSpecific(const DataAFMsg_t& afMsg, DefaultRsp_t& defaultRsp, void* value = nullptr);
@@ -55,8 +56,8 @@ private:
     void processDefaultResponse(const DataAFMsg_t& afMsg, DefaultRsp_t& defaultRsp, void* value = nullptr);
     cJSON* createDeviceEndpoints();
     cJSON* createDevicePollControl();
-    bool getDataAttributes(const DataAFMsg_t& afMsg, DefaultRsp_t& defaultRsp, uint16_t nwkAddr, EndpointListT endpoint, vector<DataAttr_t> listAttr);
-    bool getDataAttributesRsp(const DataAFMsg_t& afMsg, DefaultRsp_t& defaultRsp, vector<DataReadAttrRsp_t> listData);
+    bool getDataAttributes(const DataAFMsg_t& afMsg, DefaultRsp_t& defaultRsp, uint16_t nwkAddr, EndpointListT endpoint, const vector<DataAttr_t>& listAttr);
+    bool getDataAttributesRsp(const DataAFMsg_t& afMsg, DefaultRsp_t& defaultRsp, const vector<DataReadAttrRsp_t>& listData);
     uint8_t getCheckSumReceive(const uint8_t* pData, size_t pDataLen);
 
     IdentDeviceAddr_t* createDataGlobal(const DataAFMsg_t& afMsg, uint16_t attribute, uint8_t type, uint64_t& value);
@@ -89,9 +90,8 @@ private:
 };
 
 template <class Zigbee>
-Response_t ERaFromZigbee<Zigbee>::fromZigbee(const uint8_t* payload, void* value) {
-    DataAFMsg_t afMsg {0};
-    vector<uint8_t> data;
+Response_t ERaFromZigbee<Zigbee>::fromZigbee(uint8_t* payload, void* value) {
+    DataAFMsg_t afMsg {};
     Response_t rsp {
         .nwkAddr = NO_NWK_ADDR,
         .type = TypeT::ERR,
@@ -111,7 +111,8 @@ Response_t ERaFromZigbee<Zigbee>::fromZigbee(const uint8_t* payload, void* value
 	uint8_t type = (payload[this->thisZigbee().PositionCmd0] & 0xE0) >> 5;
 	uint8_t sub = payload[this->thisZigbee().PositionCmd0] & 0x1F;
 	uint8_t cmd = payload[this->thisZigbee().PositionCmd1];
-    data.assign(payload + this->thisZigbee().DataStart, payload + this->thisZigbee().DataStart + length);
+    /* Read in place, the frame outlives the call */
+    ERaZnpView data(payload + this->thisZigbee().DataStart, length);
     if (data.size() > this->thisZigbee().MaxDataSize) {
         return rsp;
     }
@@ -235,7 +236,7 @@ Response_t ERaFromZigbee<Zigbee>::fromZigbee(const uint8_t* payload, void* value
 }
 
 template <class Zigbee>
-bool ERaFromZigbee<Zigbee>::getDataAFMsg(DataAFMsg_t& afMsg, vector<uint8_t>& data) {
+bool ERaFromZigbee<Zigbee>::getDataAFMsg(DataAFMsg_t& afMsg, ERaZnpView& data) {
     afMsg.groupId = BUILD_UINT16(data.at(0));
     afMsg.zclId = static_cast<ClusterIDT>(BUILD_UINT16(data.at(2)));
     afMsg.srcAddr.addrMode = AddressModeT::ADDR_16BIT;
@@ -267,7 +268,11 @@ bool ERaFromZigbee<Zigbee>::getDataAFMsg(DataAFMsg_t& afMsg, vector<uint8_t>& da
 	afMsg.cmdId = data.at(19 + manufShift);
 	afMsg.pDataLen = afMsg.len - ZCL_DATA_MIN - manufShift;
 	if (afMsg.pDataLen) {
-		afMsg.pData = &data.at(20 + manufShift);
+		/* pData is read without bounds checks, it must lie in the frame */
+		if ((20U + manufShift + afMsg.pDataLen) > data.size()) {
+			return false;
+		}
+		afMsg.pData = data.data() + 20 + manufShift;
     }
 	afMsg.radius = data.at(19 + afMsg.len); /* Radius (remain) - limits the number of hops */
 	if ((afMsg.radius < this->thisZigbee().Radius - 1) || (afMsg.zclId == ClusterIDT::ZCL_CLUSTER_GREEN_POWER)) { /* afMsg.srcEndpoint == ENDPOINT242 */
@@ -22,12 +22,15 @@ private:
 
 public:
     typedef ERaCommandZigbee< ERaToZigbee<Zigbee> > CommandZigbee;
+    typedef ERaZnpPending<ERA_ZIGBEE_MAX_PENDING> PendingZigbee;
 
     ERaToZigbee()
         : transId(0)
         , transIdZcl(0)
         , coordinator(InfoCoordinator_t::instance())
         , mutex(NULL)
+        , pending()
+        , mutexPending(NULL)
     {}
     ~ERaToZigbee()
     {}
@@ -35,6 +38,8 @@ public:
 protected:
     bool toZigbee(const cJSON* const root, AFAddrType_t& dstAddr, const ConvertToZigbeeT type);
     bool permitJoinToZigbee(const cJSON* const root);
+    bool completePending(const Response_t& rsp);
+    void expirePending();
 
 private:
     void handleZigbeeData() {
@@ -47,6 +52,26 @@ private:
     bool findDeviceInfoWithIEEEAddr(AFAddrType_t& dstAddr);
     void createBridgeDataZigbee(const char* subTopic, ResultT status, const cJSON* const item);
     ResultT waitResponse(Response_t rspWait, void* value);
+    bool addPending(const Response_t& wait, ERaZnpCallback_t callback, void* args);
+    void finishPending(const typename PendingZigbee::Pending_t& done, bool timeout);
+    static void resultCallback(ResultT status, void* args);
+
+    /* Network address carried to resultCallback() */
+    static void* resultArgs(const AFAddrType_t& dstAddr) {
+        return reinterpret_cast<void*>(static_cast<uintptr_t>(dstAddr.addr.nwkAddr));
+    }
+
+    void createFrame(vector<uint8_t>& command,
+                                const vector<uint8_t>& payload,
+                                TypeT type,
+                                SubsystemT sub,
+                                uint8_t cmd);
+    bool createDataRequest(vector<uint8_t>& payload,
+                                AFAddrType_t& dstAddr,
+                                EndpointListT srcEndpoint,
+                                ClusterIDT zclId,
+                                const vector<uint8_t>& data,
+                                uint8_t _transId);
     ResultT createCommandBuffer(const vector<uint8_t>& payload,
                                 TypeT type,
                                 SubsystemT sub,
@@ -94,6 +119,14 @@ private:
                                 uint8_t numRequest = 0x00,
                                 bool store = true,
                                 bool force = false);
+    ResultT sendCommandAsyncZigbee(HeaderZclFrame_t& zclHeader,
+                                AFAddrType_t& dstAddr,
+                                EndpointListT srcEndpoint,
+                                CommandsZcl_t cmd,
+                                ERaZnpCallback_t callback,
+                                void* args = nullptr,
+                                uint8_t cmdWait = AFCommandsT::AF_DATA_CONFIRM,
+                                uint32_t timeout = DEFAULT_TIMEOUT);
     uint8_t createFrameControl(HeaderZclFrame_t& zclHeader);
     void createZclHeader(vector<uint8_t>& payload, HeaderZclFrame_t& zclHeader, uint8_t _transIdZcl, uint8_t cmdId);
     uint8_t getCheckSumCommand(const vector<uint8_t>& data);
@@ -115,6 +148,8 @@ private:
 
     InfoCoordinator_t*& coordinator;
     ERaMutex_t mutex;
+    PendingZigbee pending;
+    ERaMutex_t mutexPending;
 };
 
 template <class Zigbee>
@@ -187,20 +222,24 @@ bool ERaToZigbee<Zigbee>::findDeviceInfoWithIEEEAddr(AFAddrType_t& dstAddr) {
     if (CompareArray(dstAddr.addr.ieeeAddr, this->coordinator->address.addr.ieeeAddr)) {
         return false;
     }
-    IdentDeviceAddr_t* deviceInfo = std::find_if(std::begin(this->coordinator->deviceIdent), std::end(this->coordinator->deviceIdent), find_deviceWithIEEEAddr_t(dstAddr.addr.ieeeAddr));
-    if (deviceInfo == std::end(this->coordinator->deviceIdent)) {
-        deviceInfo = &this->coordinator->deviceIdent[this->coordinator->deviceCount];
-        CopyArray(dstAddr.addr.ieeeAddr, deviceInfo->address.addr.ieeeAddr);
-        if (CommandZigbee::requestNwkAddrZstack(dstAddr, 0, 0) != ResultT::RESULT_SUCCESSFUL) {
-            ClearMem(deviceInfo, sizeof(IdentDeviceAddr_t));
+    IdentDeviceAddr_t* deviceInfo = this->coordinator->devices.find(dstAddr.addr.ieeeAddr);
+    if (deviceInfo == nullptr) {
+        if (this->coordinator->devices.full()) {
             return false;
         }
-        if (!deviceInfo->address.addr.nwkAddr) {
-            ClearMem(deviceInfo, sizeof(IdentDeviceAddr_t));
+        IdentDeviceAddr_t newDevice {};
+        CopyArray(dstAddr.addr.ieeeAddr, newDevice.address.addr.ieeeAddr);
+        if (CommandZigbee::requestNwkAddrZstack(dstAddr, 0, 0, &newDevice.address) != ResultT::RESULT_SUCCESSFUL) {
+            return false;
+        }
+        if (!newDevice.address.addr.nwkAddr) {
             return false;
         }
         /* Request model name */
-        this->coordinator->deviceCount++;
+        deviceInfo = this->coordinator->devices.add(newDevice);
+        if (deviceInfo == nullptr) {
+            return false;
+        }
         /* Store */
     }
     dstAddr.addrMode = AddressModeT::ADDR_16BIT;
@@ -224,15 +263,8 @@ ResultT ERaToZigbee<Zigbee>::createCommandBuffer(const vector<uint8_t>& payload,
                                                 uint8_t* _transId,
                                                 uint8_t* _transIdZcl) {
     vector<uint8_t> command;
-    uint8_t fcs {0};
     ResultT status {ResultT::RESULT_SUCCESSFUL};
-	command.push_back(this->thisZigbee().SOF);
-	command.push_back(payload.size());
-	command.push_back(((type << 5) & 0xE0) | (sub & 0x1F));
-	command.push_back(cmd);
-	command.insert(command.end(), payload.begin(), payload.end());
-    fcs = getCheckSumCommand(command);
-    command.push_back(fcs);
+    this->createFrame(command, payload, type, sub, cmd);
 
     this->sendCommand(command);
     status = this->waitResponse({nwkAddr, typeWait, (subWait == SubsystemT::RESERVED) ? sub : subWait,
@@ -252,11 +284,50 @@ ResultT ERaToZigbee<Zigbee>::createCommand(AFAddrType_t& dstAddr,
                                         uint8_t _transIdZcl,
                                         void* value,
                                         uint32_t timeout) {
-    if (dstAddr.addrMode != AddressModeT::ADDR_16BIT) {
+    vector<uint8_t> payload;
+    uint8_t _transId = ++this->transId;
+    if (!this->createDataRequest(payload, dstAddr, srcEndpoint, zclId, data, _transId)) {
         return ResultT::RESULT_FAIL;
     }
+
+    if (cmdWait == AFCommandsT::AF_INCOMING_MSG) {
+        return this->createCommandBuffer(payload, TypeT::SREQ, SubsystemT::AF_INTER, AFCommandsT::AF_DATA_REQUEST,
+                                        TypeT::AREQ, cmdWait, value, timeout,
+                                        SubsystemT::RESERVED, dstAddr.addr.nwkAddr, zclId, &_transId, &_transIdZcl);
+    }
+    else {
+        return this->createCommandBuffer(payload, TypeT::SREQ, SubsystemT::AF_INTER, AFCommandsT::AF_DATA_REQUEST,
+                                        TypeT::AREQ, cmdWait, value, timeout,
+                                        SubsystemT::RESERVED, NO_NWK_ADDR, ClusterIDT::NO_CLUSTER_ID, &_transId, &_transIdZcl);
+    }
+}
+
+template <class Zigbee>
+void ERaToZigbee<Zigbee>::createFrame(vector<uint8_t>& command,
+                                    const vector<uint8_t>& payload,
+                                    TypeT type,
+                                    SubsystemT sub,
+                                    uint8_t cmd) {
+	command.push_back(this->thisZigbee().SOF);
+	command.push_back(payload.size());
+	command.push_back(((type << 5) & 0xE0) | (sub & 0x1F));
+	command.push_back(cmd);
+	command.insert(command.end(), payload.begin(), payload.end());
+    command.push_back(this->getCheckSumCommand(command));
+}
+
+template <class Zigbee>
+bool ERaToZigbee<Zigbee>::createDataRequest(vector<uint8_t>& payload,
+                                            AFAddrType_t& dstAddr,
+                                            EndpointListT srcEndpoint,
+                                            ClusterIDT zclId,
+                                            const vector<uint8_t>& data,
+                                            uint8_t _transId) {
+    if (dstAddr.addrMode != AddressModeT::ADDR_16BIT) {
+        return false;
+    }
     if (!dstAddr.addr.nwkAddr) {
-        return ResultT::RESULT_FAIL;
+        return false;
     }
     if (dstAddr.endpoint == EndpointListT::ENDPOINT_NONE) {
         dstAddr.endpoint = EndpointListT::ENDPOINT1;
@@ -265,29 +336,18 @@ ResultT ERaToZigbee<Zigbee>::createCommand(AFAddrType_t& dstAddr,
         srcEndpoint = EndpointListT::ENDPOINT1;
     }
 
-    vector<uint8_t> payload;
 	payload.push_back(LO_UINT16(dstAddr.addr.nwkAddr));
 	payload.push_back(HI_UINT16(dstAddr.addr.nwkAddr));
 	payload.push_back(dstAddr.endpoint);
 	payload.push_back(srcEndpoint);
 	payload.push_back(LO_UINT16(zclId));
 	payload.push_back(HI_UINT16(zclId));
-	payload.push_back(++this->transId);
+	payload.push_back(_transId);
 	payload.push_back(this->thisZigbee().Options);
 	payload.push_back(this->thisZigbee().Radius);
 	payload.push_back(data.size());
 	payload.insert(payload.end(), data.begin(), data.end());
-
-    if (cmdWait == AFCommandsT::AF_INCOMING_MSG) {
-        return this->createCommandBuffer(payload, TypeT::SREQ, SubsystemT::AF_INTER, AFCommandsT::AF_DATA_REQUEST,
-                                        TypeT::AREQ, cmdWait, value, timeout,
-                                        SubsystemT::RESERVED, dstAddr.addr.nwkAddr, zclId, &this->transId, &_transIdZcl);
-    }
-    else {
-        return this->createCommandBuffer(payload, TypeT::SREQ, SubsystemT::AF_INTER, AFCommandsT::AF_DATA_REQUEST,
-                                        TypeT::AREQ, cmdWait, value, timeout,
-                                        SubsystemT::RESERVED, NO_NWK_ADDR, ClusterIDT::NO_CLUSTER_ID, &this->transId, &_transIdZcl);
-    }
+    return true;
 }
 
 template <class Zigbee>
@@ -352,6 +412,116 @@ ResultT ERaToZigbee<Zigbee>::sendCommandIdZigbee(HeaderZclFrame_t& zclHeader,
     return status;
 }
 
+/* Registered before the frame goes out, so an answer read by
+   another task right away still finds its request */
+template <class Zigbee>
+ResultT ERaToZigbee<Zigbee>::sendCommandAsyncZigbee(HeaderZclFrame_t& zclHeader,
+                                                    AFAddrType_t& dstAddr,
+                                                    EndpointListT srcEndpoint,
+                                                    CommandsZcl_t cmd,
+                                                    ERaZnpCallback_t callback,
+                                                    void* args,
+                                                    uint8_t cmdWait,
+                                                    uint32_t timeout) {
+    if (dstAddr.addrMode != AddressModeT::ADDR_16BIT) {
+        return ResultT::RESULT_FAIL;
+    }
+    if (!dstAddr.addr.nwkAddr) {
+        return ResultT::RESULT_FAIL;
+    }
+
+    vector<uint8_t> data;
+    uint8_t _transIdZcl = ++this->transIdZcl;
+    this->createZclHeader(data, zclHeader, _transIdZcl, cmd.command);
+	if(cmd.data != nullptr) {
+		data.insert(data.end(), cmd.data->begin(), cmd.data->end());
+    }
+
+    vector<uint8_t> payload;
+    uint8_t _transId = ++this->transId;
+    if (!this->createDataRequest(payload, dstAddr, srcEndpoint, cmd.zclId, data, _transId)) {
+        return ResultT::RESULT_FAIL;
+    }
+
+    bool incoming = (cmdWait == AFCommandsT::AF_INCOMING_MSG);
+    if (!this->addPending({(incoming ? dstAddr.addr.nwkAddr : static_cast<uint16_t>(NO_NWK_ADDR)), TypeT::AREQ, SubsystemT::AF_INTER,
+                        cmdWait, (incoming ? cmd.zclId : ClusterIDT::NO_CLUSTER_ID), _transId, _transIdZcl,
+                        ZnpCommandStatusT::INVALID_PARAM, timeout}, callback, args)) {
+        return ResultT::RESULT_TIMEOUT;
+    }
+
+    vector<uint8_t> command;
+    this->createFrame(command, payload, TypeT::SREQ, SubsystemT::AF_INTER, AFCommandsT::AF_DATA_REQUEST);
+    this->sendCommand(command);
+    return ResultT::RESULT_SUCCESSFUL;
+}
+
+/* Waits for a free slot while the window is full,
+   the reading task frees them as answers arrive */
+template <class Zigbee>
+bool ERaToZigbee<Zigbee>::addPending(const Response_t& wait, ERaZnpCallback_t callback, void* args) {
+    bool added {false};
+    MillisTime_t startMillis = ERaMillis();
+
+    do {
+        this->expirePending();
+        ERaGuardLock(this->mutexPending);
+        added = this->pending.add(wait, callback, args);
+        ERaGuardUnlock(this->mutexPending);
+        if (added) {
+            break;
+        }
+        ERA_ZIGBEE_YIELD();
+    } while (ERaRemainingTime(startMillis, MAX_TIMEOUT));
+    return added;
+}
+
+/* True when rsp answers a request in flight, it is
+   then kept out of the queue of the blocking waits */
+template <class Zigbee>
+bool ERaToZigbee<Zigbee>::completePending(const Response_t& rsp) {
+    typename PendingZigbee::Pending_t done;
+    ERaGuardLock(this->mutexPending);
+    bool found = this->pending.match(rsp, done);
+    ERaGuardUnlock(this->mutexPending);
+    if (done.used) {
+        this->finishPending(done, false);
+    }
+    return found;
+}
+
+template <class Zigbee>
+void ERaToZigbee<Zigbee>::expirePending() {
+    typename PendingZigbee::Pending_t done;
+    for (;;) {
+        ERaGuardLock(this->mutexPending);
+        bool found = this->pending.expire(done);
+        ERaGuardUnlock(this->mutexPending);
+        if (!found) {
+            break;
+        }
+        this->finishPending(done, true);
+    }
+}
+
+/* Called without the lock, a callback may send again */
+template <class Zigbee>
+void ERaToZigbee<Zigbee>::finishPending(const typename PendingZigbee::Pending_t& done, bool timeout) {
+    if (done.callback == nullptr) {
+        return;
+    }
+    done.callback(PendingZigbee::result(done, timeout), done.args);
+}
+
+template <class Zigbee>
+void ERaToZigbee<Zigbee>::resultCallback(ResultT status, void* args) {
+    if (status == ResultT::RESULT_SUCCESSFUL) {
+        return;
+    }
+    ERA_LOG(ERA_PSTR("Zigbee"), ERA_PSTR("Command to 0x%04X failed (%d)"),
+            static_cast<uint16_t>(reinterpret_cast<uintptr_t>(args)), status);
+}
+
 template <class Zigbee>
 uint8_t ERaToZigbee<Zigbee>::createFrameControl(HeaderZclFrame_t& zclHeader) {
 	bool manufSpec = (zclHeader.manufCode != ManufacturerCodesT::MANUF_CODE_NONE ? true : false);
@@ -14,6 +14,7 @@
 #include <Zigbee/ERaFromZigbee.hpp>
 #include <Zigbee/ERaDBZigbee.hpp>
 #include "utility/ERaUtilityZigbee.hpp"
+#include "utility/ERaZnpFrame.hpp"
 
 using namespace std;
 
@@ -71,6 +72,10 @@ public:
         , coordinator(InfoCoordinator_t::instance())
         , stream(NULL)
         , mutexData(NULL)
+        , mutexReport(NULL)
+#if defined(LINUX)
+        , decoder()
+#endif
         , _zigbeeTask(NULL)
         , _controlZigbeeTask(NULL)
         , _responseZigbeeTask(NULL)
@@ -134,6 +139,7 @@ protected:
                     this->initZigbee(false);
                     break;
             }
+            this->flushZigbeeData();
             this->timer.run();
             ERA_ZIGBEE_YIELD();
         }
@@ -169,6 +175,7 @@ protected:
                     break;
                 default:
                     this->handleDefaultResponse();
+                    ToZigbee::expirePending();
                     break;
             }
             ERA_ZIGBEE_YIELD();
@@ -205,6 +212,15 @@ private:
                         uint8_t* cmdStatus = nullptr,
                         Response_t* rspWait = nullptr,
                         void* value = nullptr);
+    bool processFrame(uint8_t* payload,
+                        size_t size,
+                        uint8_t* cmdStatus = nullptr,
+                        Response_t* rspWait = nullptr,
+                        void* value = nullptr);
+#if defined(LINUX)
+    bool nextFrame(ERaZnpView& frame);
+    void releaseFrame(const ERaZnpView& frame);
+#endif
     bool interviewDevice();
     void removeDevice(const cJSON* const root, AFAddrType_t& dstAddr);
     void removeDeviceWithAddr(AFAddrType_t& dstAddr);
@@ -235,8 +251,12 @@ private:
     template <typename T>
     bool isElementExist(const std::vector<T>& elementList, const T element);
 
-    void publishZigbeeData(const IdentDeviceAddr_t* deviceInfo, bool retained = true);
+    void publishZigbeeData(IdentDeviceAddr_t* deviceInfo, bool retained = true);
     void publishZigbeeData(const char* topic, cJSON* payload, bool retained = true);
+    void reportZigbeeData(IdentDeviceAddr_t* deviceInfo);
+    void flushZigbeeData();
+    void flushZigbeeData(IdentDeviceAddr_t* deviceInfo);
+    void publishZigbeeDelta(IdentDeviceAddr_t* deviceInfo);
     bool actionZigbee(const ZigbeeActionT type, const char* ieeeAddr, const cJSON* const payload);
     void getZigbeeAction();
     void zigbeeTimerCallback(void* args);
@@ -325,6 +345,10 @@ private:
     InfoCoordinator_t*& coordinator;
     Stream* stream;
     ERaMutex_t mutexData;
+    ERaMutex_t mutexReport;
+#if defined(LINUX)
+    ERaZnpDecoder decoder;
+#endif
     TaskHandle_t _zigbeeTask;
     TaskHandle_t _controlZigbeeTask;
     TaskHandle_t _responseZigbeeTask;
@@ -391,7 +415,6 @@ bool ERaZigbee<Api>::processZigbee(uint8_t* buffer,
     if (!length) {
         return false;
     }
-    Response_t rsp {0};
     for (int i = 0; i < length; ++i) {
         uint8_t b = buffer[i];
 
@@ -415,33 +438,8 @@ bool ERaZigbee<Api>::processZigbee(uint8_t* buffer,
             continue;
         }
         if (index == zStackLength + this->MinMessageLength) {
-            if (payload[this->PositionSOF] == this->SOF) {
-                ERaLogHex("ZB <<", payload, index);
-                rsp = FromZigbee::fromZigbee(payload, value);
-                if (rsp.type != TypeT::ERR) {
-                    if (rspWait == nullptr) {
-                        // sync
-                        if (this->queueRsp.writeable()) {
-                            this->queueRsp += rsp;
-                        }
-                    }
-                    else {
-                        if (cmdStatus != nullptr) {
-                            if (CheckAFdata_t(rsp, *rspWait)) {
-                                *cmdStatus = rsp.cmdStatus;
-                            }
-                            if (CompareRsp_t(rsp, *rspWait)) {
-                                return true;
-                            }
-                            if (CheckRsp_t(rsp, *rspWait)) {
-                                // sync
-                                if (this->queueRsp.writeable()) {
-                                    this->queueRsp += rsp;
-                                }
-                            }
-                        }
-                    }
-                }
+            if (this->processFrame(payload, index, cmdStatus, rspWait, value)) {
+                return true;
             }
             index = 0;
             zStackLength = 0;
@@ -454,17 +452,69 @@ bool ERaZigbee<Api>::processZigbee(uint8_t* buffer,
     return false;
 }
 
+/* One complete frame, true when it answers rspWait */
+template <class Api>
+bool ERaZigbee<Api>::processFrame(uint8_t* payload,
+                                    size_t size,
+                                    uint8_t* cmdStatus,
+                                    Response_t* rspWait,
+                                    void* value) {
+    if ((payload == nullptr) ||
+        (size < this->MinMessageLength) ||
+        (payload[this->PositionSOF] != this->SOF)) {
+        return false;
+    }
+    ERaLogHex("ZB <<", payload, size);
+    Response_t rsp = FromZigbee::fromZigbee(payload, value);
+    if (rsp.type == TypeT::ERR) {
+        return false;
+    }
+    if (ToZigbee::completePending(rsp)) {
+        return false;
+    }
+    if (rspWait == nullptr) {
+        // sync
+        if (this->queueRsp.writeable()) {
+            this->queueRsp += rsp;
+        }
+        return false;
+    }
+    if (cmdStatus == nullptr) {
+        return false;
+    }
+    if (CheckAFdata_t(rsp, *rspWait)) {
+        *cmdStatus = rsp.cmdStatus;
+    }
+    if (CompareRsp_t(rsp, *rspWait)) {
+        return true;
+    }
+    if (CheckRsp_t(rsp, *rspWait)) {
+        // sync
+        if (this->queueRsp.writeable()) {
+            this->queueRsp += rsp;
+        }
+    }
+    return false;
+}
+
+/* Full state, also the base of the next delta */
 template <class Api>
-void ERaZigbee<Api>::publishZigbeeData(const IdentDeviceAddr_t* deviceInfo, bool retained) {
-    if ((deviceInfo == nullptr) ||
-        (deviceInfo == std::end(this->coordinator->deviceIdent))) {
+void ERaZigbee<Api>::publishZigbeeData(IdentDeviceAddr_t* deviceInfo, bool retained) {
+    if (deviceInfo == nullptr) {
         return;
     }
     if ((deviceInfo->data.topic == nullptr) ||
         (deviceInfo->data.payload == nullptr)) {
         return;
     }
+    ERaGuardLock(this->mutexReport);
+    deviceInfo->data.pending = false;
+    ERaGuardUnlock(this->mutexReport);
     this->thisApi().zigbeeDataWrite(deviceInfo->data.topic, deviceInfo->data.payload, retained);
+#if defined(ERA_ZIGBEE_PUBLISH_DELTA)
+    cJSON_Delete(deviceInfo->data.published);
+    deviceInfo->data.published = cJSON_Duplicate(cJSON_GetObjectItem(deviceInfo->data.payload, "data"), true);
+#endif
 }
 
 template <class Api>
@@ -475,13 +525,115 @@ void ERaZigbee<Api>::publishZigbeeData(const char* topic, cJSON* payload, bool r
     this->thisApi().zigbeeDataWrite(topic, payload, retained);
 }
 
+/* Attribute reports of a device are held for the publish
+   window, so a burst of them costs one print and one publish */
+template <class Api>
+void ERaZigbee<Api>::reportZigbeeData(IdentDeviceAddr_t* deviceInfo) {
+    if (deviceInfo == nullptr) {
+        return;
+    }
+#if (ERA_ZIGBEE_PUBLISH_WINDOW > 0)
+    ERaGuardLock(this->mutexReport);
+    if (!deviceInfo->data.pending) {
+        deviceInfo->data.pending = true;
+        deviceInfo->data.reportMillis = ERaMillis();
+    }
+    ERaGuardUnlock(this->mutexReport);
+#else
+    this->flushZigbeeData(deviceInfo);
+#endif
+}
+
+/* The pending flag is the only record of a report,
+   a device stays pending until it is published */
+template <class Api>
+void ERaZigbee<Api>::flushZigbeeData() {
+#if (ERA_ZIGBEE_PUBLISH_WINDOW > 0)
+    for (size_t i = 0; i < this->coordinator->devices.size(); ++i) {
+        IdentDeviceAddr_t* deviceInfo = this->coordinator->devices[i];
+        if (deviceInfo == nullptr) {
+            continue;
+        }
+        bool expired {false};
+        ERaGuardLock(this->mutexReport);
+        if (deviceInfo->data.pending &&
+            !ERaRemainingTime(deviceInfo->data.reportMillis, ERA_ZIGBEE_PUBLISH_WINDOW)) {
+            expired = true;
+        }
+        ERaGuardUnlock(this->mutexReport);
+        if (expired) {
+            this->flushZigbeeData(deviceInfo);
+        }
+    }
+#endif
+}
+
+template <class Api>
+void ERaZigbee<Api>::flushZigbeeData(IdentDeviceAddr_t* deviceInfo) {
+    ERaGuardLock(this->mutexReport);
+    deviceInfo->data.pending = false;
+    ERaGuardUnlock(this->mutexReport);
+#if defined(ERA_ZIGBEE_PUBLISH_DELTA)
+    this->publishZigbeeDelta(deviceInfo);
+#else
+    this->publishZigbeeData(deviceInfo);
+#endif
+}
+
+/* Only the data items changed since the last publish, not
+   retained so the retained message keeps the full state */
+template <class Api>
+void ERaZigbee<Api>::publishZigbeeDelta(IdentDeviceAddr_t* deviceInfo) {
+    if ((deviceInfo->data.topic == nullptr) ||
+        (deviceInfo->data.payload == nullptr)) {
+        return;
+    }
+    cJSON* dataItem = cJSON_GetObjectItem(deviceInfo->data.payload, "data");
+    if (!cJSON_IsObject(dataItem)) {
+        return;
+    }
+    if (deviceInfo->data.published == nullptr) {
+        this->publishZigbeeData(deviceInfo);
+        return;
+    }
+
+    cJSON* root = cJSON_CreateObject();
+    cJSON* delta = cJSON_CreateObject();
+    if ((root == nullptr) || (delta == nullptr)) {
+        cJSON_Delete(root);
+        cJSON_Delete(delta);
+        return;
+    }
+
+    cJSON* item = nullptr;
+    cJSON_ArrayForEach(item, dataItem) {
+        const cJSON* prev = cJSON_GetObjectItem(deviceInfo->data.published, item->string);
+        if ((prev != nullptr) && cJSON_Compare(item, prev, true)) {
+            continue;
+        }
+        cJSON_AddItemToObject(delta, item->string, cJSON_Duplicate(item, true));
+    }
+
+    if (delta->child != nullptr) {
+        cJSON_SetStringToObject(root, "type", "zigbee_data");
+        cJSON_AddItemToObject(root, "data", delta);
+        this->publishZigbeeData(deviceInfo->data.topic, root, false);
+        cJSON_Delete(deviceInfo->data.published);
+        deviceInfo->data.published = cJSON_Duplicate(dataItem, true);
+    }
+    else {
+        cJSON_Delete(delta);
+    }
+    cJSON_Delete(root);
+}
+
 template <class Api>
 bool ERaZigbee<Api>::actionZigbee(const ZigbeeActionT type, const char* ieeeAddr, const cJSON* const payload) {
     if (ieeeAddr == nullptr || payload == nullptr) {
         return false;
     }
 
-    AFAddrType_t dstAddr {0};
+    AFAddrType_t dstAddr {};
 
     switch (type) {
         case ZigbeeActionT::ZIGBEE_ACTION_SET:
@@ -43,6 +43,25 @@
 
 #define ZIGBEE_BUFFER_SIZE      1024
 
+/* Receive buffer of the in place ZNP frame decoder */
+#if !defined(ERA_ZIGBEE_RX_BUFFER_SIZE)
+    #define ERA_ZIGBEE_RX_BUFFER_SIZE   ZIGBEE_BUFFER_SIZE
+#endif
+
+/* Reports of a device within this window (ms) go out
+   as one publish, 0 publishes every report */
+#if !defined(ERA_ZIGBEE_PUBLISH_WINDOW)
+    #define ERA_ZIGBEE_PUBLISH_WINDOW   100
+#endif
+
+/* Define ERA_ZIGBEE_PUBLISH_DELTA to publish only the
+   data items changed since the last flush of a device */
+
+/* AF requests in flight at once, commands sent with a callback */
+#if !defined(ERA_ZIGBEE_MAX_PENDING)
+    #define ERA_ZIGBEE_MAX_PENDING      8
+#endif
+
 #if !defined(ERA_ZIGBEE_YIELD)
     #if !defined(ERA_ZIGBEE_YIELD_MS)
         #define ERA_ZIGBEE_YIELD_MS 10
@@ -179,30 +179,21 @@ void ERaZigbee<Api>::removeDeviceWithAddr(AFAddrType_t& dstAddr) {
     if (!dstAddr.addr.nwkAddr && IsZeroArray(dstAddr.addr.ieeeAddr)) {
         return;
     }
-    bool hasRemove {false};
-    IdentDeviceAddr_t* element = std::begin(this->coordinator->deviceIdent);
-    while (element != std::end(this->coordinator->deviceIdent)) {
+    IdentDeviceAddr_t* element {nullptr};
+    uint8_t ieeeAddr[LENGTH_EXTADDR_IEEE] {0};
+    for (;;) {
         if (!IsZeroArray(dstAddr.addr.ieeeAddr)) {
-            element = std::find_if(element, std::end(this->coordinator->deviceIdent), find_deviceWithIEEEAddr_t(dstAddr.addr.ieeeAddr));
+            element = this->coordinator->devices.find(dstAddr.addr.ieeeAddr);
         }
         else {
-            element = std::find_if(element, std::end(this->coordinator->deviceIdent), find_deviceWithNwkAddr_t(dstAddr.addr.nwkAddr));
+            element = this->coordinator->devices.find(dstAddr.addr.nwkAddr);
         }
-        if (element == std::end(this->coordinator->deviceIdent)) {
+        if (element == nullptr) {
             break;
         }
-        hasRemove = true;
-        if (element->data.topic != nullptr) {
-            free(element->data.topic);
-            element->data.topic = nullptr;
-        }
-        if (element->data.payload != nullptr) {
-            free(element->data.payload);
-            element->data.payload = nullptr;
-        }
-    }
-    if (hasRemove) {
-        DBZigbee::storeZigbeeDevice();
+        CopyArray(element->address.addr.ieeeAddr, ieeeAddr);
+        this->coordinator->removeDevice(element);
+        DBZigbee::removeZigbeeDevice(ieeeAddr);
     }
 }
 
@@ -364,15 +364,16 @@ void ERaCommandZigbee<ToZigbee>::removeAllDevice(bool rejoin, bool removeChildre
 	option |= (removeChildren ? 0b10 : 0x00);
 
 	vector<uint8_t> payload;
-	for (size_t i = 0; i < this->coordinator->deviceCount; ++i) {
-		if (!this->coordinator->deviceIdent[i].address.addr.nwkAddr) {
+	for (size_t i = 0; i < this->coordinator->devices.size(); ++i) {
+		const IdentDeviceAddr_t* deviceInfo = this->coordinator->devices[i];
+		if ((deviceInfo == nullptr) || !deviceInfo->address.addr.nwkAddr) {
 			continue;
 		}
 		payload.clear();
-		payload.push_back(LO_UINT16(this->coordinator->deviceIdent[i].address.addr.nwkAddr));
-		payload.push_back(HI_UINT16(this->coordinator->deviceIdent[i].address.addr.nwkAddr));
+		payload.push_back(LO_UINT16(deviceInfo->address.addr.nwkAddr));
+		payload.push_back(HI_UINT16(deviceInfo->address.addr.nwkAddr));
 		if (force) {
-			payload.insert(payload.end(), this->coordinator->deviceIdent[i].address.addr.ieeeAddr, this->coordinator->deviceIdent[i].address.addr.ieeeAddr + LENGTH_EXTADDR_IEEE);
+			payload.insert(payload.end(), deviceInfo->address.addr.ieeeAddr, deviceInfo->address.addr.ieeeAddr + LENGTH_EXTADDR_IEEE);
 		}
 		else {
 			payload.resize(10);
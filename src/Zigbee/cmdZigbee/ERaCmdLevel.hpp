@@ -4,7 +4,8 @@
 #include <Zigbee/ERaCommandZigbee.hpp>
 
 template <class ToZigbee>
-ResultT ERaCommandZigbee<ToZigbee>::moveToLevelGenLevelCtrl(AFAddrType_t& dstAddr, uint8_t level, uint16_t transtime) {
+ResultT ERaCommandZigbee<ToZigbee>::moveToLevelGenLevelCtrl(AFAddrType_t& dstAddr, uint8_t level, uint16_t transtime,
+                                                    ERaZnpCallback_t callback, void* args) {
     vector<uint8_t> payload;
     payload.push_back(level);
     payload.push_back(LO_UINT16(transtime));
@@ -12,21 +13,31 @@ ResultT ERaCommandZigbee<ToZigbee>::moveToLevelGenLevelCtrl(AFAddrType_t& dstAdd
     if (dstAddr.addrMode == AddressModeT::ADDR_GROUP) {
         return ResultT::RESULT_FAIL;
     }
+    if (callback != nullptr) {
+        return this->thisToZigbee().sendCommandAsyncZigbee(this->zclHeader11, dstAddr, EndpointListT::ENDPOINT1,
+                                                        {ClusterIDT::ZCL_CLUSTER_LEVEL_CONTROL, ZbZclLevelSvrCmdT::ZCL_LEVEL_COMMAND_MOVELEVEL, &payload}, callback, args);
+    }
     return this->thisToZigbee().sendCommandIdZigbee(this->zclHeader11, dstAddr, EndpointListT::ENDPOINT1,
                                                     {ClusterIDT::ZCL_CLUSTER_LEVEL_CONTROL, ZbZclLevelSvrCmdT::ZCL_LEVEL_COMMAND_MOVELEVEL, &payload});
 }
 
 template <class ToZigbee>
-ResultT ERaCommandZigbee<ToZigbee>::stopGenLevelCtrl(AFAddrType_t& dstAddr) {
+ResultT ERaCommandZigbee<ToZigbee>::stopGenLevelCtrl(AFAddrType_t& dstAddr,
+                                                    ERaZnpCallback_t callback, void* args) {
     if (dstAddr.addrMode == AddressModeT::ADDR_GROUP) {
         return ResultT::RESULT_FAIL;
     }
+    if (callback != nullptr) {
+        return this->thisToZigbee().sendCommandAsyncZigbee(this->zclHeader11, dstAddr, EndpointListT::ENDPOINT1,
+                                                        {ClusterIDT::ZCL_CLUSTER_LEVEL_CONTROL, ZbZclLevelSvrCmdT::ZCL_LEVEL_COMMAND_STOP, nullptr}, callback, args);
+    }
     return this->thisToZigbee().sendCommandIdZigbee(this->zclHeader11, dstAddr, EndpointListT::ENDPOINT1,
                                                     {ClusterIDT::ZCL_CLUSTER_LEVEL_CONTROL, ZbZclLevelSvrCmdT::ZCL_LEVEL_COMMAND_STOP, nullptr});
 }
 
 template <class ToZigbee>
-ResultT ERaCommandZigbee<ToZigbee>::moveToLevelWithOnOffGenLevelCtrl(AFAddrType_t& dstAddr, uint8_t level, uint16_t transtime) {
+ResultT ERaCommandZigbee<ToZigbee>::moveToLevelWithOnOffGenLevelCtrl(AFAddrType_t& dstAddr, uint8_t level, uint16_t transtime,
+                                                    ERaZnpCallback_t callback, void* args) {
     vector<uint8_t> payload;
     payload.push_back(level);
     payload.push_back(LO_UINT16(transtime));
@@ -34,15 +45,24 @@ ResultT ERaCommandZigbee<ToZigbee>::moveToLevelWithOnOffGenLevelCtrl(AFAddrType_
     if (dstAddr.addrMode == AddressModeT::ADDR_GROUP) {
         return ResultT::RESULT_FAIL;
     }
+    if (callback != nullptr) {
+        return this->thisToZigbee().sendCommandAsyncZigbee(this->zclHeader11, dstAddr, EndpointListT::ENDPOINT1,
+                                                        {ClusterIDT::ZCL_CLUSTER_LEVEL_CONTROL, ZbZclLevelSvrCmdT::ZCL_LEVEL_COMMAND_MOVELEVEL_ONOFF, &payload}, callback, args);
+    }
     return this->thisToZigbee().sendCommandIdZigbee(this->zclHeader11, dstAddr, EndpointListT::ENDPOINT1,
                                                     {ClusterIDT::ZCL_CLUSTER_LEVEL_CONTROL, ZbZclLevelSvrCmdT::ZCL_LEVEL_COMMAND_MOVELEVEL_ONOFF, &payload});
 }
 
 template <class ToZigbee>
-ResultT ERaCommandZigbee<ToZigbee>::stopWithOnOffGenLevelCtrl(AFAddrType_t& dstAddr) {
+ResultT ERaCommandZigbee<ToZigbee>::stopWithOnOffGenLevelCtrl(AFAddrType_t& dstAddr,
+                                                    ERaZnpCallback_t callback, void* args) {
     if (dstAddr.addrMode == AddressModeT::ADDR_GROUP) {
         return ResultT::RESULT_FAIL;
     }
+    if (callback != nullptr) {
+        return this->thisToZigbee().sendCommandAsyncZigbee(this->zclHeader11, dstAddr, EndpointListT::ENDPOINT1,
+                                                        {ClusterIDT::ZCL_CLUSTER_LEVEL_CONTROL, ZbZclLevelSvrCmdT::ZCL_LEVEL_COMMAND_STOP_ONOFF, nullptr}, callback, args);
+    }
     return this->thisToZigbee().sendCommandIdZigbee(this->zclHeader11, dstAddr, EndpointListT::ENDPOINT1,
                                                     {ClusterIDT::ZCL_CLUSTER_LEVEL_CONTROL, ZbZclLevelSvrCmdT::ZCL_LEVEL_COMMAND_STOP_ONOFF, nullptr});
 }
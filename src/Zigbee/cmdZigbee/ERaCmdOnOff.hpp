@@ -4,16 +4,22 @@
 #include <Zigbee/ERaCommandZigbee.hpp>
 
 template <class ToZigbee>
-ResultT ERaCommandZigbee<ToZigbee>::onoffGenOnOff(AFAddrType_t& dstAddr, uint8_t state) {
+ResultT ERaCommandZigbee<ToZigbee>::onoffGenOnOff(AFAddrType_t& dstAddr, uint8_t state,
+                                                    ERaZnpCallback_t callback, void* args) {
     if (dstAddr.addrMode == AddressModeT::ADDR_GROUP) {
         return ResultT::RESULT_FAIL;
     }
+    if (callback != nullptr) {
+        return this->thisToZigbee().sendCommandAsyncZigbee(this->zclHeader11, dstAddr, EndpointListT::ENDPOINT1,
+                                                        {ClusterIDT::ZCL_CLUSTER_ONOFF, state, nullptr}, callback, args);
+    }
     return this->thisToZigbee().sendCommandIdZigbee(this->zclHeader11, dstAddr, EndpointListT::ENDPOINT1,
                                                     {ClusterIDT::ZCL_CLUSTER_ONOFF, state, nullptr});
 }
 
 template <class ToZigbee>
-ResultT ERaCommandZigbee<ToZigbee>::onWithTimeOffGenOnOff(AFAddrType_t& dstAddr, uint8_t ctrlBits, uint16_t onTime, uint16_t offWaitTime) {
+ResultT ERaCommandZigbee<ToZigbee>::onWithTimeOffGenOnOff(AFAddrType_t& dstAddr, uint8_t ctrlBits, uint16_t onTime, uint16_t offWaitTime,
+                                                    ERaZnpCallback_t callback, void* args) {
     vector<uint8_t> payload;
     payload.push_back(ctrlBits);
     payload.push_back(LO_UINT16(onTime));
@@ -23,6 +29,10 @@ ResultT ERaCommandZigbee<ToZigbee>::onWithTimeOffGenOnOff(AFAddrType_t& dstAddr,
     if (dstAddr.addrMode == AddressModeT::ADDR_GROUP) {
         return ResultT::RESULT_FAIL;
     }
+    if (callback != nullptr) {
+        return this->thisToZigbee().sendCommandAsyncZigbee(this->zclHeader11, dstAddr, EndpointListT::ENDPOINT1,
+                                                        {ClusterIDT::ZCL_CLUSTER_ONOFF, ZbZclOnOffSvrCmdT::ZCL_ONOFF_ON_WITH_TIMED_OFF, &payload}, callback, args);
+    }
     return this->thisToZigbee().sendCommandIdZigbee(this->zclHeader11, dstAddr, EndpointListT::ENDPOINT1,
                                                     {ClusterIDT::ZCL_CLUSTER_ONOFF, ZbZclOnOffSvrCmdT::ZCL_ONOFF_ON_WITH_TIMED_OFF, &payload});
 }
@@ -22,9 +22,10 @@
 #include "define/utilZigbee.hpp"
 #include "define/zbZigbee.hpp"
 #include "define/zdoZigbee.hpp"
+#include <Zigbee/utility/ERaDeviceRegistry.hpp>
 
 #if !defined(MAX_DEVICE_ZIGBEE)
-	#define MAX_DEVICE_ZIGBEE       	20
+	#define MAX_DEVICE_ZIGBEE       	256
 #endif
 
 #if !defined(DISABLE_SCALE_ZIGBEE_DATA)
@@ -61,13 +62,13 @@
 
 #define BUILD_UINT8(hiByte, loByte) \
 		((uint8_t)(((loByte) & 0x0F) + (((hiByte) & 0x0F) << 4)))
-#define BUILD_UINT16(fiByte) ((uint16_t)(*reinterpret_cast<uint16_t*>(&fiByte)))
-#define BUILD_UINT24(fiByte) (((uint32_t)(*reinterpret_cast<uint32_t*>(&fiByte))) & 0x00FFFFFF)
-#define BUILD_UINT32(fiByte) ((uint32_t)(*reinterpret_cast<uint32_t*>(&fiByte)))
-#define BUILD_UINT40(fiByte) (((uint64_t)(*reinterpret_cast<uint64_t*>(&fiByte))) & 0xFFFFFFFFFF)
-#define BUILD_UINT48(fiByte) (((uint64_t)(*reinterpret_cast<uint64_t*>(&fiByte))) & 0xFFFFFFFFFFFF)
-#define BUILD_UINT52(fiByte) (((uint64_t)(*reinterpret_cast<uint64_t*>(&fiByte))) & 0xFFFFFFFFFFFFFF)
-#define BUILD_UINT64(fiByte) ((uint64_t)(*reinterpret_cast<uint64_t*>(&fiByte)))
+#define BUILD_UINT16(fiByte) ((uint16_t)(*reinterpret_cast<const uint16_t*>(&fiByte)))
+#define BUILD_UINT24(fiByte) (((uint32_t)(*reinterpret_cast<const uint32_t*>(&fiByte))) & 0x00FFFFFF)
+#define BUILD_UINT32(fiByte) ((uint32_t)(*reinterpret_cast<const uint32_t*>(&fiByte)))
+#define BUILD_UINT40(fiByte) (((uint64_t)(*reinterpret_cast<const uint64_t*>(&fiByte))) & 0xFFFFFFFFFF)
+#define BUILD_UINT48(fiByte) (((uint64_t)(*reinterpret_cast<const uint64_t*>(&fiByte))) & 0xFFFFFFFFFFFF)
+#define BUILD_UINT52(fiByte) (((uint64_t)(*reinterpret_cast<const uint64_t*>(&fiByte))) & 0xFFFFFFFFFFFFFF)
+#define BUILD_UINT64(fiByte) ((uint64_t)(*reinterpret_cast<const uint64_t*>(&fiByte)))
 #define BUILD_FLOAT(value)   ((float)(*reinterpret_cast<float*>(&value)))
 #define BUILD_DOUBLE(value)  ((double)(*reinterpret_cast<double*>(&value)))
 
@@ -260,6 +261,9 @@ typedef struct __AFAddrType_t {
 typedef struct __ZigbeeData_t {
 	char* topic;
 	cJSON* payload;
+	cJSON* published; /* Data as last published, delta mode */
+	MillisTime_t reportMillis;
+	bool pending;
 } ZigbeeData_t;
 
 typedef struct __ZigbeeAction_t {
@@ -449,26 +453,39 @@ typedef struct __InfoCoordinator_t {
         return __InfoCoordinator_t::instance();
 	}
 	void reset(__InfoCoordinator_t*& _instance = __InfoCoordinator_t::instance()) {
-		_instance->freeAllDevice();
+		_instance->clearAllDevice();
 		memset((void*)_instance, 0, sizeof(__InfoCoordinator_t));
 		new(_instance) __InfoCoordinator_t();
 	}
 	void freeAllDevice() {
-		for (size_t i = 0; i < this->deviceCount; ++i) {
-			if (this->deviceIdent[i].data.topic != nullptr) {
-				free(this->deviceIdent[i].data.topic);
-				this->deviceIdent[i].data.topic = nullptr;
-			}
-			if (this->deviceIdent[i].data.payload != nullptr) {
-				cJSON_Delete(this->deviceIdent[i].data.payload);
-				this->deviceIdent[i].data.payload = nullptr;
-			}
+		for (size_t i = 0; i < this->devices.size(); ++i) {
+			this->freeDevice(this->devices[i]);
 		}
 	}
+	void freeDevice(__IdentDeviceAddr_t* deviceInfo) {
+		if (deviceInfo == nullptr) {
+			return;
+		}
+		if (deviceInfo->data.topic != nullptr) {
+			free(deviceInfo->data.topic);
+			deviceInfo->data.topic = nullptr;
+		}
+		if (deviceInfo->data.payload != nullptr) {
+			cJSON_Delete(deviceInfo->data.payload);
+			deviceInfo->data.payload = nullptr;
+		}
+		if (deviceInfo->data.published != nullptr) {
+			cJSON_Delete(deviceInfo->data.published);
+			deviceInfo->data.published = nullptr;
+		}
+	}
+	void removeDevice(__IdentDeviceAddr_t* deviceInfo) {
+		this->freeDevice(deviceInfo);
+		this->devices.remove(deviceInfo);
+	}
     void clearAllDevice() {
 		this->freeAllDevice();
-		this->deviceCount = 0;
-		memset(this->deviceIdent, 0, sizeof(this->deviceIdent));
+		this->devices.clear();
 	}
 
 	bool lock;
@@ -491,8 +508,7 @@ typedef struct __InfoCoordinator_t {
 	uint8_t epTick;
 	InfoEndpoint_t epList[20];
 	uint16_t extGroup;
-	uint8_t deviceCount;
-	IdentDeviceAddr_t deviceIdent[MAX_DEVICE_ZIGBEE];
+	ERaDeviceRegistry<IdentDeviceAddr_t, MAX_DEVICE_ZIGBEE> devices;
 	NwkKeyDesc_t activeKeyDesc;
 	NwkKeyDesc_t alternKeyDesc;
 	uint8_t apsExtPanId[LENGTH_EXTADDR_IEEE];
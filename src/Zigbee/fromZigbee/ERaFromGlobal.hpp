@@ -157,7 +157,7 @@ void ERaFromZigbee<Zigbee>::processDefaultResponse(const DataAFMsg_t& afMsg, Def
 }
 
 template <class Zigbee>
-bool ERaFromZigbee<Zigbee>::getDataAttributes(const DataAFMsg_t& afMsg, DefaultRsp_t& defaultRsp, uint16_t nwkAddr, EndpointListT endpoint, vector<DataAttr_t> listAttr) {
+bool ERaFromZigbee<Zigbee>::getDataAttributes(const DataAFMsg_t& afMsg, DefaultRsp_t& defaultRsp, uint16_t nwkAddr, EndpointListT endpoint, const vector<DataAttr_t>& listAttr) {
     if (afMsg.srcAddr.addrMode != AddressModeT::ADDR_16BIT) {
         return false;
     }
@@ -329,7 +329,7 @@ bool ERaFromZigbee<Zigbee>::getDataAttributes(const DataAFMsg_t& afMsg, DefaultR
             case ClusterIDT::ZCL_CLUSTER_BASIC:
                 break;
             default:
-                this->thisZigbee().publishZigbeeData(deviceInfo);
+                this->thisZigbee().reportZigbeeData(deviceInfo);
                 break;
         }
     }
@@ -337,7 +337,7 @@ bool ERaFromZigbee<Zigbee>::getDataAttributes(const DataAFMsg_t& afMsg, DefaultR
 }
 
 template <class Zigbee>
-bool ERaFromZigbee<Zigbee>::getDataAttributesRsp(const DataAFMsg_t& afMsg, DefaultRsp_t& defaultRsp, vector<DataReadAttrRsp_t> listData) {
+bool ERaFromZigbee<Zigbee>::getDataAttributesRsp(const DataAFMsg_t& afMsg, DefaultRsp_t& defaultRsp, const vector<DataReadAttrRsp_t>& listData) {
     if (!afMsg.pDataLen || afMsg.pData == nullptr) {
         return false;
     }
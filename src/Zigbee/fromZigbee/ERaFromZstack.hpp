@@ -4,7 +4,7 @@
 #include <Zigbee/ERaFromZigbee.hpp>
 
 template <class Zigbee>
-void ERaFromZigbee<Zigbee>::processNodeDescriptor(vector<uint8_t>& data, void* value) {
+void ERaFromZigbee<Zigbee>::processNodeDescriptor(ERaZnpView& data, void* value) {
 	if (data.size() < 3) {
 		return;
     }
@@ -29,7 +29,7 @@ void ERaFromZigbee<Zigbee>::processNodeDescriptor(vector<uint8_t>& data, void* v
 }
 
 template <class Zigbee>
-void ERaFromZigbee<Zigbee>::processSimpleDescriptor(vector<uint8_t>& data, void* value) {
+void ERaFromZigbee<Zigbee>::processSimpleDescriptor(ERaZnpView& data, void* value) {
 	if (data.size() < 3) {
 		return;
     }
@@ -106,7 +106,7 @@ void ERaFromZigbee<Zigbee>::processSimpleDescriptor(vector<uint8_t>& data, void*
 }
 
 template <class Zigbee>
-void ERaFromZigbee<Zigbee>::processActiveEndpoint(vector<uint8_t>& data, void* value) {
+void ERaFromZigbee<Zigbee>::processActiveEndpoint(ERaZnpView& data, void* value) {
 	if (data.size() < 3) {
 		return;
     }
@@ -148,7 +148,7 @@ void ERaFromZigbee<Zigbee>::processActiveEndpoint(vector<uint8_t>& data, void* v
 }
 
 template <class Zigbee>
-void ERaFromZigbee<Zigbee>::processBindUnbind(vector<uint8_t>& data, void* value) {
+void ERaFromZigbee<Zigbee>::processBindUnbind(ERaZnpView& data, void* value) {
 	if (data.size() < 3) {
 		return;
     }
@@ -167,7 +167,7 @@ void ERaFromZigbee<Zigbee>::processBindUnbind(vector<uint8_t>& data, void* value
 }
 
 template <class Zigbee>
-void ERaFromZigbee<Zigbee>::processTCDeviceIndication(vector<uint8_t>& data, void* value) {
+void ERaFromZigbee<Zigbee>::processTCDeviceIndication(ERaZnpView& data, void* value) {
 	if (data.size() < 12) {
         return;
     }
@@ -209,7 +209,7 @@ void ERaFromZigbee<Zigbee>::processTCDeviceIndication(vector<uint8_t>& data, voi
 }
 
 template <class Zigbee>
-void ERaFromZigbee<Zigbee>::processZDOState(vector<uint8_t>& data, void* value) {
+void ERaFromZigbee<Zigbee>::processZDOState(ERaZnpView& data, void* value) {
     if (!data.size()) {
         return;
     }
@@ -217,7 +217,7 @@ void ERaFromZigbee<Zigbee>::processZDOState(vector<uint8_t>& data, void* value)
 }
 
 template <class Zigbee>
-void ERaFromZigbee<Zigbee>::processDeviceAnnounce(vector<uint8_t>& data, void* value) {
+void ERaFromZigbee<Zigbee>::processDeviceAnnounce(ERaZnpView& data, void* value) {
 	if (data.size() < 13) {
 		return;
     }
@@ -244,7 +244,7 @@ void ERaFromZigbee<Zigbee>::processDeviceAnnounce(vector<uint8_t>& data, void* v
 }
 
 template <class Zigbee>
-void ERaFromZigbee<Zigbee>::processDeviceLeave(vector<uint8_t>& data, void* value) {
+void ERaFromZigbee<Zigbee>::processDeviceLeave(ERaZnpView& data, void* value) {
 	if (data.size() < 13) {
 		return;
     }
@@ -262,7 +262,7 @@ void ERaFromZigbee<Zigbee>::processDeviceLeave(vector<uint8_t>& data, void* valu
 }
 
 template <class Zigbee>
-void ERaFromZigbee<Zigbee>::processReadOsalNVItems(vector<uint8_t>& data, void* value) {
+void ERaFromZigbee<Zigbee>::processReadOsalNVItems(ERaZnpView& data, void* value) {
     if (!data.size()) {
         return;
     }
@@ -372,7 +372,7 @@ void ERaFromZigbee<Zigbee>::processReadOsalNVItems(vector<uint8_t>& data, void*
 }
 
 template <class Zigbee>
-void ERaFromZigbee<Zigbee>::processWriteOsalNVItems(vector<uint8_t>& data, void* value) {
+void ERaFromZigbee<Zigbee>::processWriteOsalNVItems(ERaZnpView& data, void* value) {
     if (!data.size()) {
         return;
     }
@@ -382,7 +382,7 @@ void ERaFromZigbee<Zigbee>::processWriteOsalNVItems(vector<uint8_t>& data, void*
 }
 
 template <class Zigbee>
-void ERaFromZigbee<Zigbee>::processLengthOsalNVItems(vector<uint8_t>& data, void* value) {
+void ERaFromZigbee<Zigbee>::processLengthOsalNVItems(ERaZnpView& data, void* value) {
     if (data.size() < 2) {
         return;
     }
@@ -392,7 +392,7 @@ void ERaFromZigbee<Zigbee>::processLengthOsalNVItems(vector<uint8_t>& data, void
 }
 
 template <class Zigbee>
-void ERaFromZigbee<Zigbee>::processCoordVersion(vector<uint8_t>& data, void* value) {
+void ERaFromZigbee<Zigbee>::processCoordVersion(ERaZnpView& data, void* value) {
     if (data.size() < 5) {
         return;
     }
@@ -411,7 +411,7 @@ void ERaFromZigbee<Zigbee>::processCoordVersion(vector<uint8_t>& data, void* val
 }
 
 template <class Zigbee>
-void ERaFromZigbee<Zigbee>::processReadConfig(vector<uint8_t>& data, void* value) {
+void ERaFromZigbee<Zigbee>::processReadConfig(ERaZnpView& data, void* value) {
 	if (!data.size()) {
 		return;
     }
@@ -435,7 +435,7 @@ void ERaFromZigbee<Zigbee>::processReadConfig(vector<uint8_t>& data, void* value
 }
 
 template <class Zigbee>
-void ERaFromZigbee<Zigbee>::processDeviceInfo(vector<uint8_t>& data, void* value) {
+void ERaFromZigbee<Zigbee>::processDeviceInfo(ERaZnpView& data, void* value) {
 	if (!data.size()) {
 		return;
     }
@@ -451,10 +451,8 @@ void ERaFromZigbee<Zigbee>::processDeviceInfo(vector<uint8_t>& data, void* value
             this->coordinator->address.endpoint = EndpointListT::ENDPOINT1;
             this->coordinator->deviceType = data.at(11);
             this->coordinator->states = static_cast<DevStatesT>(data.at(12));
-            this->coordinator->deviceCount = data.at(13);
-            for (int i = 0; i < this->coordinator->deviceCount; ++i) {
-                this->coordinator->deviceIdent[i].address.addr.nwkAddr = BUILD_UINT16(data.at(14 + 2*i));
-            }
+            /* Associated devices from 13 carry no IEEE address,
+               the registry is loaded from flash instead */
             break;
         default:
             break;
@@ -19,35 +19,35 @@ bool ERaToZigbee<Zigbee>::levelToZigbee(const cJSON* const root, const cJSON* co
                 }
                 if (cJSON_IsNumber(current)) {
                     if (onOff) {
-                        CommandZigbee::moveToLevelWithOnOffGenLevelCtrl(dstAddr, current->valueint, transition);
+                        CommandZigbee::moveToLevelWithOnOffGenLevelCtrl(dstAddr, current->valueint, transition, this->resultCallback, this->resultArgs(dstAddr));
                     }
                     else {
-                        CommandZigbee::moveToLevelGenLevelCtrl(dstAddr, current->valueint, transition);
+                        CommandZigbee::moveToLevelGenLevelCtrl(dstAddr, current->valueint, transition, this->resultCallback, this->resultArgs(dstAddr));
                     }
                 }
                 else if (cJSON_IsString(current)) {
                     if (ERaStrCmp(current->valuestring, "stop")) {
                         if (onOff) {
-                            CommandZigbee::stopWithOnOffGenLevelCtrl(dstAddr);
+                            CommandZigbee::stopWithOnOffGenLevelCtrl(dstAddr, this->resultCallback, this->resultArgs(dstAddr));
                         }
                         else {
-                            CommandZigbee::stopGenLevelCtrl(dstAddr);
+                            CommandZigbee::stopGenLevelCtrl(dstAddr, this->resultCallback, this->resultArgs(dstAddr));
                         }
                     }
                     else if (ERaStrCmp(current->valuestring, "open")) {
                         if (onOff) {
-                            CommandZigbee::moveToLevelWithOnOffGenLevelCtrl(dstAddr, 0x64, transition);
+                            CommandZigbee::moveToLevelWithOnOffGenLevelCtrl(dstAddr, 0x64, transition, this->resultCallback, this->resultArgs(dstAddr));
                         }
                         else {
-                            CommandZigbee::moveToLevelGenLevelCtrl(dstAddr, 0x64, transition);
+                            CommandZigbee::moveToLevelGenLevelCtrl(dstAddr, 0x64, transition, this->resultCallback, this->resultArgs(dstAddr));
                         }
                     }
                     else if (ERaStrCmp(current->valuestring, "close")) {
                         if (onOff) {
-                            CommandZigbee::moveToLevelWithOnOffGenLevelCtrl(dstAddr, 0x00, transition);
+                            CommandZigbee::moveToLevelWithOnOffGenLevelCtrl(dstAddr, 0x00, transition, this->resultCallback, this->resultArgs(dstAddr));
                         }
                         else {
-                            CommandZigbee::moveToLevelGenLevelCtrl(dstAddr, 0x00, transition);
+                            CommandZigbee::moveToLevelGenLevelCtrl(dstAddr, 0x00, transition, this->resultCallback, this->resultArgs(dstAddr));
                         }
                     }
                 }
@@ -37,26 +37,26 @@ bool ERaToZigbee<Zigbee>::stateToZigbee(const cJSON* const root, const cJSON* co
 				}
                 if (cJSON_IsNumber(current)) {
                     if (current->valueint == ZbZclOnOffSvrCmdT::ZCL_ONOFF_COMMAND_ON && isOnWithTimedOff) {
-                        CommandZigbee::onWithTimeOffGenOnOff(dstAddr, controlBits, onTime, offWaitTime);
+                        CommandZigbee::onWithTimeOffGenOnOff(dstAddr, controlBits, onTime, offWaitTime, this->resultCallback, this->resultArgs(dstAddr));
                     }
                     else {
-                        CommandZigbee::onoffGenOnOff(dstAddr, current->valueint);
+                        CommandZigbee::onoffGenOnOff(dstAddr, current->valueint, this->resultCallback, this->resultArgs(dstAddr));
                     }
                 }
                 else if (cJSON_IsString(current)) {
                     if (ERaStrCmp(current->valuestring, "on")) {
                         if (isOnWithTimedOff) {
-                            CommandZigbee::onWithTimeOffGenOnOff(dstAddr, controlBits, onTime, offWaitTime);
+                            CommandZigbee::onWithTimeOffGenOnOff(dstAddr, controlBits, onTime, offWaitTime, this->resultCallback, this->resultArgs(dstAddr));
                         }
                         else {
-                            CommandZigbee::onoffGenOnOff(dstAddr, ZbZclOnOffSvrCmdT::ZCL_ONOFF_COMMAND_ON);
+                            CommandZigbee::onoffGenOnOff(dstAddr, ZbZclOnOffSvrCmdT::ZCL_ONOFF_COMMAND_ON, this->resultCallback, this->resultArgs(dstAddr));
                         }
                     }
                     else if (ERaStrCmp(current->valuestring, "off")) {
-                        CommandZigbee::onoffGenOnOff(dstAddr, ZbZclOnOffSvrCmdT::ZCL_ONOFF_COMMAND_OFF);
+                        CommandZigbee::onoffGenOnOff(dstAddr, ZbZclOnOffSvrCmdT::ZCL_ONOFF_COMMAND_OFF, this->resultCallback, this->resultArgs(dstAddr));
                     }
                     else if (ERaStrCmp(current->valuestring, "toggle")) {
-                        CommandZigbee::onoffGenOnOff(dstAddr, ZbZclOnOffSvrCmdT::ZCL_ONOFF_COMMAND_TOGGLE);
+                        CommandZigbee::onoffGenOnOff(dstAddr, ZbZclOnOffSvrCmdT::ZCL_ONOFF_COMMAND_TOGGLE, this->resultCallback, this->resultArgs(dstAddr));
                     }
                     else {
                         subItem = cJSON_GetObjectItem(root, "transition");
@@ -64,13 +64,13 @@ bool ERaToZigbee<Zigbee>::stateToZigbee(const cJSON* const root, const cJSON* co
                             transition = subItem->valueint * 10;
                         }
                         if (ERaStrCmp(current->valuestring, "stop")) {
-                            CommandZigbee::stopWithOnOffGenLevelCtrl(dstAddr);
+                            CommandZigbee::stopWithOnOffGenLevelCtrl(dstAddr, this->resultCallback, this->resultArgs(dstAddr));
                         }
                         else if (ERaStrCmp(current->valuestring, "open")) {
-                            CommandZigbee::moveToLevelWithOnOffGenLevelCtrl(dstAddr, 0x64, transition);
+                            CommandZigbee::moveToLevelWithOnOffGenLevelCtrl(dstAddr, 0x64, transition, this->resultCallback, this->resultArgs(dstAddr));
                         }
                         else if (ERaStrCmp(current->valuestring, "close")) {
-                            CommandZigbee::moveToLevelWithOnOffGenLevelCtrl(dstAddr, 0x00, transition);
+                            CommandZigbee::moveToLevelWithOnOffGenLevelCtrl(dstAddr, 0x00, transition, this->resultCallback, this->resultArgs(dstAddr));
                         }
                     }
                 }
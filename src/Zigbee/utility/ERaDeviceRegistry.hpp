@@ -0,0 +1,279 @@
+#ifndef INC_ERA_DEVICE_REGISTRY_HPP_
+#define INC_ERA_DEVICE_REGISTRY_HPP_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <ERa/ERaDefine.hpp>
+#include <Utility/ERaUtility.hpp>
+
+/* Devices known to the coordinator, entries allocated on demand.
+   The list and both indexes are sized for Limit on first use and
+   never reallocated. A removed entry is kept for the next add(),
+   so a pointer held by another task reads stale data at worst,
+   memory is only freed by clear(). Both the IEEE and the network
+   address are hashed (linear probing), zero addresses are not
+   indexed. Change the network address through setNwkAddr()
+   to keep the index right. Calls are locked, tasks share it.
+   All zero is a valid empty registry */
+template <class Device, size_t Limit>
+class ERaDeviceRegistry
+{
+public:
+    ERaDeviceRegistry()
+        : list(nullptr)
+        , count(0)
+        , byIeee(nullptr)
+        , byNwk(nullptr)
+        , buckets(0)
+        , mutex(NULL)
+    {}
+    ~ERaDeviceRegistry()
+    {}
+
+    size_t size() const {
+        return this->count;
+    }
+
+    bool full() const {
+        return (this->count >= Limit);
+    }
+
+    Device* at(size_t index) {
+        Device* entry {nullptr};
+        ERaGuardLock(this->mutex);
+        if (index < this->count) {
+            entry = this->list[index];
+        }
+        ERaGuardUnlock(this->mutex);
+        return entry;
+    }
+
+    Device* operator [] (size_t index) {
+        return this->at(index);
+    }
+
+    Device* find(const uint8_t* ieeeAddr) {
+        if (ERaDeviceRegistry::isZero(ieeeAddr)) {
+            return nullptr;
+        }
+        Device* entry {nullptr};
+        ERaGuardLock(this->mutex);
+        if (this->buckets) {
+            size_t mask = (this->buckets - 1);
+            for (size_t i = (ERaDeviceRegistry::hash(ieeeAddr) & mask); this->byIeee[i] != nullptr; i = ((i + 1) & mask)) {
+                if (!memcmp(this->byIeee[i]->address.addr.ieeeAddr, ieeeAddr, LengthIeee)) {
+                    entry = this->byIeee[i];
+                    break;
+                }
+            }
+        }
+        ERaGuardUnlock(this->mutex);
+        return entry;
+    }
+
+    Device* find(uint16_t nwkAddr) {
+        if (!nwkAddr) {
+            return nullptr;
+        }
+        Device* entry {nullptr};
+        ERaGuardLock(this->mutex);
+        if (this->buckets) {
+            size_t mask = (this->buckets - 1);
+            for (size_t i = (ERaDeviceRegistry::hash(nwkAddr) & mask); this->byNwk[i] != nullptr; i = ((i + 1) & mask)) {
+                if (this->byNwk[i]->address.addr.nwkAddr == nwkAddr) {
+                    entry = this->byNwk[i];
+                    break;
+                }
+            }
+        }
+        ERaGuardUnlock(this->mutex);
+        return entry;
+    }
+
+    /* Copy of device, nullptr when full */
+    Device* add(const Device& device) {
+        Device* entry {nullptr};
+        ERaGuardLock(this->mutex);
+        if (!this->full() && this->allocate()) {
+            /* Past count are the entries of removed devices */
+            entry = this->list[this->count];
+            if (entry == nullptr) {
+                entry = reinterpret_cast<Device*>(ERA_CALLOC(1, sizeof(Device)));
+            }
+        }
+        if (entry != nullptr) {
+            memcpy((void*)entry, (const void*)&device, sizeof(Device));
+            this->list[this->count++] = entry;
+            this->insert(this->byIeee, entry, true);
+            this->insert(this->byNwk, entry, false);
+        }
+        ERaGuardUnlock(this->mutex);
+        return entry;
+    }
+
+    void setNwkAddr(Device* device, uint16_t nwkAddr) {
+        if (device == nullptr) {
+            return;
+        }
+        ERaGuardLock(this->mutex);
+        if (device->address.addr.nwkAddr != nwkAddr) {
+            this->erase(this->byNwk, device, false);
+            device->address.addr.nwkAddr = nwkAddr;
+            this->insert(this->byNwk, device, false);
+        }
+        ERaGuardUnlock(this->mutex);
+    }
+
+    /* Keeps the entry for reuse, order of the others is kept */
+    void remove(Device* device) {
+        if (device == nullptr) {
+            return;
+        }
+        ERaGuardLock(this->mutex);
+        for (size_t i = 0; i < this->count; ++i) {
+            if (this->list[i] != device) {
+                continue;
+            }
+            this->erase(this->byIeee, device, true);
+            this->erase(this->byNwk, device, false);
+            memmove(this->list + i, this->list + i + 1, (this->count - i - 1) * sizeof(Device*));
+            this->list[--this->count] = device;
+            break;
+        }
+        ERaGuardUnlock(this->mutex);
+    }
+
+    /* Frees everything, no entry may still be in use */
+    void clear() {
+        ERaGuardLock(this->mutex);
+        for (size_t i = 0; (this->list != nullptr) && (i < Limit); ++i) {
+            ERA_FREE(this->list[i]);
+        }
+        ERA_FREE(this->list);
+        ERA_FREE(this->byIeee);
+        ERA_FREE(this->byNwk);
+        this->list = nullptr;
+        this->byIeee = nullptr;
+        this->byNwk = nullptr;
+        this->count = 0;
+        this->buckets = 0;
+        ERaGuardUnlock(this->mutex);
+    }
+
+protected:
+private:
+    static const size_t LengthIeee = sizeof(((Device*)nullptr)->address.addr.ieeeAddr);
+
+    ERaDeviceRegistry(const ERaDeviceRegistry&);
+    ERaDeviceRegistry& operator = (const ERaDeviceRegistry&);
+
+    /* Once, a table that moves could be read by another task */
+    bool allocate() {
+        if (this->buckets) {
+            return true;
+        }
+        /* Indexes at most half full, a probe always ends */
+        size_t size {1};
+        while (size < (Limit * 2)) {
+            size <<= 1;
+        }
+        Device** newList = reinterpret_cast<Device**>(ERA_CALLOC(Limit, sizeof(Device*)));
+        Device** newIeee = reinterpret_cast<Device**>(ERA_CALLOC(size, sizeof(Device*)));
+        Device** newNwk = reinterpret_cast<Device**>(ERA_CALLOC(size, sizeof(Device*)));
+        if ((newList == nullptr) || (newIeee == nullptr) || (newNwk == nullptr)) {
+            ERA_FREE(newList);
+            ERA_FREE(newIeee);
+            ERA_FREE(newNwk);
+            return false;
+        }
+        this->list = newList;
+        this->byIeee = newIeee;
+        this->byNwk = newNwk;
+        this->buckets = size;
+        return true;
+    }
+
+    size_t slot(const Device* device, bool ieee) const {
+        return (ieee ? ERaDeviceRegistry::hash(device->address.addr.ieeeAddr)
+                     : ERaDeviceRegistry::hash(device->address.addr.nwkAddr));
+    }
+
+    bool indexed(const Device* device, bool ieee) const {
+        return (ieee ? !ERaDeviceRegistry::isZero(device->address.addr.ieeeAddr)
+                     : !!device->address.addr.nwkAddr);
+    }
+
+    void insert(Device** table, Device* device, bool ieee) {
+        if (!this->buckets || !this->indexed(device, ieee)) {
+            return;
+        }
+        size_t mask = (this->buckets - 1);
+        size_t i = (this->slot(device, ieee) & mask);
+        while (table[i] != nullptr) {
+            i = ((i + 1) & mask);
+        }
+        table[i] = device;
+    }
+
+    /* Backward shift, no tombstones */
+    void erase(Device** table, const Device* device, bool ieee) {
+        if (!this->buckets) {
+            return;
+        }
+        size_t mask = (this->buckets - 1);
+        size_t i {0};
+        for (i = 0; i < this->buckets; ++i) {
+            if (table[i] == device) {
+                break;
+            }
+        }
+        if (i == this->buckets) {
+            return;
+        }
+        size_t j = i;
+        for (;;) {
+            j = ((j + 1) & mask);
+            if (table[j] == nullptr) {
+                break;
+            }
+            size_t k = (this->slot(table[j], ieee) & mask);
+            if ((j > i) ? ((k <= i) || (k > j)) : ((k <= i) && (k > j))) {
+                table[i] = table[j];
+                i = j;
+            }
+        }
+        table[i] = nullptr;
+    }
+
+    static bool isZero(const uint8_t* ieeeAddr) {
+        for (size_t i = 0; i < LengthIeee; ++i) {
+            if (ieeeAddr[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static size_t hash(const uint8_t* ieeeAddr) {
+        uint32_t value {2166136261UL};
+        for (size_t i = 0; i < LengthIeee; ++i) {
+            value = ((value ^ ieeeAddr[i]) * 16777619UL);
+        }
+        return value;
+    }
+
+    static size_t hash(uint16_t nwkAddr) {
+        uint32_t value = ((uint32_t)nwkAddr * 2654435761UL);
+        return (value ^ (value >> 16));
+    }
+
+    Device** list;
+    size_t count;
+    Device** byIeee;
+    Device** byNwk;
+    size_t buckets;
+    ERaMutex_t mutex;
+};
+
+#endif /* INC_ERA_DEVICE_REGISTRY_HPP_ */
@@ -0,0 +1,189 @@
+#ifndef INC_ERA_ZNP_FRAME_HPP_
+#define INC_ERA_ZNP_FRAME_HPP_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <Zigbee/ERaZigbeeConfig.hpp>
+
+/* Bytes of a frame, or of its data field, read in place.
+   at() and [] are bounds checked, out of range reads see
+   zeros instead of throwing. Read only, the zeros are shared */
+class ERaZnpView
+{
+public:
+    ERaZnpView()
+        : ptr(nullptr)
+        , length(0)
+    {}
+    ERaZnpView(uint8_t* _ptr, size_t _length)
+        : ptr(_ptr)
+        , length(_length)
+    {}
+    ~ERaZnpView()
+    {}
+
+    const uint8_t& at(size_t index) const {
+        if ((this->ptr == nullptr) ||
+            (index >= this->length)) {
+            return ERaZnpView::none()[0];
+        }
+        return this->ptr[index];
+    }
+
+    const uint8_t& operator [] (size_t index) const {
+        return this->at(index);
+    }
+
+    uint8_t* data() const {
+        return this->ptr;
+    }
+
+    size_t size() const {
+        return this->length;
+    }
+
+    bool empty() const {
+        return !this->length;
+    }
+
+    uint8_t* begin() const {
+        return this->ptr;
+    }
+
+    uint8_t* end() const {
+        return (this->ptr + this->length);
+    }
+
+protected:
+private:
+    /* Wide enough for the multi byte reads done through at() */
+    static const uint8_t* none() {
+        static const uint8_t zero[256] {0};
+        return zero;
+    }
+
+    uint8_t* ptr;
+    size_t length;
+};
+
+/* ZNP frames out of a receive buffer filled in bulk:
+   SOF | LEN | CMD0 | CMD1 | DATA[LEN] | FCS.
+   Frames are checked and handed out in place. Unread bytes are
+   moved down to make room, but never over a frame that is
+   still held, so a view stays valid until release() even when
+   its handler reads more frames meanwhile */
+class ERaZnpDecoder
+{
+    static const uint8_t SOF = 0xFE;
+    static const uint8_t MinMessageLength = 5;
+    static const uint8_t MaxDataSize = 250;
+    static const size_t MaxHolds = 4;
+
+public:
+    ERaZnpDecoder()
+        : buffer()
+        , head(0)
+        , tail(0)
+        , holds()
+        , numHolds(0)
+    {}
+    ~ERaZnpDecoder()
+    {}
+
+    /* Free space to receive into, commit() what was written */
+    uint8_t* reserve(size_t& room) {
+        this->compact();
+        room = (sizeof(this->buffer) - this->tail);
+        return (this->buffer + this->tail);
+    }
+
+    void commit(size_t count) {
+        if (count > (sizeof(this->buffer) - this->tail)) {
+            count = (sizeof(this->buffer) - this->tail);
+        }
+        this->tail += count;
+    }
+
+    /* Next frame with a valid FCS, bytes that cannot
+       start one are skipped. False until one is complete */
+    bool next(ERaZnpView& frame) {
+        if (this->numHolds >= MaxHolds) {
+            return false;
+        }
+        while (this->head < this->tail) {
+            const uint8_t* pFrame = (this->buffer + this->head);
+            size_t remain = (this->tail - this->head);
+            if (pFrame[0] != SOF) {
+                this->head++;
+                continue;
+            }
+            if (remain < 2) {
+                return false;
+            }
+            if (pFrame[1] > MaxDataSize) {
+                this->head++;
+                continue;
+            }
+            size_t size = (pFrame[1] + MinMessageLength);
+            if (remain < size) {
+                return false;
+            }
+            uint8_t fcs {0};
+            for (size_t i = 1; i < (size - 1); ++i) {
+                fcs ^= pFrame[i];
+            }
+            if (fcs != pFrame[size - 1]) {
+                this->head++;
+                continue;
+            }
+            frame = ERaZnpView(this->buffer + this->head, size);
+            this->head += size;
+            this->holds[this->numHolds++] = this->head;
+            return true;
+        }
+        return false;
+    }
+
+    void release(const ERaZnpView& frame) {
+        if ((frame.data() < this->buffer) ||
+            (frame.data() >= (this->buffer + sizeof(this->buffer)))) {
+            return;
+        }
+        size_t end = ((size_t)(frame.data() - this->buffer) + frame.size());
+        for (size_t i = 0; i < this->numHolds; ++i) {
+            if (this->holds[i] != end) {
+                continue;
+            }
+            this->holds[i] = this->holds[--this->numHolds];
+            break;
+        }
+    }
+
+protected:
+private:
+    void compact() {
+        size_t floor {0};
+        for (size_t i = 0; i < this->numHolds; ++i) {
+            if (this->holds[i] > floor) {
+                floor = this->holds[i];
+            }
+        }
+        if (this->head <= floor) {
+            return;
+        }
+        if (this->tail > this->head) {
+            memmove(this->buffer + floor, this->buffer + this->head, this->tail - this->head);
+        }
+        this->tail -= (this->head - floor);
+        this->head = floor;
+    }
+
+    uint8_t buffer[ERA_ZIGBEE_RX_BUFFER_SIZE];
+    size_t head;
+    size_t tail;
+    size_t holds[MaxHolds];
+    size_t numHolds;
+};
+
+#endif /* INC_ERA_ZNP_FRAME_HPP_ */
@@ -0,0 +1,145 @@
+#ifndef INC_ERA_ZNP_PENDING_HPP_
+#define INC_ERA_ZNP_PENDING_HPP_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <Utility/ERaUtility.hpp>
+#include <Zigbee/ERaZigbeeConfig.hpp>
+#include <Zigbee/definition/ERaDefineZigbee.hpp>
+
+#if defined(__has_include) &&       \
+    __has_include(<functional>) &&  \
+    !defined(ERA_IGNORE_STD_FUNCTIONAL_STRING)
+    #include <functional>
+    #define ZNP_PENDING_HAS_FUNCTIONAL_H
+#endif
+
+#if defined(ZNP_PENDING_HAS_FUNCTIONAL_H)
+    typedef std::function<void(ResultT, void*)> ERaZnpCallback_t;
+#else
+    typedef void (*ERaZnpCallback_t)(ResultT, void*);
+#endif
+
+/* AF requests sent without waiting for their answer.
+   A request is matched by its AF transId, or by network
+   address and ZCL transId when an AF_INCOMING_MSG is awaited.
+   Its slot is freed on the answer, on a failed AF_DATA_CONFIRM
+   or on timeout. Not locked, the owner serializes access */
+template <size_t Window>
+class ERaZnpPending
+{
+public:
+    typedef struct __Pending_t {
+        Response_t wait {};
+        uint8_t cmdStatus {0};
+        MillisTime_t startMillis {0};
+        ERaZnpCallback_t callback {nullptr};
+        void* args {nullptr};
+        bool used {false};
+    } Pending_t;
+
+    ERaZnpPending()
+        : slots()
+        , numPending(0)
+    {}
+    ~ERaZnpPending()
+    {}
+
+    size_t size() const {
+        return this->numPending;
+    }
+
+    bool full() const {
+        return (this->numPending >= Window);
+    }
+
+    bool add(const Response_t& wait, ERaZnpCallback_t callback, void* args) {
+        for (size_t i = 0; i < Window; ++i) {
+            Pending_t& pend = this->slots[i];
+            if (pend.used) {
+                continue;
+            }
+            pend.wait = wait;
+            if (!pend.wait.timeout || (pend.wait.timeout > MAX_TIMEOUT)) {
+                pend.wait.timeout = MAX_TIMEOUT;
+            }
+            pend.cmdStatus = ZnpCommandStatusT::INVALID_PARAM;
+            pend.startMillis = ERaMillis();
+            pend.callback = callback;
+            pend.args = args;
+            pend.used = true;
+            this->numPending++;
+            return true;
+        }
+        return false;
+    }
+
+    /* True when rsp belongs to a request in flight,
+       done.used when that request is finished */
+    bool match(const Response_t& rsp, Pending_t& done) {
+        done.used = false;
+        if (!this->numPending) {
+            return false;
+        }
+        for (size_t i = 0; i < Window; ++i) {
+            Pending_t& pend = this->slots[i];
+            if (!pend.used) {
+                continue;
+            }
+            if (CompareRsp_t(rsp, pend.wait)) {
+                if (CheckAFdata_t(rsp, pend.wait)) {
+                    pend.cmdStatus = rsp.cmdStatus;
+                }
+                this->finish(i, done);
+                return true;
+            }
+            if (!CheckAFdata_t(rsp, pend.wait)) {
+                continue;
+            }
+            pend.cmdStatus = rsp.cmdStatus;
+            /* Never left the coordinator, no answer will come */
+            if (rsp.cmdStatus != ZnpCommandStatusT::SUCCESS_STATUS) {
+                this->finish(i, done);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    bool expire(Pending_t& done) {
+        done.used = false;
+        for (size_t i = 0; i < Window; ++i) {
+            Pending_t& pend = this->slots[i];
+            if (!pend.used) {
+                continue;
+            }
+            if (ERaRemainingTime(pend.startMillis, pend.wait.timeout)) {
+                continue;
+            }
+            this->finish(i, done);
+            return true;
+        }
+        return false;
+    }
+
+    /* Same status as a blocking waitResponse() */
+    static ResultT result(const Pending_t& pend, bool timeout) {
+        if (pend.cmdStatus != ZnpCommandStatusT::INVALID_PARAM) {
+            return static_cast<ResultT>(pend.cmdStatus);
+        }
+        return (timeout ? ResultT::RESULT_TIMEOUT : ResultT::RESULT_SUCCESSFUL);
+    }
+
+protected:
+private:
+    void finish(size_t index, Pending_t& done) {
+        done = this->slots[index];
+        this->slots[index] = Pending_t();
+        this->numPending--;
+    }
+
+    Pending_t slots[Window];
+    size_t numPending;
+};
+
+#endif /* INC_ERA_ZNP_PENDING_HPP_ */